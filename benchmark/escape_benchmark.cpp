@@ -0,0 +1,71 @@
+// Measures the throughput of the N-Quads escaping in RDFDatasetUtils, with and
+// without the SIMD scan, on literal-like text.
+
+// Usage: escape_benchmark [megabytes]
+
+#include "RDFDatasetUtils.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    // sentences of mostly plain ASCII with the occasional quote, newline and
+    // multibyte character, like the descriptions found in real datasets
+    std::vector<std::string> makeLiterals(size_t totalBytes) {
+        const std::vector<std::string> sentences = {
+                "The quick brown fox jumps over the lazy dog. ",
+                "She said \"hello\" and left.\n",
+                "Die K\xC3\xB6nigin und Ihre Majest\xC3\xA4t. ",
+                "A path like C:\\temp\\file is common in descriptions. ",
+                "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor. ",
+        };
+        std::vector<std::string> literals;
+        size_t bytes = 0;
+        size_t i = 0;
+        while (bytes < totalBytes) {
+            std::string literal;
+            for (int j = 0; j < 20; j++)
+                literal += sentences[i++ % sentences.size()];
+            bytes += literal.size();
+            literals.push_back(std::move(literal));
+        }
+        return literals;
+    }
+
+    template<typename Escape>
+    double run(const char * name, const std::vector<std::string> & literals, size_t bytes, Escape escape) {
+        std::string out;
+        auto start = std::chrono::steady_clock::now();
+        for (const auto & literal : literals) {
+            out.clear();
+            escape(literal, out);
+        }
+        std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+        double mbPerSecond = static_cast<double>(bytes) / (1024 * 1024) / seconds.count();
+        std::cout << name << ": " << mbPerSecond << " MB/s" << std::endl;
+        return mbPerSecond;
+    }
+
+}
+
+int main (int argc, char *argv[]) {
+    size_t megabytes = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 256;
+
+    std::vector<std::string> literals = makeLiterals(megabytes * 1024 * 1024);
+    size_t bytes = 0;
+    for (const auto & literal : literals)
+        bytes += literal.size();
+
+    double scalar = run("scalar", literals, bytes, [](const std::string & s, std::string & out) {
+        RDFDatasetUtils::escapeScalar(s, out);
+    });
+    double simd = run("simd  ", literals, bytes, [](const std::string & s, std::string & out) {
+        RDFDatasetUtils::escape(s, out);
+    });
+    std::cout << "speedup: " << simd / scalar << "x" << std::endl;
+
+    return 0;
+}
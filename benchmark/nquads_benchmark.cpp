@@ -0,0 +1,70 @@
+// Measures the throughput of reading and writing N-Quads, on a generated dataset
+// of typed and language-tagged literals, IRIs and blank nodes.
+
+// Usage: nquads_benchmark [megabytes]
+
+#include "NQuadsParser.h"
+#include "NQuadsWriter.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+
+    std::string makeNQuads(size_t totalBytes) {
+        std::string nquads;
+        for (size_t i = 0; nquads.size() < totalBytes; i++) {
+            std::string subject = "<http://example.com/resource/" + std::to_string(i / 8) + ">";
+            std::string graph = i % 3 == 0 ? " <http://example.com/graph/" + std::to_string(i % 7) + ">" : "";
+            switch (i % 4) {
+                case 0:
+                    nquads += subject + " <http://xmlns.com/foaf/0.1/name> \"Name number " + std::to_string(i) +
+                              "\"@en" + graph + " .\n";
+                    break;
+                case 1:
+                    nquads += subject + " <http://example.com/vocab#count> \"" + std::to_string(i) +
+                              "\"^^<http://www.w3.org/2001/XMLSchema#integer>" + graph + " .\n";
+                    break;
+                case 2:
+                    nquads += subject + " <http://xmlns.com/foaf/0.1/knows> _:b" + std::to_string(i % 1000) +
+                              graph + " .\n";
+                    break;
+                default:
+                    nquads += subject + " <http://purl.org/dc/terms/description> \"A \\\"quoted\\\" description\\n"
+                              "spanning two lines, with some more text to make it longer.\"" + graph + " .\n";
+                    break;
+            }
+        }
+        return nquads;
+    }
+
+    double megabytesPerSecond(size_t bytes, std::chrono::steady_clock::time_point start) {
+        std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+        return static_cast<double>(bytes) / (1024 * 1024) / seconds.count();
+    }
+
+}
+
+int main (int argc, char *argv[]) {
+    size_t megabytes = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 256;
+    std::string nquads = makeNQuads(megabytes * 1024 * 1024);
+
+    RDF::RDFDataset dataset(JsonLdOptions(), nullptr);
+    auto start = std::chrono::steady_clock::now();
+    RDF::NQuadsParser parser(dataset);
+    parser.parse(nquads);
+    std::cout << "parse: " << megabytesPerSecond(nquads.size(), start) << " MB/s, "
+              << dataset.getQuadStore().size() << " quads" << std::endl;
+
+    for (auto order : { RDF::NQuadsWriter::Order::Unsorted, RDF::NQuadsWriter::Order::Sorted }) {
+        size_t written = 0;
+        start = std::chrono::steady_clock::now();
+        RDF::NQuadsWriter writer([&written](const char *, size_t size) { written += size; }, order);
+        writer.write(dataset);
+        std::cout << (order == RDF::NQuadsWriter::Order::Sorted ? "write sorted: " : "write unsorted: ")
+                  << megabytesPerSecond(written, start) << " MB/s" << std::endl;
+    }
+
+    return 0;
+}
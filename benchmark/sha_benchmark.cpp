@@ -0,0 +1,68 @@
+// Measures the throughput of the SHA-1 and SHA-256 implementations that this
+// processor supports, on one long message and on many short ones like the
+// lines canonicalization hashes.
+
+// Usage: sha_benchmark [megabytes]
+
+#include "sha1.h"
+#include "sha256.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    // N-Quads-sized messages of 60 to 140 bytes
+    std::vector<std::string> makeMessages(size_t totalBytes) {
+        std::vector<std::string> messages;
+        size_t bytes = 0;
+        for (size_t i = 0; bytes < totalBytes; i++) {
+            std::string message(60 + (i * 37) % 80, static_cast<char>('a' + i % 26));
+            bytes += message.size();
+            messages.push_back(std::move(message));
+        }
+        return messages;
+    }
+
+    template<typename Digest>
+    void run(const char * name, Digest && md, const std::string & longMessage,
+             const std::vector<std::string> & messages, size_t bytes) {
+        auto start = std::chrono::steady_clock::now();
+        md.update(longMessage);
+        md.digest();
+        std::chrono::duration<double> longSeconds = std::chrono::steady_clock::now() - start;
+
+        std::vector<std::string> digests(messages.size());
+        start = std::chrono::steady_clock::now();
+        md.digestEach(messages.data(), messages.size(), digests.data());
+        std::chrono::duration<double> shortSeconds = std::chrono::steady_clock::now() - start;
+
+        std::cout << name << ": "
+                  << static_cast<double>(longMessage.size()) / (1024 * 1024) / longSeconds.count() << " MB/s long, "
+                  << static_cast<double>(bytes) / (1024 * 1024) / shortSeconds.count() << " MB/s short" << std::endl;
+    }
+
+}
+
+int main (int argc, char *argv[]) {
+    size_t megabytes = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 64;
+
+    std::string longMessage(megabytes * 1024 * 1024, 'x');
+    std::vector<std::string> messages = makeMessages(megabytes * 1024 * 1024);
+    size_t bytes = 0;
+    for (const auto & message : messages)
+        bytes += message.size();
+
+    run("sha1   portable       ", SHA1(SHA1::Implementation::Portable), longMessage, messages, bytes);
+    if (SHA1::isAvailable(SHA1::Implementation::ShaExtensions))
+        run("sha1   sha extensions ", SHA1(SHA1::Implementation::ShaExtensions), longMessage, messages, bytes);
+    run("sha256 portable       ", SHA256(SHA256::Implementation::Portable), longMessage, messages, bytes);
+    if (SHA256::isAvailable(SHA256::Implementation::ShaExtensions))
+        run("sha256 sha extensions ", SHA256(SHA256::Implementation::ShaExtensions), longMessage, messages, bytes);
+    if (SHA256::isAvailable(SHA256::Implementation::Avx2MultiBuffer))
+        run("sha256 avx2 x8        ", SHA256(SHA256::Implementation::Avx2MultiBuffer), longMessage, messages, bytes);
+
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include "Arena.h"
+
+namespace {
+
+    thread_local Arena * currentArena = nullptr;
+
+    size_t alignUp(size_t n) {
+        const size_t alignment = alignof(std::max_align_t);
+        return (n + alignment - 1) & ~(alignment - 1);
+    }
+
+}
+
+constexpr size_t Arena::DEFAULT_BLOCK_SIZE;
+
+Arena::Arena(size_t iblockSize)
+        : blockSize(iblockSize) {
+}
+
+Arena::~Arena() {
+    for (char * block : blocks)
+        ::operator delete(block);
+}
+
+void * Arena::allocate(size_t n) {
+    n = alignUp(n);
+    bytesAllocated += n;
+    if (n > remaining) {
+        // allocations larger than a block get a block of their own, so the
+        // rest of the current block is not wasted
+        size_t size = n > blockSize ? n : blockSize;
+        char * block = static_cast<char *>(::operator new(size));
+        blocks.push_back(block);
+        if (size == n)
+            return block;
+        next = block;
+        remaining = size;
+    }
+    void * p = next;
+    next += n;
+    remaining -= n;
+    return p;
+}
+
+Arena * Arena::current() {
+    return currentArena;
+}
+
+ArenaScope::ArenaScope(Arena * arena)
+        : previous(currentArena) {
+    currentArena = arena;
+}
+
+ArenaScope::~ArenaScope() {
+    currentArena = previous;
+}
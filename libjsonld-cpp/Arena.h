@@ -0,0 +1,123 @@
+#ifndef LIBJSONLD_CPP_ARENA_H
+#define LIBJSONLD_CPP_ARENA_H
+
+#include "jsoninc.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+
+/**
+ * A bump allocator. Memory is carved out of large blocks and is only given back, all
+ * at once, when the Arena is destroyed.
+ */
+class Arena {
+private:
+    std::vector<char *> blocks;
+    char * next = nullptr;
+    size_t remaining = 0;
+    size_t blockSize;
+    size_t bytesAllocated = 0;
+
+public:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+    explicit Arena(size_t iblockSize = DEFAULT_BLOCK_SIZE);
+    ~Arena();
+
+    Arena(const Arena &) = delete;
+    Arena & operator=(const Arena &) = delete;
+
+    /**
+     * Returns n bytes aligned for any fundamental type.
+     */
+    void * allocate(size_t n);
+
+    size_t getBytesAllocated() const { return bytesAllocated; }
+
+    /**
+     * Returns the arena installed on this thread by an ArenaScope, or nullptr.
+     */
+    static Arena * current();
+
+    friend class ArenaScope;
+};
+
+/**
+ * Installs an arena as the current arena of this thread for the lifetime of the scope.
+ * Passing nullptr suspends the enclosing arena, so that the memory allocated inside the
+ * scope comes from the heap and may outlive the arena.
+ */
+class ArenaScope {
+private:
+    Arena * previous;
+
+public:
+    explicit ArenaScope(Arena * arena);
+    ~ArenaScope();
+
+    ArenaScope(const ArenaScope &) = delete;
+    ArenaScope & operator=(const ArenaScope &) = delete;
+};
+
+/**
+ * A stateless allocator that allocates from the current arena of the thread, or from
+ * the heap if there is none. Every allocation is prefixed by a header recording where
+ * it came from, so memory is always released the right way, even by a thread that has
+ * no arena or a different one. Memory from an arena is only reclaimed with the arena:
+ * containers using it must be destroyed before their arena is.
+ */
+template<typename T>
+class ArenaAllocator {
+private:
+    static constexpr size_t HEADER_SIZE = alignof(std::max_align_t) > sizeof(Arena *) ?
+                                          alignof(std::max_align_t) : sizeof(Arena *);
+
+public:
+    typedef T value_type;
+
+    ArenaAllocator() = default;
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U> &) {}
+
+    T * allocate(size_t n) {
+        size_t bytes = HEADER_SIZE + n * sizeof(T);
+        Arena * arena = Arena::current();
+        char * p = static_cast<char *>(arena != nullptr ? arena->allocate(bytes) : ::operator new(bytes));
+        *reinterpret_cast<Arena **>(p) = arena;
+        return reinterpret_cast<T *>(p + HEADER_SIZE);
+    }
+
+    void deallocate(T * t, size_t) {
+        char * p = reinterpret_cast<char *>(t) - HEADER_SIZE;
+        if (*reinterpret_cast<Arena **>(p) == nullptr)
+            ::operator delete(p);
+    }
+
+    template<typename U>
+    struct rebind {
+        typedef ArenaAllocator<U> other;
+    };
+};
+
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T> &, const ArenaAllocator<U> &) { return true; }
+
+template<typename T, typename U>
+bool operator!=(const ArenaAllocator<T> &, const ArenaAllocator<U> &) { return false; }
+
+/**
+ * A json type whose objects and arrays are allocated with ArenaAllocator. It converts
+ * to and from nlohmann::json by deep copy.
+ *
+ * Only the containers are in the arena: object keys and string values are plain
+ * std::strings, allocated on the heap unless short enough to be stored inline, so
+ * that they can be used wherever the rest of the library expects a std::string.
+ */
+typedef nlohmann::basic_json<std::map, std::vector, std::string, bool, std::int64_t, std::uint64_t, double,
+        ArenaAllocator> arena_json;
+
+#endif //LIBJSONLD_CPP_ARENA_H
@@ -0,0 +1,74 @@
+#include "BlankNodeIndex.h"
+
+namespace RDF {
+
+    const BlankNodeIndex::NodeId BlankNodeIndex::NOT_FOUND;
+
+    namespace {
+
+        // calls f(term) for each blank node of the quad at position i that is listed
+        // with it
+        template<typename F>
+        void forEachBlankNode(const QuadStore & store, size_t i, BlankNodeIndex::Occurrences occurrences, F f) {
+            const Term * components[3] = {&store.getSubject(i), &store.getObject(i), &store.getGraph(i)};
+            for (int k = 0; k < 3; k++) {
+                const Term & term = *components[k];
+                if (!term.isBlankNode())
+                    continue;
+                bool repeated = false;
+                if (occurrences == BlankNodeIndex::Occurrences::OncePerQuad) {
+                    for (int j = 0; j < k; j++)
+                        repeated = repeated || (components[j]->isBlankNode() && components[j]->value == term.value);
+                }
+                if (!repeated)
+                    f(term);
+            }
+        }
+
+    }
+
+    BlankNodeIndex::BlankNodeIndex(const RDFDataset & dataset, Occurrences occurrences) {
+        const QuadStore & store = dataset.getQuadStore();
+        std::vector<std::pair<size_t, size_t>> ranges;
+        for (const auto & graphName : dataset.graphNames())
+            ranges.push_back(dataset.getGraphRange(graphName));
+
+        // number the blank nodes and count their quads
+        std::vector<size_t> counts;
+        for (const auto & range : ranges) {
+            for (size_t i = range.first; i < range.second; i++) {
+                forEachBlankNode(store, i, occurrences, [&](const Term & term) {
+                    auto inserted = nodes.insert(std::make_pair(term.value, static_cast<NodeId>(labels.size())));
+                    if (inserted.second) {
+                        labels.push_back(term.value);
+                        counts.push_back(0);
+                    }
+                    counts[inserted.first->second]++;
+                });
+            }
+        }
+
+        offsets.resize(labels.size() + 1);
+        offsets[0] = 0;
+        for (size_t n = 0; n < labels.size(); n++)
+            offsets[n + 1] = offsets[n] + counts[n];
+
+        // counts becomes where the next quad of each blank node goes
+        for (size_t n = 0; n < labels.size(); n++)
+            counts[n] = offsets[n];
+        positions.resize(offsets.back());
+        for (const auto & range : ranges) {
+            for (size_t i = range.first; i < range.second; i++) {
+                forEachBlankNode(store, i, occurrences, [&](const Term & term) {
+                    positions[counts[nodes.at(term.value)]++] = static_cast<std::uint32_t>(i);
+                });
+            }
+        }
+    }
+
+    BlankNodeIndex::NodeId BlankNodeIndex::find(TermId label) const {
+        auto it = nodes.find(label);
+        return it == nodes.end() ? NOT_FOUND : it->second;
+    }
+
+}
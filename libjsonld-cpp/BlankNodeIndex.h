@@ -0,0 +1,82 @@
+#ifndef LIBJSONLD_CPP_BLANKNODEINDEX_H
+#define LIBJSONLD_CPP_BLANKNODEINDEX_H
+
+#include "RDFDataset.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace RDF {
+
+    /**
+     * Maps the blank nodes of a dataset to the quads they appear in, without copying
+     * any quad. The blank nodes are numbered 0 to size() - 1 in the order they first
+     * appear in, going through the graphs in name order, and the positions of the quads
+     * of node n in the dataset's QuadStore are kept at [offsets[n], offsets[n + 1]) of a
+     * single array.
+     *
+     * The index refers to the dataset's quad store, so the dataset must outlive it and
+     * must not change while it is in use.
+     */
+    class BlankNodeIndex {
+    public:
+        typedef std::uint32_t NodeId;
+
+        // returned by find() if the term is not a blank node of the dataset
+        static const NodeId NOT_FOUND = UINT32_MAX;
+
+        enum class Occurrences {
+            // a quad is listed once for each blank node in it
+            OncePerQuad,
+            // a quad is listed again for each further time a blank node appears in it,
+            // as the original URGNA2012 implementation does
+            EveryOccurrence
+        };
+
+        /**
+         * The positions of the quads of one blank node, in the order they appear in.
+         */
+        class QuadPositions {
+        private:
+            const std::uint32_t * first;
+            const std::uint32_t * last;
+
+        public:
+            QuadPositions(const std::uint32_t * ifirst, const std::uint32_t * ilast) : first(ifirst), last(ilast) {}
+
+            const std::uint32_t * begin() const { return first; }
+            const std::uint32_t * end() const { return last; }
+            size_t size() const { return static_cast<size_t>(last - first); }
+            std::uint32_t operator[](size_t i) const { return first[i]; }
+        };
+
+    private:
+        // the id of the label of each blank node
+        std::vector<TermId> labels;
+        std::unordered_map<TermId, NodeId> nodes;
+        std::vector<size_t> offsets;
+        std::vector<std::uint32_t> positions;
+
+    public:
+        explicit BlankNodeIndex(const RDFDataset & dataset, Occurrences occurrences = Occurrences::OncePerQuad);
+
+        size_t size() const { return labels.size(); }
+
+        /**
+         * @return the id of the label of a blank node in the dataset's TermDictionary
+         */
+        TermId getLabel(NodeId node) const { return labels[node]; }
+
+        /**
+         * @return the blank node labelled with the given term id, or NOT_FOUND
+         */
+        NodeId find(TermId label) const;
+
+        QuadPositions getQuads(NodeId node) const {
+            return QuadPositions(positions.data() + offsets[node], positions.data() + offsets[node + 1]);
+        }
+    };
+
+}
+
+#endif //LIBJSONLD_CPP_BLANKNODEINDEX_H
@@ -0,0 +1,47 @@
+#include "CanonicalSerializer.h"
+#include "RDFDatasetUtils.h"
+#include <algorithm>
+
+namespace RDF {
+
+    void CanonicalSerializer::Lines::clear() {
+        text.clear();
+        lines.clear();
+    }
+
+    void CanonicalSerializer::Lines::sort() {
+        const std::string & t = text;
+        std::sort(lines.begin(), lines.end(),
+                  [&t](const std::pair<size_t, size_t> & lhs, const std::pair<size_t, size_t> & rhs) {
+            return t.compare(lhs.first, lhs.second - lhs.first, t, rhs.first, rhs.second - rhs.first) < 0;
+        });
+    }
+
+    void CanonicalSerializer::Lines::digest(MessageDigest & md) const {
+        for (const auto & line : lines)
+            md.update(text.data() + line.first, line.second - line.first);
+    }
+
+    void CanonicalSerializer::Lines::appendTo(std::string & out) const {
+        out.reserve(out.size() + text.size());
+        for (const auto & line : lines)
+            out.append(text, line.first, line.second - line.first);
+    }
+
+    CanonicalSerializer::CanonicalSerializer(const RDFDataset & dataset) {
+        const QuadStore & store = dataset.getQuadStore();
+        textOffsets.reserve(store.size() + 1);
+        gapOffsets.reserve(store.size() + 1);
+        textOffsets.push_back(0);
+        gapOffsets.push_back(0);
+        for (size_t i = 0; i < store.size(); i++) {
+            size_t begin = text.size();
+            RDFDatasetUtils::appendNQuadWithGaps(dataset, i, text, [&](const Term & term, bool graphName) {
+                gaps.push_back(Gap{static_cast<std::uint32_t>(text.size() - begin), term.value, graphName});
+            });
+            textOffsets.push_back(text.size());
+            gapOffsets.push_back(gaps.size());
+        }
+    }
+
+}
@@ -0,0 +1,96 @@
+#ifndef LIBJSONLD_CPP_CANONICALSERIALIZER_H
+#define LIBJSONLD_CPP_CANONICALSERIALIZER_H
+
+#include "RDFDataset.h"
+#include "MessageDigest.h"
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace RDF {
+
+    /**
+     * Serializes the quads of a dataset in N-Quads format over and over, with different
+     * blank node labels each time, as canonicalization does. Every quad is serialized
+     * once, up front, with gaps where its blank nodes go. After that, writing a quad
+     * only copies the text between the gaps and the labels that fill them.
+     *
+     * The dataset must outlive the serializer and must not change while it is in use.
+     * A serializer can be shared between threads, but each needs its own Lines.
+     */
+    class CanonicalSerializer {
+    public:
+        /**
+         * Serialized quads, to be sorted and then digested or written out. The space is
+         * kept when cleared, so once it is big enough nothing more is allocated.
+         */
+        class Lines {
+        private:
+            friend class CanonicalSerializer;
+
+            std::string text;
+            // [first, second) in text of each line
+            std::vector<std::pair<size_t, size_t>> lines;
+
+        public:
+            void clear();
+            size_t size() const { return lines.size(); }
+            size_t length() const { return text.size(); }
+
+            /**
+             * Sorts the lines the way std::sort sorts std::strings.
+             */
+            void sort();
+
+            /**
+             * Feeds the lines to md in order, without copying them.
+             */
+            void digest(MessageDigest & md) const;
+
+            void appendTo(std::string & out) const;
+        };
+
+    private:
+        struct Gap {
+            // from the start of the text of the quad
+            std::uint32_t offset;
+            TermId label;
+            bool graphName;
+        };
+
+        // the text of quad i is at [textOffsets[i], textOffsets[i + 1]), and its gaps at
+        // [gapOffsets[i], gapOffsets[i + 1]) in gaps
+        std::string text;
+        std::vector<size_t> textOffsets;
+        std::vector<Gap> gaps;
+        std::vector<size_t> gapOffsets;
+
+    public:
+        explicit CanonicalSerializer(const RDFDataset & dataset);
+
+        /**
+         * Adds the quad at position i of the dataset's QuadStore to lines. Each blank node,
+         * and a blank node graph name, is written as label(id, isGraphName), where id is
+         * the id of its label in the dataset's TermDictionary. label must return something
+         * that can be appended to a std::string.
+         */
+        template<typename Label>
+        void add(size_t i, const Label & label, Lines & lines) const {
+            const char * quad = text.data() + textOffsets[i];
+            size_t begin = lines.text.size();
+            size_t written = 0;
+            for (size_t g = gapOffsets[i]; g < gapOffsets[i + 1]; g++) {
+                const Gap & gap = gaps[g];
+                lines.text.append(quad + written, gap.offset - written);
+                lines.text += label(gap.label, gap.graphName);
+                written = gap.offset;
+            }
+            lines.text.append(quad + written, textOffsets[i + 1] - textOffsets[i] - written);
+            lines.lines.emplace_back(begin, lines.text.size());
+        }
+    };
+
+}
+
+#endif //LIBJSONLD_CPP_CANONICALSERIALIZER_H
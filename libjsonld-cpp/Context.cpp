@@ -1,11 +1,118 @@
 #include "Context.h"
 #include "JsonLdUrl.h"
 #include "ObjUtils.h"
+#include "ContextCache.h"
+#include "ParallelUtils.h"
+#include <algorithm>
+#include <exception>
+#include <functional>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 using nlohmann::json;
 
+namespace {
+
+    // remote contexts listed together are fetched on at most this many threads
+    const size_t MAX_CONCURRENT_FETCHES = 4;
+
+    /**
+     * Dereferences a remote context.
+     *
+     * @return the value of the @context member of the remote document
+     */
+    json loadRemoteContext(const DocumentLoader & documentLoader, const std::string & uri) {
+        RemoteDocument rd = [&]() {
+            try {
+                return documentLoader.loadDocument(uri);
+            } catch (const std::exception & e) {
+                throw JsonLdError(JsonLdError::LoadingRemoteContextFailed, uri + ": " + e.what());
+            }
+        }();
+        const json & remoteContext = rd.getDocument();
+        if (!remoteContext.is_object() || !remoteContext.contains(JsonLdConsts::CONTEXT)) {
+            // If the dereferenced document has no top-level JSON object
+            // with an @context member
+            throw JsonLdError(JsonLdError::InvalidRemoteContext, uri);
+        }
+        return remoteContext.at(JsonLdConsts::CONTEXT);
+    }
+
+}
+
+/**
+ * A memo of expandIri() results. It is split into shards, each with its own lock, so
+ * that threads expanding documents against the same context seldom wait for each other.
+ * Most values expanded more than once are keys and types, which come from a small set,
+ * so the memo stops growing once it holds MAX_ENTRIES values, rather than filling up
+ * with @id values that are only expanded once.
+ */
+class Context::IriMemo {
+private:
+    static const size_t SHARDS = 8;
+    static const size_t MAX_ENTRIES = 4096;
+
+    struct Shard {
+        std::mutex mutex;
+        // one map for each combination of the relative and vocab flags
+        std::unordered_map<std::string, std::string> expanded[4];
+        size_t size = 0;
+    };
+    Shard shards[SHARDS];
+
+    Shard & shardFor(const std::string & value) {
+        return shards[std::hash<std::string>()(value) % SHARDS];
+    }
+
+    static size_t flags(bool relative, bool vocab) {
+        return (relative ? 2 : 0) + (vocab ? 1 : 0);
+    }
+
+public:
+    bool find(const std::string & value, bool relative, bool vocab, std::string & expanded) {
+        Shard & shard = shardFor(value);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const auto & map = shard.expanded[flags(relative, vocab)];
+        auto it = map.find(value);
+        if (it == map.end())
+            return false;
+        expanded = it->second;
+        return true;
+    }
+
+    void insert(const std::string & value, bool relative, bool vocab, const std::string & expanded) {
+        Shard & shard = shardFor(value);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.size < MAX_ENTRIES / SHARDS &&
+            shard.expanded[flags(relative, vocab)].insert(std::make_pair(value, expanded)).second)
+            shard.size++;
+    }
+};
+
+class Context::RemoteContextMap {
+private:
+    std::mutex mutex;
+    // never erased from, so references to the contexts stay valid
+    std::map<std::string, json> contexts;
+
+public:
+    const json * find(const std::string & uri) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = contexts.find(uri);
+        return it != contexts.end() ? &it->second : nullptr;
+    }
+
+    // keeps the context already there if another thread got there first
+    const json & insert(const std::string & uri, json context) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return contexts.insert(std::make_pair(uri, std::move(context))).first->second;
+    }
+};
+
 void Context::checkEmptyKey(const json& map) {
     if(map.count("")) {
         // the term MUST NOT be an empty string ("")
@@ -24,7 +131,15 @@ void Context::checkEmptyKey(const std::map<std::string, std::string>& map) {
 
 void Context::init() {
     contextMap.insert(std::make_pair(JsonLdConsts::BASE, options.getBase()));
-    termDefinitions = ObjUtils::newMap();
+    termDefinitions.clear();
+    dereferencedContexts = std::make_shared<RemoteContextMap>();
+
+    // everything context processing depends on, besides the local contexts
+    json state = contextMap;
+    state["processingMode"] = options.getProcessingMode();
+    state["allowContainerSetOnType"] = options.getAllowContainerSetOnType();
+    identity = JsonLdUtils::deepHash(state, true);
+    iriMemo = std::make_shared<IriMemo>();
 }
 
 /**
@@ -38,7 +153,7 @@ void Context::init() {
  * @throws JsonLdError
  *             If there is an error parsing the contexts.
  */
-Context Context::parse(const json & localContext)  {
+Context Context::parse(const json & localContext) const {
     return parse(localContext, std::vector<std::string>(), false);
 }
 
@@ -55,7 +170,7 @@ Context Context::parse(const json & localContext)  {
  * @throws JsonLdError
  *             If there is an error parsing the contexts.
  */
-Context Context::parse(const json & localContext, const std::vector<std::string> & remoteContexts)  {
+Context Context::parse(const json & localContext, const std::vector<std::string> & remoteContexts) const {
     return parse(localContext, remoteContexts, false);
 }
 
@@ -77,29 +192,91 @@ Context Context::parse(const json & localContext, const std::vector<std::string>
  *             If there is an error parsing the contexts.
  */
  Context Context::parse(const json & localContext, const std::vector<std::string> & remoteContexts,
-                      bool parsingARemoteContext) {
+                      bool parsingARemoteContext) const {
 
 //    if (remoteContexts == null) {
 //        remoteContexts = new ArrayList<String>();
 //    }
+    // the result only depends on this context and localContext, unless remote contexts
+    // are involved, so it can be shared with other documents
+    std::shared_ptr<ContextCache> cache = options.getContextCache();
+    const bool cacheable = cache != nullptr && remoteContexts.empty() && !parsingARemoteContext;
+    uint64_t localContextHash = 0;
+    if (cacheable) {
+        localContextHash = JsonLdUtils::deepHash(localContext, true);
+        std::shared_ptr<const Context> cached = cache->find(identity, localContextHash, localContext);
+        if (cached != nullptr) {
+            // the entry was processed with the options of whoever put it in the cache,
+            // which need only agree with these on what went into the identity
+            Context result = *cached;
+            result.options = options;
+            result.dereferencedContexts = dereferencedContexts;
+            return result;
+        }
+    }
+
     // 1. Initialize result to the result of cloning active context.
     Context result = *this;
     // 2)
 
-    // set up an array for the loop in 3)
-    json myContext = json::array();
+    // set up an array for the loop in 3), pointing into localContext
+    std::vector<const json *> myContext;
     if (!localContext.is_array()) {
-        myContext.push_back(localContext);
+        myContext.push_back(&localContext);
     }
     else {
-        myContext.insert(myContext.end(), localContext.begin(), localContext.end());
+        for (const auto & context : localContext)
+            myContext.push_back(&context);
+    }
+
+    // remote contexts are only loaded, and parsed as json, once per expansion; processing
+    // them still depends on the context they apply to. When there are several to load,
+    // they are fetched in parallel, on a few threads, before processing starts. They are resolved
+    // against the base of this context, so that stops at the first context that may
+    // change it, as 3.1) and 3.4) do
+    std::shared_ptr<RemoteContextMap> remoteContextMemo = dereferencedContexts;
+    if (remoteContextMemo == nullptr)
+        remoteContextMemo = std::make_shared<RemoteContextMap>();
+    std::vector<std::string> urisToFetch;
+    for (const json * contextPtr : myContext) {
+        if (contextPtr->is_null() ||
+            (!parsingARemoteContext && contextPtr->is_object() && contextPtr->contains(JsonLdConsts::BASE)))
+            break;
+        if (!contextPtr->is_string())
+            continue;
+        std::string uri = resolveContextUri(contextPtr->get<std::string>());
+        if (remoteContextMemo->find(uri) == nullptr &&
+            std::find(urisToFetch.begin(), urisToFetch.end(), uri) == urisToFetch.end())
+            urisToFetch.push_back(uri);
+    }
+    // a failed fetch only fails the parse once processing gets to its URL
+    std::map<std::string, std::exception_ptr> failedFetches;
+    if (urisToFetch.size() > 1) {
+        std::vector<json> fetched(urisToFetch.size());
+        std::vector<std::exception_ptr> errors(urisToFetch.size());
+        auto threads = static_cast<unsigned int>(std::min<size_t>(urisToFetch.size(), MAX_CONCURRENT_FETCHES));
+        ParallelUtils::parallelFor(urisToFetch.size(), threads, [&](size_t i, unsigned int) {
+            try {
+                fetched[i] = loadRemoteContext(options.getDocumentLoader(), urisToFetch[i]);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+        for (size_t i = 0; i < urisToFetch.size(); i++) {
+            if (errors[i])
+                failedFetches[urisToFetch[i]] = errors[i];
+            else
+                remoteContextMemo->insert(urisToFetch[i], std::move(fetched[i]));
+        }
     }
 
     // 3)
-    for (auto context : myContext) {
+    for (const json * contextPtr : myContext) {
+        const json & context = *contextPtr;
         // 3.1)
         if (context.is_null()) {
             Context c(options);
+            c.dereferencedContexts = remoteContextMemo;
             result = c;
             continue;
         }
@@ -108,31 +285,28 @@ Context Context::parse(const json & localContext, const std::vector<std::string>
 //        }
         // 3.2)
         else if (context.is_string()) {
-            throw JsonLdError(JsonLdError::NotImplemented, "context.is_string() not implemented: ");
-//            std::string uri = result->get(JsonLdConsts::BASE);
-//            uri = JsonLdUrl.resolve(uri, (String) context);
-//            // 3.2.2
-//            if (remoteContexts.contains(uri)) {
-//                throw new JsonLdError(Error.RECURSIVE_CONTEXT_INCLUSION, uri);
-//            }
-//            remoteContexts.add(uri);
-//
-//            // 3.2.3: Dereference context
-//            final RemoteDocument rd = this.options.getDocumentLoader().loadDocument(uri);
-//            final Object remoteContext = rd.getDocument();
-//            if (!(remoteContext instanceof Map) || !((Map<String, Object>) remoteContext)
-//                    .containsKey(JsonLdConsts.CONTEXT)) {
-//                // If the dereferenced document has no top-level JSON object
-//                // with an @context member
-//                throw new JsonLdError(Error.INVALID_REMOTE_CONTEXT, context);
-//            }
-//            final Object tempContext = ((Map<String, Object>) remoteContext)
-//                    .get(JsonLdConsts.CONTEXT);
-//
-//            // 3.2.4
-//            result = result.parse(tempContext, remoteContexts, true);
-//            // 3.2.5
-//            continue;
+            // 3.2.1)
+            std::string uri = result.resolveContextUri(context.get<std::string>());
+            // 3.2.2)
+            if (std::find(remoteContexts.begin(), remoteContexts.end(), uri) != remoteContexts.end()) {
+                throw JsonLdError(JsonLdError::RecursiveContextInclusion, uri);
+            }
+            std::vector<std::string> nextRemoteContexts(remoteContexts);
+            nextRemoteContexts.push_back(uri);
+
+            // 3.2.3) dereference context
+            const json * remoteContext = remoteContextMemo->find(uri);
+            if (remoteContext == nullptr) {
+                auto failed = failedFetches.find(uri);
+                if (failed != failedFetches.end())
+                    std::rethrow_exception(failed->second);
+                remoteContext = &remoteContextMemo->insert(uri, loadRemoteContext(options.getDocumentLoader(), uri));
+            }
+
+            // 3.2.4)
+            result = result.parse(*remoteContext, nextRemoteContexts, true);
+            // 3.2.5)
+            continue;
         } else if (!(context.is_object())) {
             // 3.3
             throw JsonLdError(JsonLdError::InvalidLocalContext, context);
@@ -141,7 +315,7 @@ Context Context::parse(const json & localContext, const std::vector<std::string>
         // 3.4
         if (!parsingARemoteContext && context.contains(JsonLdConsts::BASE)) {
             // 3.4.1
-            auto value = context.at(JsonLdConsts::BASE);
+            const auto & value = context.at(JsonLdConsts::BASE);
             // 3.4.2
             if (value.is_null()) {
                 result.erase(JsonLdConsts::BASE);
@@ -166,7 +340,7 @@ Context Context::parse(const json & localContext, const std::vector<std::string>
 
         // 3.5
         if (context.contains(JsonLdConsts::VOCAB)) {
-            auto value = context.at(JsonLdConsts::VOCAB);
+            const auto & value = context.at(JsonLdConsts::VOCAB);
             if (value.is_null()) {
                 result.erase(JsonLdConsts::VOCAB);
             } else if (value.is_string()) {
@@ -184,7 +358,7 @@ Context Context::parse(const json & localContext, const std::vector<std::string>
 
         // 3.6
         if (context.contains(JsonLdConsts::LANGUAGE)) {
-            auto value = context.at(JsonLdConsts::LANGUAGE);
+            const auto & value = context.at(JsonLdConsts::LANGUAGE);
             if (value.is_null()) {
                 result.erase(JsonLdConsts::LANGUAGE);
             } else if (value.is_string()) {
@@ -205,34 +379,46 @@ Context Context::parse(const json & localContext, const std::vector<std::string>
         }
     }
 
+    // the memo of anything expanded against the contexts result was built from does
+    // not apply to it
+    result.iriMemo = std::make_shared<IriMemo>();
+
+    if (cacheable) {
+        result.identity = ContextCache::combine(identity, localContextHash);
+        // cached contexts must not own the cache, nor share state with this expansion
+        Context entry = result;
+        entry.options.setContextCache(nullptr);
+        entry.dereferencedContexts = nullptr;
+        cache->insert(identity, localContextHash, localContext, entry);
+    }
+
     return result;
 }
 
-std::string Context::getContainer(std::string property) {
+TermDefinition::Container Context::getContainer(const std::string & property) const {
 //        if (property == null) {
 //            return null;
 //        }
-    if (property == JsonLdConsts::GRAPH) {
-        return JsonLdConsts::SET;
-    }
-    if (property != JsonLdConsts::TYPE && JsonLdUtils::isKeyword(property)) {
-        return property;
-    }
-    if(!termDefinitions.contains(property))
-        return "";
-    auto td = termDefinitions[property];
-//        if (td == null) {
-//            return null;
-//        }
-    if(td.empty())
-        return "";
-    auto c = td[JsonLdConsts::CONTAINER];
-    if(!c.is_string()) {
-        return "";
-    }
-    else {
-        return c.get<std::string>();
+    switch (JsonLdUtils::getKeyword(property)) {
+        case JsonLdConsts::Keyword::NotAKeyword:
+        case JsonLdConsts::Keyword::Type:
+            break;
+        case JsonLdConsts::Keyword::Graph:
+        case JsonLdConsts::Keyword::Set:
+            return TermDefinition::Container::Set;
+        case JsonLdConsts::Keyword::List:
+            return TermDefinition::Container::List;
+        case JsonLdConsts::Keyword::Index:
+            return TermDefinition::Container::Index;
+        case JsonLdConsts::Keyword::Language:
+            return TermDefinition::Container::Language;
+        default:
+            return TermDefinition::Container::None;
     }
+    const TermDefinition * td = getTermDefinition(property);
+    if (td == nullptr)
+        return TermDefinition::Container::None;
+    return td->container;
 }
 
 /**
@@ -264,15 +450,52 @@ std::string Context::expandIri(
             defined.find(value) != defined.end() && !defined.at(value) ) {
             createTermDefinition(context, value, defined);
         }
+        // 4.3) done up front, unless 3) is going to return first, so that the
+        // rest of the algorithm does not modify the context
+        if (!context.is_null() && !(vocab && termDefinitions.find(value) != termDefinitions.end())) {
+            auto colIndex = value.find(':');
+            if (colIndex != std::string::npos) {
+                std::string prefix(value, 0, colIndex);
+                if (prefix != "_" && value.compare(colIndex + 1, 1, "/") != 0 && context.contains(prefix)
+                    && (defined.find(prefix) == defined.end() || !defined.at(prefix))) {
+                    createTermDefinition(context, prefix, defined);
+                }
+            }
+        }
+        return resolveIri(value, relative, vocab, !context.is_null());
+}
+
+std::string Context::expandIri(
+        std::string value, bool relative, bool vocab) const {
+    // 1)
+    if (JsonLdUtils::isKeyword(value)) { // todo: also checked for if value was null
+        return value;
+    }
+    if (iriMemo == nullptr)
+        return resolveIri(value, relative, vocab, false);
+    std::string expanded;
+    if (!iriMemo->find(value, relative, vocab, expanded)) {
+        expanded = resolveIri(value, relative, vocab, false);
+        iriMemo->insert(value, relative, vocab, expanded);
+    }
+    return expanded;
+}
+
+/**
+ * Steps 3) to 7) of the IRI Expansion Algorithm, once all the term definitions it
+ * needs have been created.
+ *
+ * @param checkRelative throw if the result is a relative IRI (only done while a local
+ *        context is being processed)
+ */
+std::string Context::resolveIri(const std::string & value, bool relative, bool vocab,
+                                bool checkRelative) const {
         // 3)
-        if (vocab && termDefinitions.find(value) != termDefinitions.end()) {
-            auto td = termDefinitions.at(value);
-            if (!td.is_null()) {
-                if(td.contains(JsonLdConsts::ID))
-                    return td.at(JsonLdConsts::ID);
-                else
-                    return "";
-            } else {
+        if (vocab) {
+            const TermDefinition * td = getTermDefinition(value);
+            if (td != nullptr) {
+                if (!td->null && td->hasId)
+                    return td->id;
                 return ""; // todo: was null
             }
         }
@@ -281,50 +504,40 @@ std::string Context::expandIri(
         if (colIndex != std::string::npos) {
             // 4.1)
             std::string prefix(value, 0, colIndex);
-            std::string suffix(value, colIndex+1);
             // 4.2)
-            if (prefix == "_" || suffix.find('/') == 0) {
+            if (prefix == "_" || value.compare(colIndex + 1, 1, "/") == 0) {
                 return value;
             }
-            // 4.3)
-            if (!context.is_null() && context.contains(prefix)
-                && (defined.find(prefix) == defined.end() || !defined.at(prefix))) {
-                createTermDefinition(context, prefix, defined);
-            }
-            // 4.4)
-            if (termDefinitions.find(prefix) != termDefinitions.end()) {
-                auto id = termDefinitions.at(prefix).at(JsonLdConsts::ID);
-                id = id.get<std::string>() + suffix;
-                return id;
+            // 4.4) a prefix mapped to null is not a prefix
+            const TermDefinition * td = getTermDefinition(prefix);
+            if (td != nullptr && !td->null && td->hasId) {
+                return td->id + value.substr(colIndex + 1);
             }
             // 4.5)
             return value;
         }
         // 5)
-        if (vocab && contextMap.find(JsonLdConsts::VOCAB) != contextMap.end()) {
-            return contextMap.at(JsonLdConsts::VOCAB) + value;
+        auto vocabMapping = contextMap.find(JsonLdConsts::VOCAB);
+        if (vocab && vocabMapping != contextMap.end()) {
+            return vocabMapping->second + value;
         }
         // 6)
         else if (relative) {
-            if(this->count(JsonLdConsts::BASE))
-                return JsonLdUrl::resolve(&(this->at(JsonLdConsts::BASE)), &value);
+            std::string pathToResolve = value;
+            auto base = contextMap.find(JsonLdConsts::BASE);
+            if (base != contextMap.end()) {
+                std::string baseUri = base->second;
+                return JsonLdUrl::resolve(&baseUri, &pathToResolve);
+            }
             else
-                return JsonLdUrl::resolve(nullptr, &value);
-        } else if (!context.is_null() && JsonLdUtils::isRelativeIri(value)) {
+                return JsonLdUrl::resolve(nullptr, &pathToResolve);
+        } else if (checkRelative && JsonLdUtils::isRelativeIri(value)) {
             throw JsonLdError(JsonLdError::InvalidIriMapping, "not an absolute IRI: " + value);
         }
         // 7)
         return value;
 }
 
-std::string Context::expandIri(
-        std::string value, bool relative, bool vocab) {
-    // dummy objects
-    json j;
-    std::map<std::string, bool> m;
-    return expandIri(std::move(value), relative, vocab, j, m);
-}
-
 /**
  * Create Term Definition Algorithm
  *
@@ -336,9 +549,11 @@ std::string Context::expandIri(
  * @param defined map of defined values
  * @throws JsonLdError
  */
-void Context::createTermDefinition(json context, const std::string& term,
+void Context::createTermDefinition(const json & context, const std::string& term,
                                    std::map<std::string, bool> & defined)
 {
+    iriMemo = nullptr;
+
     // 1) has term been defined already?
     if (defined.find(term) != defined.end()) {
         if (defined.at(term)) {
@@ -364,9 +579,7 @@ void Context::createTermDefinition(json context, const std::string& term,
     }
 
     // 7) remove any previous definition
-    if(termDefinitions.count(term) ) {
-        termDefinitions.erase(term);
-    }
+    termDefinitions.erase(term);
 
     // 3) get value associated with term
     auto value = context.at(term);
@@ -375,7 +588,7 @@ void Context::createTermDefinition(json context, const std::string& term,
 
     if (value == nullptr ||
         (value.contains(JsonLdConsts::ID) && value.at(JsonLdConsts::ID) == nullptr)) {
-        termDefinitions[term] = nullptr;
+        termDefinitions[term].null = true;
         defined[term] = true;
         return;
     }
@@ -391,7 +604,7 @@ void Context::createTermDefinition(json context, const std::string& term,
     }
 
     // 11) create a new term definition
-    auto definition = ObjUtils::newMap();
+    TermDefinition definition;
 
     // 12) ???
 
@@ -418,10 +631,13 @@ void Context::createTermDefinition(json context, const std::string& term,
 
         // TODO: fix check for absoluteIri (blank nodes shouldn't count, at least not here!)
         // 13.3)
-        if (typeStr == JsonLdConsts::ID || typeStr == JsonLdConsts::VOCAB
-            || (typeStr.find(JsonLdConsts::BLANK_NODE_PREFIX) != 0
-                && JsonLdUtils::isAbsoluteIri(typeStr))) {
-            definition[JsonLdConsts::TYPE] = typeStr;
+        if (typeStr == JsonLdConsts::ID) {
+            definition.typeMapping = TermDefinition::TypeMapping::Id;
+        } else if (typeStr == JsonLdConsts::VOCAB) {
+            definition.typeMapping = TermDefinition::TypeMapping::Vocab;
+        } else if (typeStr.find(JsonLdConsts::BLANK_NODE_PREFIX) != 0 && JsonLdUtils::isAbsoluteIri(typeStr)) {
+            definition.typeMapping = TermDefinition::TypeMapping::Iri;
+            definition.type = typeStr;
         } else {
             throw JsonLdError(JsonLdError::InvalidTypeMapping, type);
         }
@@ -445,24 +661,26 @@ void Context::createTermDefinition(json context, const std::string& term,
                 throw JsonLdError(JsonLdError::InvalidIriMapping,
                                       "Non-absolute @reverse IRI: " + reverseStr);
             }
-            definition[JsonLdConsts::ID] = reverseStr;
+            definition.hasId = true;
+            definition.id = reverseStr;
             if (value.contains(JsonLdConsts::CONTAINER)) {
                 std::string container = value.at(JsonLdConsts::CONTAINER);
-                if (container == JsonLdConsts::SET || container == JsonLdConsts::INDEX) { // todo was container == null
-                    definition[JsonLdConsts::CONTAINER] = container;
+                if (container == JsonLdConsts::SET) { // todo was container == null
+                    definition.container = TermDefinition::Container::Set;
+                } else if (container == JsonLdConsts::INDEX) {
+                    definition.container = TermDefinition::Container::Index;
                 } else {
                     throw JsonLdError(JsonLdError::InvalidReverseProperty,
                                           "reverse properties only support set- and index-containers");
                 }
             }
-            definition[JsonLdConsts::REVERSE] = true;
-            termDefinitions[term] = definition;
+            definition.reverse = true;
+            termDefinitions[term] = std::move(definition);
             defined[term] = true;
             return;
         }
 
-        // 12)
-        definition[JsonLdConsts::REVERSE] = false;
+        // 12) definition.reverse is already false
 
         // 13)
         if (value.contains(JsonLdConsts::ID) && term != value.at(JsonLdConsts::ID)) {
@@ -478,7 +696,8 @@ void Context::createTermDefinition(json context, const std::string& term,
                 if (idStr == JsonLdConsts::CONTEXT) {
                     throw JsonLdError(JsonLdError::InvalidKeywordAlias, "cannot alias @context");
                 }
-                definition[JsonLdConsts::ID] = idStr;
+                definition.hasId = true;
+                definition.id = idStr;
             } else {
                 throw JsonLdError(JsonLdError::InvalidIriMapping,
                                   "resulting IRI mapping should be a keyword, absolute IRI or blank node");
@@ -493,16 +712,17 @@ void Context::createTermDefinition(json context, const std::string& term,
             if (context.contains(prefix)) {
                 createTermDefinition(context, prefix, defined);
             }
-            if (termDefinitions.find(prefix) != termDefinitions.end()) {
-                auto id = termDefinitions.at(prefix).at(JsonLdConsts::ID);
-                id = id.get<std::string>() + suffix;
-                definition[JsonLdConsts::ID] = id;
+            definition.hasId = true;
+            const TermDefinition * prefixDefinition = getTermDefinition(prefix);
+            if (prefixDefinition != nullptr && !prefixDefinition->null && prefixDefinition->hasId) {
+                definition.id = prefixDefinition->id + suffix;
             } else {
-                definition[JsonLdConsts::ID] = term;
+                definition.id = term;
             }
             // 15)
         } else if (contextMap.find(JsonLdConsts::VOCAB) != contextMap.end()) {
-            definition[JsonLdConsts::ID] = contextMap.at(JsonLdConsts::VOCAB) + term;
+            definition.hasId = true;
+            definition.id = contextMap.at(JsonLdConsts::VOCAB) + term;
         } else if (term != JsonLdConsts::TYPE) {
             throw JsonLdError(JsonLdError::InvalidIriMapping,
                                   "relative term definition without vocab mapping");
@@ -511,16 +731,21 @@ void Context::createTermDefinition(json context, const std::string& term,
         // 16)
         if (value.contains(JsonLdConsts::CONTAINER)) {
             std::string container = value.at(JsonLdConsts::CONTAINER);
-            if(container != JsonLdConsts::LIST &&
-               container != JsonLdConsts::SET &&
-               container != JsonLdConsts::INDEX &&
-               container != JsonLdConsts::LANGUAGE) {
+            if (container == JsonLdConsts::LIST) {
+                definition.container = TermDefinition::Container::List;
+            } else if (container == JsonLdConsts::SET) {
+                definition.container = TermDefinition::Container::Set;
+            } else if (container == JsonLdConsts::INDEX) {
+                definition.container = TermDefinition::Container::Index;
+            } else if (container == JsonLdConsts::LANGUAGE) {
+                definition.container = TermDefinition::Container::Language;
+            } else {
                 throw JsonLdError(JsonLdError::InvalidContainerMapping,
                                   "@container must be either @list, @set, @index, or @language");
             }
-            definition[JsonLdConsts::CONTAINER] = container;
             if (term == JsonLdConsts::TYPE) {
-                definition[JsonLdConsts::ID] = "type";
+                definition.hasId = true;
+                definition.id = "type";
             }
         }
 
@@ -528,7 +753,10 @@ void Context::createTermDefinition(json context, const std::string& term,
         if (value.contains(JsonLdConsts::LANGUAGE) && !value.contains(JsonLdConsts::TYPE)) {
             auto language = value.at(JsonLdConsts::LANGUAGE);
             if (language.is_null() || language.is_string()) {
-                definition[JsonLdConsts::LANGUAGE] = language; // todo: tolowercase or null?
+                definition.hasLanguage = true; // todo: tolowercase or null?
+                definition.nullLanguage = language.is_null();
+                if (language.is_string())
+                    definition.language = language.get<std::string>();
             } else {
                 throw JsonLdError(JsonLdError::InvalidLanguageMapping,
                                       "@language must be a string or null");
@@ -536,22 +764,28 @@ void Context::createTermDefinition(json context, const std::string& term,
         }
 
         // 18)
-        termDefinitions[term] = definition;
+        termDefinitions[term] = std::move(definition);
         defined[term] = true;
 
 }
 
+// the mutators drop the memo of expanded IRIs, since the context they change may not
+// expand IRIs the same way anymore
+
 std::string & Context::at(const std::string &s) {
+    iriMemo = nullptr;
     return contextMap.at(s);
 }
 
 size_t Context::erase(const std::string &key) {
+    iriMemo = nullptr;
     return contextMap.erase(key);
 }
 
 std::pair<Context::StringMap::iterator,bool> Context::insert( const StringMap::value_type& value ) {
     // unlike a normal c++ map, which does not insert a value if the key is already present,
     // we DO want to replace, so we have to erase first
+    iriMemo = nullptr;
     if(contextMap.find(value.first) != contextMap.end()) {
         contextMap.erase(value.first);
     }
@@ -562,37 +796,45 @@ size_t Context::count(const std::string &key) const {
     return contextMap.count(key);
 }
 
-bool Context::isReverseProperty(const std::string &property) {
-    if(!termDefinitions.count(property)) {
-        return false;
-    }
-    auto td = termDefinitions.at(property);
-    if (td.is_null()) {
-        return false;
-    }
-    return td.contains(JsonLdConsts::REVERSE) && td.at(JsonLdConsts::REVERSE);
+std::string Context::resolveContextUri(const std::string & context) const {
+    std::string pathToResolve = context;
+    auto base = contextMap.find(JsonLdConsts::BASE);
+    if (base == contextMap.end())
+        return JsonLdUrl::resolve(nullptr, &pathToResolve);
+    std::string baseUri = base->second;
+    return JsonLdUrl::resolve(&baseUri, &pathToResolve);
 }
 
-nlohmann::json Context::getTermDefinition(const std::string & key) {
-    if(termDefinitions.count(key)) {
-        return termDefinitions.at(key);
-    }
-    else
-        return json::object();
+uint64_t Context::getIdentity() const {
+    return identity;
+}
+
+bool Context::isReverseProperty(const std::string &property) const {
+    const TermDefinition * td = getTermDefinition(property);
+    return td != nullptr && !td->null && td->reverse;
+}
+
+const TermDefinition * Context::getTermDefinition(const std::string & term) const {
+    auto td = termDefinitions.find(term);
+    if (td == termDefinitions.end())
+        return nullptr;
+    return &td->second;
 }
 
 
-json Context::expandValue(const std::string & activeProperty, const json& value)  {
+json Context::expandValue(const std::string & activeProperty, const json& value) const {
     auto rval = ObjUtils::newMap();
-    json td = getTermDefinition(activeProperty);
+    const TermDefinition * td = getTermDefinition(activeProperty);
+    if (td != nullptr && td->null)
+        td = nullptr;
     // 1)
-    if (!td.is_null() && td.contains(JsonLdConsts::TYPE) && td.at(JsonLdConsts::TYPE) == JsonLdConsts::ID) {
+    if (td != nullptr && td->typeMapping == TermDefinition::TypeMapping::Id) {
         // TODO: i'm pretty sure value should be a string if the @type is @id
         rval[JsonLdConsts::ID] = expandIri(value.get<std::string>(), true, false);
         return rval;
     }
     // 2)
-    if (!td.is_null() && td.contains(JsonLdConsts::TYPE) && td.at(JsonLdConsts::TYPE) == JsonLdConsts::VOCAB) {
+    if (td != nullptr && td->typeMapping == TermDefinition::TypeMapping::Vocab) {
         // TODO: same as above
         rval[JsonLdConsts::ID] = expandIri(value.get<std::string>(), true, true);
         return rval;
@@ -600,16 +842,15 @@ json Context::expandValue(const std::string & activeProperty, const json& value)
     // 3)
     rval[JsonLdConsts::VALUE] = value;
     // 4)
-    if (!td.is_null() && td.contains(JsonLdConsts::TYPE)) {
-        rval[JsonLdConsts::TYPE] = td.at(JsonLdConsts::TYPE);
+    if (td != nullptr && td->typeMapping != TermDefinition::TypeMapping::None) {
+        rval[JsonLdConsts::TYPE] = td->type;
     }
         // 5)
     else if (value.is_string()) {
         // 5.1)
-        if (!td.is_null() && td.contains(JsonLdConsts::LANGUAGE)) {
-            json lang = td.at(JsonLdConsts::LANGUAGE);
-            if (!lang.is_null()) {
-                rval[JsonLdConsts::LANGUAGE] = lang.get<std::string>();
+        if (td != nullptr && td->hasLanguage) {
+            if (!td->nullLanguage) {
+                rval[JsonLdConsts::LANGUAGE] = td->language;
             }
         }
             // 5.2)
@@ -6,8 +6,11 @@
 #include "JsonLdUtils.h"
 #include "JsonLdOptions.h"
 #include "JsonLdError.h"
+#include "TermDefinition.h"
 #include <utility>
 #include <memory>
+#include <cstdint>
+#include <unordered_map>
 
 class Context {
 public:
@@ -16,14 +19,28 @@ public:
 private:
 
     JsonLdOptions options;
-    nlohmann::json termDefinitions;
+    std::unordered_map<std::string, TermDefinition> termDefinitions;
     nlohmann::json inverse;
     StringMap contextMap;
+    uint64_t identity = 0;
+
+    class RemoteContextMap;
+    // the remote contexts dereferenced so far, by URL, shared by all the contexts
+    // derived from the same initial context, which may be parsed on different threads
+    std::shared_ptr<RemoteContextMap> dereferencedContexts;
+
+    class IriMemo;
+    // the results of expandIri(value, relative, vocab), shared by all the copies of this
+    // context, which may be on different threads. Changing the context drops it, and
+    // parse() gives the context it returns a new one, so it only ever holds results for
+    // one state of the context
+    std::shared_ptr<IriMemo> iriMemo;
 
     static void checkEmptyKey(const nlohmann::json& map);
     static void checkEmptyKey(const StringMap& map);
-    void createTermDefinition(nlohmann::json context, const std::string& term, std::map<std::string, bool> & defined);
-    nlohmann::json getTermDefinition(const std::string & key);
+    void createTermDefinition(const nlohmann::json & context, const std::string& term, std::map<std::string, bool> & defined);
+    std::string resolveIri(const std::string & value, bool relative, bool vocab, bool checkRelative) const;
+    std::string resolveContextUri(const std::string & context) const;
 
     void init();
 
@@ -35,23 +52,39 @@ public:
     explicit Context(std::map<std::string, std::string> map);
 
 // todo: should these be static constructors?
-    Context parse(const nlohmann::json & localContext, const std::vector<std::string> & remoteContexts, bool parsingARemoteContext);
-    Context parse(const nlohmann::json & localContext, const std::vector<std::string> & remoteContexts);
-    Context parse(const nlohmann::json & localContext);
+    Context parse(const nlohmann::json & localContext, const std::vector<std::string> & remoteContexts, bool parsingARemoteContext) const;
+    Context parse(const nlohmann::json & localContext, const std::vector<std::string> & remoteContexts) const;
+    Context parse(const nlohmann::json & localContext) const;
+
+    /**
+     * @return the definition of a term, or nullptr if the term is not defined
+     */
+    const TermDefinition * getTermDefinition(const std::string & term) const;
 
     /**
      * Retrieve container mapping.
      *
      * @param property
      *            The Property to get a container mapping for.
-     * @return The container mapping if any, else null
+     * @return The container mapping if any, else Container::None. The @list, @set,
+     *         @index and @language keywords are their own container, and @graph is a set
      */
-    std::string getContainer(std::string property);
+    TermDefinition::Container getContainer(const std::string & property) const;
 
-    std::string expandIri(std::string value, bool relative, bool vocab);
+    /**
+     * IRI Expansion Algorithm, for a context that is done being processed. Results are
+     * memoized, so expanding the same value again is a lookup.
+     */
+    std::string expandIri(std::string value, bool relative, bool vocab) const;
     std::string expandIri(std::string value, bool relative, bool vocab, const nlohmann::json& context, std::map<std::string, bool> & defined);
-    nlohmann::json expandValue(const std::string & activeProperty, const nlohmann::json& value);
-    bool isReverseProperty(const std::string& property);
+    nlohmann::json expandValue(const std::string & activeProperty, const nlohmann::json& value) const;
+    bool isReverseProperty(const std::string& property) const;
+
+    /**
+     * Identifies this context for the ContextCache: contexts built from the same
+     * options by processing the same local contexts have the same identity.
+     */
+    uint64_t getIdentity() const;
 
     std::string & at(const std::string& s);
     size_t erase( const std::string& key );
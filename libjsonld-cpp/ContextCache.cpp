@@ -0,0 +1,52 @@
+#include "ContextCache.h"
+#include "Context.h"
+
+using nlohmann::json;
+
+constexpr size_t ContextCache::DEFAULT_MAX_ENTRIES;
+
+ContextCache::ContextCache(size_t imaxEntries)
+        : entries(std::make_shared<EntryMap>()), maxEntries(imaxEntries), hits(0), misses(0) {
+}
+
+std::shared_ptr<const Context> ContextCache::find(uint64_t activeContext, uint64_t localContextHash,
+                                                  const json & localContext) const {
+    std::shared_ptr<const EntryMap> snapshot = std::atomic_load(&entries);
+    auto range = snapshot->equal_range(combine(activeContext, localContextHash));
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second.activeContext == activeContext && it->second.localContext == localContext) {
+            ++hits;
+            return it->second.result;
+        }
+    }
+    ++misses;
+    return nullptr;
+}
+
+void ContextCache::insert(uint64_t activeContext, uint64_t localContextHash,
+                          const json & localContext, const Context & result) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    std::shared_ptr<const EntryMap> snapshot = std::atomic_load(&entries);
+    if (snapshot->size() >= maxEntries)
+        return;
+
+    uint64_t key = combine(activeContext, localContextHash);
+    auto range = snapshot->equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+        // another thread got there first
+        if (it->second.activeContext == activeContext && it->second.localContext == localContext)
+            return;
+    }
+
+    std::shared_ptr<EntryMap> updated = std::make_shared<EntryMap>(*snapshot);
+    updated->emplace(key, Entry{activeContext, localContext, std::make_shared<const Context>(result)});
+    std::atomic_store(&entries, std::shared_ptr<const EntryMap>(std::move(updated)));
+}
+
+size_t ContextCache::size() const {
+    return std::atomic_load(&entries)->size();
+}
+
+uint64_t ContextCache::combine(uint64_t seed, uint64_t value) {
+    return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
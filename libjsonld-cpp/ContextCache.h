@@ -0,0 +1,72 @@
+#ifndef LIBJSONLD_CPP_CONTEXTCACHE_H
+#define LIBJSONLD_CPP_CONTEXTCACHE_H
+
+#include "jsoninc.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+class Context;
+
+/**
+ * A cache of processed contexts, which can be shared by any number of documents and
+ * threads through JsonLdOptions::setContextCache().
+ *
+ * An entry maps an active context and a local context to the Context that results from
+ * processing the local context against the active context. Local contexts are found by
+ * a structural hash and compared in full on lookup, so two local contexts with the same
+ * hash are told apart. Active contexts are only compared by Context::getIdentity(), a
+ * 64-bit hash of the options and local contexts they were built from: two different
+ * active contexts with the same identity would share entries, though the odds of that
+ * are those of a 64-bit hash collision.
+ *
+ * Lookups never block: they read an immutable snapshot of the entries. Insertions copy
+ * the snapshot, so the cache is meant for the small number of distinct contexts a
+ * service typically sees, and stops growing when it holds maxEntries contexts.
+ */
+class ContextCache {
+private:
+    struct Entry {
+        uint64_t activeContext;
+        nlohmann::json localContext;
+        std::shared_ptr<const Context> result;
+    };
+    typedef std::unordered_multimap<uint64_t, Entry> EntryMap;
+
+    std::shared_ptr<const EntryMap> entries;
+    std::mutex writeMutex;
+    size_t maxEntries;
+
+    mutable std::atomic<uint64_t> hits;
+    mutable std::atomic<uint64_t> misses;
+
+public:
+    static constexpr size_t DEFAULT_MAX_ENTRIES = 1024;
+
+    explicit ContextCache(size_t imaxEntries = DEFAULT_MAX_ENTRIES);
+
+    ContextCache(const ContextCache &) = delete;
+    ContextCache & operator=(const ContextCache &) = delete;
+
+    /**
+     * Returns the result of processing localContext against the active context with
+     * the given identity, or nullptr if it is not cached.
+     *
+     * @param localContextHash JsonLdUtils::deepHash(localContext, true)
+     */
+    std::shared_ptr<const Context> find(uint64_t activeContext, uint64_t localContextHash,
+                                        const nlohmann::json & localContext) const;
+
+    void insert(uint64_t activeContext, uint64_t localContextHash,
+                const nlohmann::json & localContext, const Context & result);
+
+    size_t size() const;
+    uint64_t getHits() const { return hits; }
+    uint64_t getMisses() const { return misses; }
+
+    static uint64_t combine(uint64_t seed, uint64_t value);
+};
+
+#endif //LIBJSONLD_CPP_CONTEXTCACHE_H
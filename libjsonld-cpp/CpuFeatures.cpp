@@ -0,0 +1,57 @@
+#include "CpuFeatures.h"
+
+#ifdef LIBJSONLD_CPP_X86_DISPATCH
+#include <cpuid.h>
+#endif
+
+namespace {
+
+#ifdef LIBJSONLD_CPP_X86_DISPATCH
+    struct Features {
+        bool sha = false;
+        bool avx2 = false;
+
+        Features() {
+            unsigned int eax, ebx, ecx, edx;
+            if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+                return;
+            bool ssse3 = (ecx & (1u << 9u)) != 0;
+            bool sse41 = (ecx & (1u << 19u)) != 0;
+            bool osxsave = (ecx & (1u << 27u)) != 0;
+            bool avx = (ecx & (1u << 28u)) != 0;
+
+            // the operating system has to save the YMM registers for AVX to be usable
+            bool ymm = false;
+            if (osxsave && avx) {
+                unsigned int xcr0, xcr0High;
+                __asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0High) : "c"(0));
+                ymm = (xcr0 & 0x6u) == 0x6u;
+            }
+
+            if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+                return;
+            sha = ssse3 && sse41 && (ebx & (1u << 29u)) != 0;
+            avx2 = ymm && (ebx & (1u << 5u)) != 0;
+        }
+    };
+#else
+    struct Features {
+        bool sha = false;
+        bool avx2 = false;
+    };
+#endif
+
+    const Features & features() {
+        static const Features instance;
+        return instance;
+    }
+
+}
+
+bool CpuFeatures::hasShaExtensions() {
+    return features().sha;
+}
+
+bool CpuFeatures::hasAvx2() {
+    return features().avx2;
+}
@@ -0,0 +1,28 @@
+#ifndef LIBJSONLD_CPP_CPUFEATURES_H
+#define LIBJSONLD_CPP_CPUFEATURES_H
+
+/**
+ * Instruction set extensions that are checked for at runtime rather than build time,
+ * because the usual x86-64 build targets do not include them. Code using them is
+ * compiled with a target attribute, so it is only available with GCC or Clang on x86.
+ */
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define LIBJSONLD_CPP_X86_DISPATCH 1
+#endif
+
+namespace CpuFeatures {
+
+    /**
+     * @return whether the SHA extensions, and the SSSE3 and SSE4.1 instructions used
+     * with them, are available
+     */
+    bool hasShaExtensions();
+
+    /**
+     * @return whether AVX2 is available and enabled by the operating system
+     */
+    bool hasAvx2();
+
+}
+
+#endif //LIBJSONLD_CPP_CPUFEATURES_H
@@ -0,0 +1,108 @@
+#include "DocumentCache.h"
+
+constexpr size_t DocumentCache::DEFAULT_MAX_ENTRIES;
+constexpr size_t DocumentCache::DEFAULT_MAX_BYTES;
+
+DocumentCache::DocumentCache(size_t imaxEntries, size_t imaxBytes)
+        : maxEntries(imaxEntries), maxBytes(imaxBytes), bytes(0), hits(0), misses(0), evictions(0) {
+}
+
+DocumentCache::DocumentPtr DocumentCache::find(const std::string & url) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto pinnedIt = pinned.find(url);
+    if (pinnedIt != pinned.end()) {
+        hits++;
+        return pinnedIt->second;
+    }
+    auto it = index.find(url);
+    if (it == index.end()) {
+        misses++;
+        return nullptr;
+    }
+    hits++;
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->document;
+}
+
+DocumentCache::DocumentPtr DocumentCache::insert(const std::string & url, DocumentPtr document, size_t ibytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto pinnedIt = pinned.find(url);
+    if (pinnedIt != pinned.end())
+        return pinnedIt->second;
+    auto it = index.find(url);
+    if (it != index.end()) {
+        // another thread got there first
+        entries.splice(entries.begin(), entries, it->second);
+        return it->second->document;
+    }
+    if (ibytes > maxBytes || maxEntries == 0)
+        return document;
+
+    entries.push_front(Entry{url, document, ibytes});
+    index[url] = entries.begin();
+    bytes += ibytes;
+    evict();
+    return document;
+}
+
+void DocumentCache::evict() {
+    while (entries.size() > maxEntries || bytes > maxBytes) {
+        const Entry & last = entries.back();
+        bytes -= last.bytes;
+        index.erase(last.url);
+        entries.pop_back();
+        evictions++;
+    }
+}
+
+void DocumentCache::pin(const std::string & url, DocumentPtr document) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(url);
+    if (it != index.end()) {
+        bytes -= it->second->bytes;
+        entries.erase(it->second);
+        index.erase(it);
+    }
+    pinned[url] = std::move(document);
+}
+
+void DocumentCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    index.clear();
+    pinned.clear();
+    bytes = 0;
+}
+
+size_t DocumentCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size() + pinned.size();
+}
+
+size_t DocumentCache::getBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return bytes;
+}
+
+size_t DocumentCache::getMaxEntries() const {
+    return maxEntries;
+}
+
+size_t DocumentCache::getMaxBytes() const {
+    return maxBytes;
+}
+
+uint64_t DocumentCache::getHits() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+}
+
+uint64_t DocumentCache::getMisses() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+}
+
+uint64_t DocumentCache::getEvictions() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return evictions;
+}
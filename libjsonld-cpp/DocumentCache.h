@@ -0,0 +1,94 @@
+#ifndef LIBJSONLD_CPP_DOCUMENTCACHE_H
+#define LIBJSONLD_CPP_DOCUMENTCACHE_H
+
+#include "jsoninc.h"
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * The cache of parsed documents behind a DocumentLoader. It is shared by every copy of
+ * the loader, so it can be shared by any number of documents and threads.
+ *
+ * Documents are immutable once cached and are handed out as shared pointers, so loading
+ * a cached document never copies it. Documents loaded by the DocumentLoader are
+ * evicted in least recently used order once the cache holds more than maxEntries
+ * documents or maxBytes bytes of source text. Documents added with pin() are never
+ * evicted and do not count towards either bound.
+ */
+class DocumentCache {
+public:
+    typedef std::shared_ptr<const nlohmann::json> DocumentPtr;
+
+private:
+    struct Entry {
+        std::string url;
+        DocumentPtr document;
+        size_t bytes;
+    };
+    typedef std::list<Entry> EntryList;
+
+    // most recently used first
+    EntryList entries;
+    std::unordered_map<std::string, EntryList::iterator> index;
+    std::map<std::string, DocumentPtr> pinned;
+    mutable std::mutex mutex;
+
+    size_t maxEntries;
+    size_t maxBytes;
+    size_t bytes;
+
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+
+    void evict();
+
+public:
+    static constexpr size_t DEFAULT_MAX_ENTRIES = 1024;
+    static constexpr size_t DEFAULT_MAX_BYTES = 64 * 1024 * 1024;
+
+    explicit DocumentCache(size_t imaxEntries = DEFAULT_MAX_ENTRIES, size_t imaxBytes = DEFAULT_MAX_BYTES);
+
+    DocumentCache(const DocumentCache &) = delete;
+    DocumentCache & operator=(const DocumentCache &) = delete;
+
+    /**
+     * Returns the document cached for url, or nullptr if there is none.
+     */
+    DocumentPtr find(const std::string & url);
+
+    /**
+     * Caches a document loaded from url, evicting the least recently used documents if
+     * the cache grows past its bounds. A document larger than maxBytes is not cached.
+     *
+     * @param bytes the size of the source the document was parsed from
+     * @return the cached document, which is the one already cached if another thread
+     * loaded the same url first
+     */
+    DocumentPtr insert(const std::string & url, DocumentPtr document, size_t bytes);
+
+    /**
+     * Caches a document for url that is never evicted.
+     */
+    void pin(const std::string & url, DocumentPtr document);
+
+    /**
+     * Removes all the documents, pinned or not. Statistics are kept.
+     */
+    void clear();
+
+    size_t size() const;
+    size_t getBytes() const;
+    size_t getMaxEntries() const;
+    size_t getMaxBytes() const;
+    uint64_t getHits() const;
+    uint64_t getMisses() const;
+    uint64_t getEvictions() const;
+};
+
+#endif //LIBJSONLD_CPP_DOCUMENTCACHE_H
@@ -20,12 +20,20 @@ namespace {
 }
 
 
-RemoteDocument DocumentLoader::loadDocument(const std::string &url) {
+DocumentLoader::DocumentLoader()
+: cache(std::make_shared<DocumentCache>())
+{}
+
+DocumentLoader::DocumentLoader(std::shared_ptr<DocumentCache> icache)
+: cache(std::move(icache))
+{}
+
+RemoteDocument DocumentLoader::loadDocument(const std::string &url) const {
 
     // first check the cache
-    auto it = cache.find(url);
-    if(it != cache.end())
-        return RemoteDocument(url, it->second);
+    DocumentCache::DocumentPtr document = cache->find(url);
+    if(document)
+        return RemoteDocument(url, document);
 
     // do something to load
     path p(url);
@@ -34,12 +42,12 @@ RemoteDocument DocumentLoader::loadDocument(const std::string &url) {
         std::string fileContents = getFileContents(p);
 
         // create the json object
-        json j = json::parse(fileContents);
+        document = std::make_shared<const json>(json::parse(fileContents));
 
         // add to cache
-        cache[url] = j;
+        document = cache->insert(url, document, fileContents.size());
 
-        return RemoteDocument(url, j);
+        return RemoteDocument(url, document);
     }
     else {
         std::stringstream ss;
@@ -50,6 +58,9 @@ RemoteDocument DocumentLoader::loadDocument(const std::string &url) {
 }
 
 void DocumentLoader::addDocumentToCache(const std::string &url, const std::string &contents) {
-    json j = json::parse(contents);
-    cache.insert(std::make_pair(url, j));
+    cache->pin(url, std::make_shared<const json>(json::parse(contents)));
+}
+
+const std::shared_ptr<DocumentCache> &DocumentLoader::getCache() const {
+    return cache;
 }
@@ -2,20 +2,35 @@
 #define LIBBECH32_DOCUMENTLOADER_H
 
 #include "RemoteDocument.h"
-
+#include "DocumentCache.h"
+
+/**
+ * Loads documents, keeping the parsed documents in a DocumentCache.
+ *
+ * A DocumentLoader is a handle: copies share the same cache, so a loader is cheap to
+ * copy and a warm cache can be shared by all the documents and threads that use it.
+ */
 class DocumentLoader {
 
     using json = nlohmann::json;
 
 private:
-    std::map<std::string, json> cache;
+    std::shared_ptr<DocumentCache> cache;
 
 public:
 
+    DocumentLoader();
+    explicit DocumentLoader(std::shared_ptr<DocumentCache> icache);
+
+    /**
+     * Adds a document that is never evicted from the cache.
+     */
     void addDocumentToCache(const std::string &url, const std::string &contents);
 
     // load url and return a RemoteDocument
-    RemoteDocument loadDocument(const std::string &url);
+    RemoteDocument loadDocument(const std::string &url) const;
+
+    const std::shared_ptr<DocumentCache> &getCache() const;
 };
 
 
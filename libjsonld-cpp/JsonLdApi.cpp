@@ -1,26 +1,391 @@
 #include "JsonLdApi.h"
 #include "ObjUtils.h"
 #include "NormalizeUtils.h"
+#include "URDNA2015.h"
+#include "MessageDigest.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <utility>
 #include <iostream>
 #include <set>
+#include <unordered_map>
 
 using nlohmann::json;
 
+namespace {
+
+    // moves the items of the array from to the end of the array to
+    void moveAppend(json & to, json & from) {
+        for (auto & item : from)
+            to.push_back(std::move(item));
+    }
+
+    arena_json arenaMap(const std::string& key, arena_json value) {
+        arena_json result = arena_json::object();
+        result[key] = std::move(value);
+        return result;
+    }
+
+    const size_t NO_QUAD = SIZE_MAX;
+
+    // a blank node that is the subject of rdf:first or rdf:rest, so may be part of a list
+    struct ListNode {
+        enum class State : uint8_t {
+            Unknown, Visiting, List, NotList
+        };
+        size_t first = NO_QUAD;
+        size_t rest = NO_QUAD;
+        uint32_t usages = 0;
+        bool wellFormed = true;
+        // the node is an item of another list
+        bool nested = false;
+        State state = State::Unknown;
+    };
+
+    /**
+     * Converts the quads of one graph of a dataset to node objects, as in steps 3) and 4)
+     * of the Serialize RDF as JSON-LD algorithm, one subject at a time.
+     *
+     * Instead of building the node map and then walking back from each usage of rdf:nil,
+     * the blank nodes that can be part of a list are indexed first, so that when a node
+     * refers to the head of a well-formed list, the list is built by following rdf:rest
+     * from there and the list nodes are never output.
+     */
+    class GraphSerializer {
+    private:
+        const RDF::QuadStore & quads;
+        const RDF::TermDictionary & dictionary;
+        const JsonLdOptions & options;
+        size_t first;
+        size_t last;
+
+        RDF::TermId rdfType, rdfFirst, rdfRest, rdfNil, rdfList;
+        RDF::TermId xsdString, xsdBoolean, xsdInteger, xsdDouble;
+
+        // keyed by the id of the blank node label
+        std::unordered_map<RDF::TermId, ListNode> listNodes;
+        // the quad positions grouped by subject, only used if the graph is not sorted by subject
+        std::vector<size_t> order;
+
+        bool isPredicate(const RDF::Term & term, RDF::TermId iri) const {
+            return term.isIRI() && term.value == iri;
+        }
+
+        bool isTypeQuad(size_t i) const {
+            return !options.getUseRdfType() && isPredicate(quads.getPredicate(i), rdfType) &&
+                   !quads.getObject(i).isLiteral();
+        }
+
+        size_t at(size_t k) const {
+            return order.empty() ? first + k : order[k];
+        }
+
+        static bool sameSubject(const RDF::Term & lhs, const RDF::Term & rhs) {
+            return lhs.kind == rhs.kind && lhs.value == rhs.value;
+        }
+
+        // compares two subjects the way they sort in N-Quads text: IRIs, which start with
+        // '<' and end with '>', before blank nodes, which end with a space
+        int compareSerialized(const RDF::Term & lhs, const RDF::Term & rhs) const {
+            if (lhs.kind != rhs.kind)
+                return lhs.isIRI() ? -1 : 1;
+            if (lhs.value == rhs.value)
+                return 0;
+            const std::string & l = dictionary.get(lhs.value);
+            const std::string & r = dictionary.get(rhs.value);
+            size_t n = std::min(l.size(), r.size());
+            int c = std::memcmp(l.data(), r.data(), n);
+            if (c != 0)
+                return c;
+            unsigned char end = lhs.isIRI() ? '>' : ' ';
+            unsigned char lc = l.size() > n ? static_cast<unsigned char>(l[n]) : end;
+            unsigned char rc = r.size() > n ? static_cast<unsigned char>(r[n]) : end;
+            return lc - rc;
+        }
+
+        void groupBySubject() {
+            for (size_t i = first + 1; i < last; i++) {
+                const RDF::Term & previous = quads.getSubject(i - 1);
+                const RDF::Term & subject = quads.getSubject(i);
+                if (!sameSubject(previous, subject) && compareSerialized(previous, subject) > 0) {
+                    // each quad goes with the first quad of its subject
+                    std::unordered_map<uint64_t, size_t> firstOfSubject;
+                    std::vector<size_t> group(last - first);
+                    order.resize(last - first);
+                    for (size_t k = 0; k < order.size(); k++) {
+                        const RDF::Term & s = quads.getSubject(first + k);
+                        uint64_t key = static_cast<uint64_t>(s.kind) << 32 | s.value;
+                        group[k] = firstOfSubject.emplace(key, k).first->second;
+                        order[k] = first + k;
+                    }
+                    std::stable_sort(order.begin(), order.end(), [this, &group](size_t a, size_t b) {
+                        return group[a - first] < group[b - first];
+                    });
+                    return;
+                }
+            }
+        }
+
+        void indexLists() {
+            for (size_t i = first; i < last; i++) {
+                const RDF::Term & predicate = quads.getPredicate(i);
+                if (quads.getSubject(i).isBlankNode() &&
+                    (isPredicate(predicate, rdfFirst) || isPredicate(predicate, rdfRest)))
+                    listNodes[quads.getSubject(i).value];
+            }
+            if (listNodes.empty())
+                return;
+
+            for (size_t i = first; i < last; i++) {
+                const RDF::Term & subject = quads.getSubject(i);
+                const RDF::Term & predicate = quads.getPredicate(i);
+                const RDF::Term & object = quads.getObject(i);
+                auto it = subject.isBlankNode() ? listNodes.find(subject.value) : listNodes.end();
+                if (it != listNodes.end()) {
+                    ListNode & node = it->second;
+                    if (isPredicate(predicate, rdfFirst)) {
+                        node.wellFormed = node.wellFormed && node.first == NO_QUAD;
+                        node.first = i;
+                    } else if (isPredicate(predicate, rdfRest)) {
+                        node.wellFormed = node.wellFormed && node.rest == NO_QUAD;
+                        node.rest = i;
+                    } else if (!(isTypeQuad(i) && isPredicate(object, rdfList))) {
+                        // the only other property a list node may have is @type rdf:List
+                        node.wellFormed = false;
+                    }
+                }
+                // 3.5.6) rdf:type objects that become @type values are not usages
+                if (object.isBlankNode() && !isTypeQuad(i)) {
+                    it = listNodes.find(object.value);
+                    if (it != listNodes.end()) {
+                        it->second.usages++;
+                        it->second.nested = isPredicate(predicate, rdfFirst);
+                    }
+                }
+            }
+        }
+
+        // whether term is rdf:nil or the head of a well-formed list that ends in rdf:nil
+        bool isList(const RDF::Term & term) {
+            RDF::Term t = term;
+            std::vector<ListNode *> path;
+            ListNode::State result;
+            while (true) {
+                if (isPredicate(t, rdfNil)) {
+                    result = ListNode::State::List;
+                    break;
+                }
+                auto it = t.isBlankNode() ? listNodes.find(t.value) : listNodes.end();
+                if (it == listNodes.end()) {
+                    result = ListNode::State::NotList;
+                    break;
+                }
+                ListNode & node = it->second;
+                if (node.state == ListNode::State::List || node.state == ListNode::State::NotList) {
+                    result = node.state;
+                    break;
+                }
+                // a cycle, or a node that is not a well-formed list node
+                if (node.state == ListNode::State::Visiting || !node.wellFormed || node.usages != 1 ||
+                    node.first == NO_QUAD || node.rest == NO_QUAD) {
+                    node.state = ListNode::State::NotList;
+                    result = ListNode::State::NotList;
+                    break;
+                }
+                node.state = ListNode::State::Visiting;
+                path.push_back(&node);
+                t = quads.getObject(node.rest);
+            }
+            for (ListNode * node : path)
+                node->state = result;
+            return result == ListNode::State::List;
+        }
+
+        // whether subject is a list node that ends up in the @list of the node referring to it
+        bool isConsumed(const RDF::Term & subject) {
+            if (!subject.isBlankNode())
+                return false;
+            auto it = listNodes.find(subject.value);
+            // a list of lists is not supported, so only the rest of a nested list is converted
+            return it != listNodes.end() && !it->second.nested && isList(subject);
+        }
+
+        nlohmann::json listObject(const RDF::Term & head) {
+            json list = json::array();
+            RDF::Term t = head;
+            while (!isPredicate(t, rdfNil)) {
+                const ListNode & node = listNodes.at(t.value);
+                list.push_back(objectToJson(quads.getObject(node.first)));
+                t = quads.getObject(node.rest);
+            }
+            json result = json::object();
+            result[JsonLdConsts::LIST] = std::move(list);
+            return result;
+        }
+
+        static bool parseInteger(const std::string & value, json & result) {
+            size_t i = (!value.empty() && (value[0] == '+' || value[0] == '-')) ? 1 : 0;
+            if (i == value.size())
+                return false;
+            for (size_t k = i; k < value.size(); k++) {
+                if (value[k] < '0' || value[k] > '9')
+                    return false;
+            }
+            errno = 0;
+            long long n = std::strtoll(value.c_str(), nullptr, 10);
+            if (errno == ERANGE)
+                return false;
+            result = static_cast<int64_t>(n);
+            return true;
+        }
+
+        static bool parseDouble(const std::string & value, json & result) {
+            if (value.empty() || value.find_first_not_of("+-.0123456789eE") != std::string::npos)
+                return false;
+            char * end;
+            double d = std::strtod(value.c_str(), &end);
+            if (end != value.c_str() + value.size() || !std::isfinite(d))
+                return false;
+            result = d;
+            return true;
+        }
+
+        // RDF to Object Conversion
+        nlohmann::json objectToJson(const RDF::Term & object) const {
+            json result = json::object();
+            const std::string & value = dictionary.get(object.value);
+            // 1)
+            if (!object.isLiteral()) {
+                result[JsonLdConsts::ID] = value;
+                return result;
+            }
+            // 2.1)
+            json convertedValue = value;
+            bool isString = object.datatype == RDF::TermDictionary::EMPTY || object.datatype == xsdString;
+            bool typed = !isString;
+            // 2.4)
+            if (object.language != RDF::TermDictionary::EMPTY) {
+                result[JsonLdConsts::LANGUAGE] = dictionary.get(object.language);
+                typed = false;
+            } else if (options.getUseNativeTypes() && !isString) {
+                // 2.4.1)
+                if (object.datatype == xsdBoolean) {
+                    if (value == "true") {
+                        convertedValue = true;
+                        typed = false;
+                    } else if (value == "false") {
+                        convertedValue = false;
+                        typed = false;
+                    }
+                }
+                // 2.4.2)
+                else if (object.datatype == xsdInteger) {
+                    typed = !parseInteger(value, convertedValue);
+                } else if (object.datatype == xsdDouble) {
+                    typed = !parseDouble(value, convertedValue);
+                }
+            }
+            // 2.6)
+            result[JsonLdConsts::VALUE] = std::move(convertedValue);
+            if (typed)
+                result[JsonLdConsts::TYPE] = dictionary.get(object.datatype);
+            return result;
+        }
+
+        nlohmann::json nodeObject(size_t begin, size_t end) {
+            const RDF::Term & subject = quads.getSubject(at(begin));
+            json node = json::object();
+            node[JsonLdConsts::ID] = dictionary.get(subject.value);
+            for (size_t k = begin; k < end; k++) {
+                size_t i = at(k);
+                const RDF::Term & predicate = quads.getPredicate(i);
+                const RDF::Term & object = quads.getObject(i);
+                // 3.5.4)
+                if (isTypeQuad(i)) {
+                    JsonLdUtils::mergeValue(node, JsonLdConsts::TYPE, json(dictionary.get(object.value)));
+                    continue;
+                }
+                // 3.5.5), with the list conversion of step 4) done here
+                if (!object.isLiteral() && !isPredicate(predicate, rdfFirst) && isList(object))
+                    JsonLdUtils::mergeValue(node, dictionary.get(predicate.value), listObject(object));
+                else
+                    JsonLdUtils::mergeValue(node, dictionary.get(predicate.value), objectToJson(object));
+            }
+            return node;
+        }
+
+        RDF::TermId idOf(const char * s) const {
+            return dictionary.find(s);
+        }
+
+    public:
+        GraphSerializer(const RDF::RDFDataset & dataset, std::pair<size_t, size_t> range,
+                        const JsonLdOptions & ioptions)
+                : quads(dataset.getQuadStore()), dictionary(*dataset.getTermDictionary()), options(ioptions),
+                  first(range.first), last(range.second),
+                  rdfType(idOf(JsonLdConsts::RDF_TYPE)), rdfFirst(idOf(JsonLdConsts::RDF_FIRST)),
+                  rdfRest(idOf(JsonLdConsts::RDF_REST)), rdfNil(idOf(JsonLdConsts::RDF_NIL)),
+                  rdfList(idOf(JsonLdConsts::RDF_LIST)), xsdString(idOf(JsonLdConsts::XSD_STRING)),
+                  xsdBoolean(idOf(JsonLdConsts::XSD_BOOLEAN)), xsdInteger(idOf(JsonLdConsts::XSD_INTEGER)),
+                  xsdDouble(idOf(JsonLdConsts::XSD_DOUBLE)) {
+        }
+
+        /**
+         * Calls emit with the node object of each subject of the graph, except for the
+         * blank nodes that were converted to lists.
+         */
+        template<typename Emit>
+        void serialize(Emit emit) {
+            indexLists();
+            groupBySubject();
+            size_t size = last - first;
+            for (size_t begin = 0, end; begin < size; begin = end) {
+                const RDF::Term & subject = quads.getSubject(at(begin));
+                for (end = begin + 1; end < size && sameSubject(quads.getSubject(at(end)), subject); end++) {
+                }
+                if (!isConsumed(subject))
+                    emit(nodeObject(begin, end));
+            }
+        }
+    };
+
+    bool idLess(const json & lhs, const json & rhs) {
+        return lhs.at(JsonLdConsts::ID).get_ref<const std::string &>() <
+               rhs.at(JsonLdConsts::ID).get_ref<const std::string &>();
+    }
+
+    // the node objects of a named graph, sorted by @id
+    json namedGraph(const RDF::RDFDataset & dataset, const std::string & graphName, const JsonLdOptions & options) {
+        std::vector<json> nodes;
+        GraphSerializer(dataset, dataset.getGraphRange(graphName), options).serialize([&nodes](json node) {
+            nodes.push_back(std::move(node));
+        });
+        std::sort(nodes.begin(), nodes.end(), idLess);
+        json result = json::array();
+        for (auto & node : nodes)
+            result.push_back(std::move(node));
+        return result;
+    }
+
+}
+
 JsonLdApi::JsonLdApi(JsonLdOptions ioptions)
         : options(std::move(ioptions)) {
 }
 
-JsonLdOptions JsonLdApi::getOptions() const {
+const JsonLdOptions& JsonLdApi::getOptions() const {
     return options;
 }
 
-json JsonLdApi::expand(Context activeCtx, json element) {
-    return expand(std::move(activeCtx), nullptr, std::move(element));
+json JsonLdApi::expand(const Context & activeCtx, const json & element) {
+    return expand(activeCtx, nullptr, element);
 }
 
-json JsonLdApi::expand(Context activeCtx, std::string * activeProperty, json element) {
+json JsonLdApi::expand(const Context & activeCtx, std::string * activeProperty, const json & element) {
 
     // 1)
     if (element.empty()) {
@@ -41,7 +406,7 @@ json JsonLdApi::expand(Context activeCtx, std::string * activeProperty, json ele
     }
 }
 
-json JsonLdApi::expandArrayElement(Context activeCtx, std::string * activeProperty, const json& element) {
+json JsonLdApi::expandArrayElement(const Context & activeCtx, std::string * activeProperty, const json& element) {
     // 3.1)
     json result = json::array();
     // 3.2)
@@ -51,7 +416,7 @@ json JsonLdApi::expandArrayElement(Context activeCtx, std::string * activeProper
         // 3.2.2)
         if(activeProperty != nullptr) {
             if ((*activeProperty == JsonLdConsts::LIST
-                 || activeCtx.getContainer(*activeProperty) == JsonLdConsts::LIST)
+                 || activeCtx.getContainer(*activeProperty) == TermDefinition::Container::List)
                 && (v.is_array() || (v.is_object() && v.contains(JsonLdConsts::LIST)))) {
                 throw JsonLdError(JsonLdError::ListOfLists, "lists of lists are not permitted.");
             }
@@ -59,9 +424,9 @@ json JsonLdApi::expandArrayElement(Context activeCtx, std::string * activeProper
         // 3.2.3)
         if (!v.is_null()) { // != null
             if (v.is_array()) {
-                result.insert(result.end(), v.begin(), v.end());
+                moveAppend(result, v);
             } else {
-                result.push_back(v);
+                result.push_back(std::move(v));
             }
         }
     }
@@ -69,23 +434,23 @@ json JsonLdApi::expandArrayElement(Context activeCtx, std::string * activeProper
     return result;
 }
 
-json JsonLdApi::expandObjectElement(Context activeCtx, std::string * activeProperty, json element) {
+json JsonLdApi::expandObjectElement(const Context & parentCtx, std::string * activeProperty, const json & element) {
+    using JsonLdConsts::Keyword;
 
-    // access helper
+    // the parent's context is only copied if this element changes it
     // 5)
-    if (element.contains(JsonLdConsts::CONTEXT)) {
-        activeCtx = activeCtx.parse(element[JsonLdConsts::CONTEXT]);
+    Context localCtx;
+    const bool hasLocalContext = element.contains(JsonLdConsts::CONTEXT);
+    if (hasLocalContext) {
+        localCtx = parentCtx.parse(element.at(JsonLdConsts::CONTEXT));
     }
+    const Context & activeCtx = hasLocalContext ? localCtx : parentCtx;
     // 6)
     json result = ObjUtils::newMap();
-    // 7)
-    std::vector<std::string> element_keys;
-    for (json::iterator it = element.begin(); it != element.end(); ++it) {
-        element_keys.push_back(it.key());
-    }
-    std::sort(element_keys.begin(), element_keys.end());
-    for (auto & key : element_keys) {
-        auto element_value = element[key];
+    // 7) json objects keep their keys sorted, so they are visited in order
+    for (json::const_iterator it = element.begin(); it != element.end(); ++it) {
+        std::string key = it.key();
+        const json & element_value = it.value();
         // 7.1)
         if (key == JsonLdConsts::CONTEXT) {
             continue;
@@ -93,15 +458,16 @@ json JsonLdApi::expandObjectElement(Context activeCtx, std::string * activePrope
         // 7.2)
         std::string expandedProperty = activeCtx.expandIri(key, false, true);
         json expandedValue;
+        const Keyword keyword = JsonLdUtils::getKeyword(expandedProperty);
         // 7.3)
         if (
                 // expandedProperty == nullptr ||
                 expandedProperty.empty() ||
-                (expandedProperty.find(':') == std::string::npos && !JsonLdUtils::isKeyword(expandedProperty))) {
+                (expandedProperty.find(':') == std::string::npos && keyword == Keyword::NotAKeyword)) {
             continue;
         }
         // 7.4)
-        if (JsonLdUtils::isKeyword(expandedProperty)) {
+        if (keyword != Keyword::NotAKeyword) {
             // 7.4.1)
             if (activeProperty != nullptr && *activeProperty == JsonLdConsts::REVERSE) {
                 throw JsonLdError(JsonLdError::InvalidReversePropertyMap,
@@ -112,223 +478,231 @@ json JsonLdApi::expandObjectElement(Context activeCtx, std::string * activePrope
                 throw JsonLdError(JsonLdError::CollidingKeywords,
                                       expandedProperty + " already exists in result");
             }
-            // 7.4.3)
-            if (expandedProperty == JsonLdConsts::ID) {
-                if (element_value.is_string()) {
-                    expandedValue = activeCtx.expandIri(element_value.get<std::string>(), true, false);
-                } else if (options.getFrameExpansion()) {
-                    if (element_value.is_object()) {
-                        if (!element_value.empty()) {
-                            throw JsonLdError(JsonLdError::InvalidIdValue,
-                                              "@id value must be a an empty object for framing");
-                        }
-                        expandedValue = element_value;
-                    } else if (element_value.is_array()) {
-                        for ( const auto& v : element_value) {
-                            if (!(v.is_string())) {
+            switch (keyword) {
+                // 7.4.3)
+                case Keyword::Id: {
+                    if (element_value.is_string()) {
+                        expandedValue = activeCtx.expandIri(element_value.get<std::string>(), true, false);
+                    } else if (options.getFrameExpansion()) {
+                        if (element_value.is_object()) {
+                            if (!element_value.empty()) {
                                 throw JsonLdError(JsonLdError::InvalidIdValue,
-                                                  "@id value must be a string, an array of strings or an empty dictionary");
+                                                  "@id value must be a an empty object for framing");
+                            }
+                            expandedValue = element_value;
+                        } else if (element_value.is_array()) {
+                            for ( const auto& v : element_value) {
+                                if (!(v.is_string())) {
+                                    throw JsonLdError(JsonLdError::InvalidIdValue,
+                                                      "@id value must be a string, an array of strings or an empty dictionary");
+                                }
+                                expandedValue.push_back(activeCtx.expandIri(v.get<std::string>(), true, true));
                             }
-                            expandedValue.push_back(activeCtx.expandIri(v.get<std::string>(), true, true));
+                        } else {
+                            throw JsonLdError(JsonLdError::InvalidIdValue,
+                                              "value of @id must be a string, an array of strings or an empty dictionary");
                         }
                     } else {
                         throw JsonLdError(JsonLdError::InvalidIdValue,
-                                          "value of @id must be a string, an array of strings or an empty dictionary");
+                                          "value of @id must be a string");
                     }
-                } else {
-                    throw JsonLdError(JsonLdError::InvalidIdValue,
-                                      "value of @id must be a string");
+                    break;
                 }
-            }
                 // 7.4.4)
-            else if (expandedProperty == JsonLdConsts::TYPE) {
-                if (element_value.is_array()) {
-                    for ( const auto& v : element_value) {
-                        if (!(v.is_string())) {
-                            throw JsonLdError(JsonLdError::InvalidTypeValue,
-                                              "@type value must be a string or array of strings");
+                case Keyword::Type: {
+                    if (element_value.is_array()) {
+                        for ( const auto& v : element_value) {
+                            if (!(v.is_string())) {
+                                throw JsonLdError(JsonLdError::InvalidTypeValue,
+                                                  "@type value must be a string or array of strings");
+                            }
+                            expandedValue.push_back(
+                                    activeCtx.expandIri(v.get<std::string>(), true, true));
                         }
-                        expandedValue.push_back(
-                                activeCtx.expandIri(v.get<std::string>(), true, true));
+                    } else if (element_value.is_string()) {
+                        expandedValue = activeCtx.expandIri(element_value.get<std::string>(), true, true);
                     }
-                } else if (element_value.is_string()) {
-                    expandedValue = activeCtx.expandIri(element_value.get<std::string>(), true, true);
-                }
-                // TODO: SPEC: no mention of empty map check
-                else if (options.getFrameExpansion() && element_value.is_object()) {
-                    if (!element_value.empty()) {
+                    // TODO: SPEC: no mention of empty map check
+                    else if (options.getFrameExpansion() && element_value.is_object()) {
+                        if (!element_value.empty()) {
+                            throw JsonLdError(JsonLdError::InvalidTypeValue,
+                                              "@type value must be a an empty object for framing");
+                        }
+                        expandedValue = element_value;
+                    } else {
                         throw JsonLdError(JsonLdError::InvalidTypeValue,
-                                          "@type value must be a an empty object for framing");
+                                              "@type value must be a string or array of strings");
                     }
-                    expandedValue = element_value;
-                } else {
-                    throw JsonLdError(JsonLdError::InvalidTypeValue,
-                                          "@type value must be a string or array of strings");
+                    break;
                 }
-            }
                 // 7.4.5)
-            else if (expandedProperty == JsonLdConsts::GRAPH) {
-                std::string currentProperty = JsonLdConsts::GRAPH;
-                expandedValue = expand(activeCtx, &currentProperty, element_value);
-            }
-                // 7.4.6)
-            else if (expandedProperty == JsonLdConsts::VALUE) {
-                if (!element_value.is_null() && (element_value.is_object() || element_value.is_array())) {
-                    throw JsonLdError(JsonLdError::InvalidValueObjectValue,
-                                          "value of " + expandedProperty + " must be a scalar or null");
+                case Keyword::Graph: {
+                    std::string currentProperty = JsonLdConsts::GRAPH;
+                    expandedValue = expand(activeCtx, &currentProperty, element_value);
+                    break;
                 }
-                expandedValue = element_value;
-                if (expandedValue.is_null()) {
-                    result[JsonLdConsts::VALUE] = expandedValue; // was null
-                    continue;
+                // 7.4.6)
+                case Keyword::Value: {
+                    if (!element_value.is_null() && (element_value.is_object() || element_value.is_array())) {
+                        throw JsonLdError(JsonLdError::InvalidValueObjectValue,
+                                              "value of " + expandedProperty + " must be a scalar or null");
+                    }
+                    expandedValue = element_value;
+                    if (expandedValue.is_null()) {
+                        result[JsonLdConsts::VALUE] = expandedValue; // was null
+                        continue;
+                    }
+                    break;
                 }
-            }
                 // 7.4.7)
-            else if (expandedProperty == JsonLdConsts::LANGUAGE) {
-                if (!(element_value.is_string())) {
-                    throw JsonLdError(JsonLdError::InvalidLanguageTaggedString,
-                                          "Value of " + expandedProperty + " must be a string");
+                case Keyword::Language: {
+                    if (!(element_value.is_string())) {
+                        throw JsonLdError(JsonLdError::InvalidLanguageTaggedString,
+                                              "Value of " + expandedProperty + " must be a string");
+                    }
+                    std::string v = element_value.get<std::string>();
+                    std::transform(v.begin(), v.end(), v.begin(), &::tolower);
+                    expandedValue = v;
+                    break;
                 }
-                std::string v = element_value.get<std::string>();
-                std::transform(v.begin(), v.end(), v.begin(), &::tolower);
-                expandedValue = v;
-            }
                 // 7.4.8)
-            else if (expandedProperty == JsonLdConsts::INDEX) {
-                if (!(element_value.is_string())) {
-                    throw JsonLdError(JsonLdError::InvalidIndexValue,
-                                          "Value of " + expandedProperty + " must be a string");
+                case Keyword::Index: {
+                    if (!(element_value.is_string())) {
+                        throw JsonLdError(JsonLdError::InvalidIndexValue,
+                                              "Value of " + expandedProperty + " must be a string");
+                    }
+                    expandedValue = element_value;
+                    break;
                 }
-                expandedValue = element_value;
-            }
                 // 7.4.9)
-            else if (expandedProperty == JsonLdConsts::LIST) {
-                // 7.4.9.1)
-                if (activeProperty == nullptr || *activeProperty == JsonLdConsts::GRAPH) {
-                    continue;
-                }
-                // 7.4.9.2)
-                expandedValue = expand(activeCtx, activeProperty, element_value);
-
-                // NOTE: step not in the spec yet
-                if (!(expandedValue.is_array())) {
-                    json j;
-                    j.push_back(expandedValue);
-                    expandedValue = j;
-                }
+                case Keyword::List: {
+                    // 7.4.9.1)
+                    if (activeProperty == nullptr || *activeProperty == JsonLdConsts::GRAPH) {
+                        continue;
+                    }
+                    // 7.4.9.2)
+                    expandedValue = expand(activeCtx, activeProperty, element_value);
+
+                    // NOTE: step not in the spec yet
+                    if (!(expandedValue.is_array())) {
+                        json j;
+                        j.push_back(std::move(expandedValue));
+                        expandedValue = std::move(j);
+                    }
 
-                // 7.4.9.3)
-                for ( const auto& v : expandedValue) {
-                    if (v.is_object() && v.contains(JsonLdConsts::LIST)) {
-                        throw JsonLdError(JsonLdError::ListOfLists,
-                                              "A list may not contain another list");
+                    // 7.4.9.3)
+                    for ( const auto& v : expandedValue) {
+                        if (v.is_object() && v.contains(JsonLdConsts::LIST)) {
+                            throw JsonLdError(JsonLdError::ListOfLists,
+                                                  "A list may not contain another list");
+                        }
                     }
+                    break;
                 }
-            }
                 // 7.4.10)
-            else if (expandedProperty == JsonLdConsts::SET) {
-                expandedValue = expand(activeCtx, activeProperty, element_value);
-            }
-                // 7.4.11)
-            else if (expandedProperty == JsonLdConsts::REVERSE) {
-                if (!(element_value.is_object())) {
-                    throw JsonLdError(JsonLdError::InvalidReverseValue,
-                                          "@reverse value must be an object");
+                case Keyword::Set: {
+                    expandedValue = expand(activeCtx, activeProperty, element_value);
+                    break;
                 }
-                // 7.4.11.1)
-                {
-                    std::string currentProperty = JsonLdConsts::REVERSE;
-                    expandedValue = expand(activeCtx, &currentProperty, element_value);
-                }
-                // NOTE: algorithm assumes the result is a map
-                // 7.4.11.2)
-                if (expandedValue.contains(JsonLdConsts::REVERSE)) {
-                    auto reverse = expandedValue[JsonLdConsts::REVERSE];
-                    std::vector<std::string> reverse_keys;
-                    for (json::iterator it = reverse.begin(); it != reverse.end(); ++it) {
-                        reverse_keys.push_back(it.key());
-                    }
-                    for (const auto &property : reverse_keys) {
-                        auto item = reverse[property];
-                        // 7.4.11.2.1)
-                        if (!result.contains(property)) {
-                            result[property] = json::array();
-                        }
-                        // 7.4.11.2.2)
-                        if (item.is_array()) {
-                            result[property].insert(result[property].end(), item.begin(), item.end());
-                        } else {
-                            result[property] += item;
-                        }
+                // 7.4.11)
+                case Keyword::Reverse: {
+                    if (!(element_value.is_object())) {
+                        throw JsonLdError(JsonLdError::InvalidReverseValue,
+                                              "@reverse value must be an object");
                     }
-                }
-                // 7.4.11.3)
-                if (expandedValue.size() > (expandedValue.contains(JsonLdConsts::REVERSE) ? 1 : 0)) {
-                    // 7.4.11.3.1)
-                    if (!result.contains(JsonLdConsts::REVERSE)) {
-                        result[JsonLdConsts::REVERSE] = json::object();
+                    // 7.4.11.1)
+                    {
+                        std::string currentProperty = JsonLdConsts::REVERSE;
+                        expandedValue = expand(activeCtx, &currentProperty, element_value);
                     }
-                    // 7.4.11.3.2)
-                    auto & reverseMap = result[JsonLdConsts::REVERSE];
-                    // 7.4.11.3.3)
-                    std::vector<std::string> expandedValue_keys;
-                    for (json::iterator it = expandedValue.begin(); it != expandedValue.end(); ++it) {
-                        expandedValue_keys.push_back(it.key());
+                    // NOTE: algorithm assumes the result is a map
+                    // 7.4.11.2)
+                    if (expandedValue.contains(JsonLdConsts::REVERSE)) {
+                        auto & reverse = expandedValue[JsonLdConsts::REVERSE];
+                        for (json::iterator rit = reverse.begin(); rit != reverse.end(); ++rit) {
+                            const std::string & property = rit.key();
+                            auto & item = rit.value();
+                            // 7.4.11.2.1)
+                            if (!result.contains(property)) {
+                                result[property] = json::array();
+                            }
+                            // 7.4.11.2.2)
+                            if (item.is_array()) {
+                                moveAppend(result[property], item);
+                            } else {
+                                result[property] += std::move(item);
+                            }
+                        }
                     }
-                    for ( const auto& property : expandedValue_keys) {
-                        if (property == JsonLdConsts::REVERSE) {
-                            continue;
+                    // 7.4.11.3)
+                    if (expandedValue.size() > (expandedValue.contains(JsonLdConsts::REVERSE) ? 1 : 0)) {
+                        // 7.4.11.3.1)
+                        if (!result.contains(JsonLdConsts::REVERSE)) {
+                            result[JsonLdConsts::REVERSE] = json::object();
                         }
-                        // 7.4.11.3.3.1)
-                        auto items = expandedValue[property];
-                        for ( const auto& item : items) {
-                            // 7.4.11.3.3.1.1)
-                            if (item.is_object() && (item.contains(JsonLdConsts::VALUE)
-                                || item.contains(JsonLdConsts::LIST))) {
-                                throw JsonLdError(JsonLdError::InvalidReversePropertyValue);
+                        // 7.4.11.3.2)
+                        auto & reverseMap = result[JsonLdConsts::REVERSE];
+                        // 7.4.11.3.3)
+                        for (json::iterator eit = expandedValue.begin(); eit != expandedValue.end(); ++eit) {
+                            const std::string & property = eit.key();
+                            if (property == JsonLdConsts::REVERSE) {
+                                continue;
                             }
-                            // 7.4.11.3.3.1.2)
-                            if (!reverseMap.contains(property)) {
-                                reverseMap[property] = json::array();
+                            // 7.4.11.3.3.1)
+                            auto & items = eit.value();
+                            for ( auto& item : items) {
+                                // 7.4.11.3.3.1.1)
+                                if (item.is_object() && (item.contains(JsonLdConsts::VALUE)
+                                    || item.contains(JsonLdConsts::LIST))) {
+                                    throw JsonLdError(JsonLdError::InvalidReversePropertyValue);
+                                }
+                                // 7.4.11.3.3.1.2)
+                                if (!reverseMap.contains(property)) {
+                                    reverseMap[property] = json::array();
+                                }
+                                // 7.4.11.3.3.1.3)
+                                reverseMap[property] += std::move(item);
                             }
-                            // 7.4.11.3.3.1.3)
-                            reverseMap[property] += item;
                         }
                     }
+                    // 7.4.11.4)
+                    continue;
                 }
-                // 7.4.11.4)
-                continue;
-            }
                 // TODO: SPEC no mention of @explicit etc in spec
-            else if (options.getFrameExpansion() && (expandedProperty == JsonLdConsts::EXPLICIT
-                                        || expandedProperty == JsonLdConsts::DEFAULT
-                                        || expandedProperty == JsonLdConsts::EMBED
-                                        || expandedProperty == JsonLdConsts::REQUIRE_ALL
-                                        || expandedProperty == JsonLdConsts::EMBED_CHILDREN
-                                        || expandedProperty == JsonLdConsts::OMIT_DEFAULT)) {
-                expandedValue = expand(activeCtx, &expandedProperty, element_value);
+                case Keyword::Explicit:
+                case Keyword::Default:
+                case Keyword::Embed:
+                case Keyword::RequireAll:
+                case Keyword::OmitDefault:
+                    if (options.getFrameExpansion()) {
+                        expandedValue = expand(activeCtx, &expandedProperty, element_value);
+                    }
+                    break;
+                default:
+                    break;
             }
             // 7.4.12)
             if (!expandedValue.is_null()) {
-                result[expandedProperty] = expandedValue;
+                result[expandedProperty] = std::move(expandedValue);
             }
             // 7.4.13)
             continue;
         }
-            // 7.5
-        else if (activeCtx.getContainer(key) == JsonLdConsts::LANGUAGE && element_value.is_object()) {
+        const TermDefinition::Container container = activeCtx.getContainer(key);
+        // 7.5
+        if (container == TermDefinition::Container::Language && element_value.is_object()) {
             // 7.5.1)
             // 7.5.2)
             for(auto& el : element_value.items()) {
                 std::string language = el.key();
-                json languageValue = el.value();
+                std::transform(language.begin(), language.end(), language.begin(), &::tolower);
 
                 // 7.5.2.1)
-                if (!(languageValue.is_array())) {
-                    json j;
-                    j.push_back(languageValue);
-                    languageValue = j;
+                json wrappedValue;
+                if (!(el.value().is_array())) {
+                    wrappedValue.push_back(el.value());
                 }
+                const json & languageValue = el.value().is_array() ? el.value() : wrappedValue;
                 // 7.5.2.2)
                 for ( const auto& item : languageValue) {
                     // 7.5.2.2.1)
@@ -340,40 +714,32 @@ json JsonLdApi::expandObjectElement(Context activeCtx, std::string * activePrope
                     // 7.5.2.2.2)
                     json tmp = ObjUtils::newMap();
                     tmp[JsonLdConsts::VALUE] = item;
-                    std::transform(language.begin(), language.end(), language.begin(), &::tolower);
                     tmp[JsonLdConsts::LANGUAGE] = language;
-                    expandedValue.push_back(tmp);
+                    expandedValue.push_back(std::move(tmp));
                 }
             }
         }
         // 7.6)
-        else if (activeCtx.getContainer(key) == JsonLdConsts::INDEX
-                 && element_value.is_object()) {
+        else if (container == TermDefinition::Container::Index && element_value.is_object()) {
             // 7.6.1)
             // 7.6.2)
-            std::vector<std::string> indexKeys;
             for(auto& el : element_value.items()) {
-                indexKeys.push_back(el.key());
-            }
-            std::sort(indexKeys.begin(), indexKeys.end());
-            for ( const auto& index : indexKeys) {
-                json indexValue = element_value[index];
+                const std::string & index = el.key();
                 // 7.6.2.1)
-                if (!(indexValue.is_array())) {
-                    json j;
-                    j.push_back(indexValue);
-                    indexValue = j;
+                json wrappedValue;
+                if (!(el.value().is_array())) {
+                    wrappedValue.push_back(el.value());
                 }
                 // 7.6.2.2)
-                indexValue = expand(activeCtx, &key, indexValue);
+                json indexValue = expand(activeCtx, &key, el.value().is_array() ? el.value() : wrappedValue);
                 // 7.6.2.3)
-                for ( auto item : indexValue) {
+                for ( auto & item : indexValue) {
                     // 7.6.2.3.1)
                     if (!item.contains(JsonLdConsts::INDEX)) {
                         item[JsonLdConsts::INDEX] = index;
                     }
                     // 7.6.2.3.2)
-                    expandedValue.push_back(item);
+                    expandedValue.push_back(std::move(item));
                 }
             }
         }
@@ -386,16 +752,16 @@ json JsonLdApi::expandObjectElement(Context activeCtx, std::string * activePrope
             continue;
         }
         // 7.9)
-        if (activeCtx.getContainer(key) == JsonLdConsts::LIST) {
+        if (container == TermDefinition::Container::List) {
             if (!expandedValue.is_object() || !expandedValue.contains(JsonLdConsts::LIST)) {
-                json tmp = expandedValue;
-                if (!tmp.is_array()) {
-                    json j;
-                    j.push_back(expandedValue);
-                    tmp = j;
+                json tmp;
+                if (!expandedValue.is_array()) {
+                    tmp.push_back(std::move(expandedValue));
+                } else {
+                    tmp = std::move(expandedValue);
                 }
                 expandedValue = ObjUtils::newMap();
-                expandedValue[JsonLdConsts::LIST] = tmp;
+                expandedValue[JsonLdConsts::LIST] = std::move(tmp);
             }
         }
         // 7.10)
@@ -409,11 +775,11 @@ json JsonLdApi::expandObjectElement(Context activeCtx, std::string * activePrope
             // 7.10.3)
             if (!(expandedValue.is_array())) {
                 json j;
-                j.push_back(expandedValue);
-                expandedValue = j;
+                j.push_back(std::move(expandedValue));
+                expandedValue = std::move(j);
             }
             // 7.10.4)
-            for ( auto item : expandedValue) {
+            for ( auto & item : expandedValue) {
                 // 7.10.4.1)
                 if (item.is_object() && (item.contains(JsonLdConsts::VALUE) || item.contains(JsonLdConsts::LIST))) {
                     throw JsonLdError(JsonLdError::InvalidReversePropertyValue);
@@ -424,9 +790,9 @@ json JsonLdApi::expandObjectElement(Context activeCtx, std::string * activePrope
                 }
                 // 7.10.4.3)
                 if (item.is_array()) {
-                    reverseMap[expandedProperty].insert(reverseMap[expandedProperty].end(), item.begin(), item.end());
+                    moveAppend(reverseMap[expandedProperty], item);
                 } else {
-                    reverseMap[expandedProperty] += item;
+                    reverseMap[expandedProperty] += std::move(item);
                 }
             }
         }
@@ -438,9 +804,9 @@ json JsonLdApi::expandObjectElement(Context activeCtx, std::string * activePrope
             }
             // 7.11.2)
             if (expandedValue.is_array()) {
-                result[expandedProperty].insert(result[expandedProperty].end(), expandedValue.begin(), expandedValue.end());
+                moveAppend(result[expandedProperty], expandedValue);
             } else {
-                result[expandedProperty].push_back(expandedValue);
+                result[expandedProperty].push_back(std::move(expandedValue));
             }
         }
     }
@@ -461,11 +827,11 @@ json JsonLdApi::expandObjectElement(Context activeCtx, std::string * activePrope
                                   "value object has unknown keys");
         }
         // 8.2)
-        json rval = result[JsonLdConsts::VALUE];
+        const json & rval = result[JsonLdConsts::VALUE];
         if (rval.is_null()) {
             // nothing else is possible with result if we set it to
             // null, so simply return it
-            return rval;
+            return json();
         }
         // 8.3)
         if (!rval.is_string() && result.contains(JsonLdConsts::LANGUAGE)) {
@@ -475,7 +841,7 @@ json JsonLdApi::expandObjectElement(Context activeCtx, std::string * activePrope
         // 8.4)
         else if (result.contains(JsonLdConsts::TYPE)) {
             // TODO: is this enough for "is an IRI"
-            json j = result[JsonLdConsts::TYPE];
+            const json & j = result[JsonLdConsts::TYPE];
             if (!j.is_string()) {
                 throw JsonLdError(JsonLdError::InvalidTypedValue,
                                   "value of @type must be an IRI");
@@ -489,11 +855,11 @@ json JsonLdApi::expandObjectElement(Context activeCtx, std::string * activePrope
     }
         // 9)
     else if (result.contains(JsonLdConsts::TYPE)) {
-         json rtype = result[JsonLdConsts::TYPE];
+         json & rtype = result[JsonLdConsts::TYPE];
         if (!rtype.is_array()) {
             json j;
-            j.push_back(rtype);
-            result[JsonLdConsts::TYPE] = j;
+            j.push_back(std::move(rtype));
+            rtype = std::move(j);
         }
     }
         // 10)
@@ -510,7 +876,7 @@ json JsonLdApi::expandObjectElement(Context activeCtx, std::string * activePrope
             // so simply return the value rather than have to make
             // result an object and cast it with every
             // other use in the function.
-            return result[JsonLdConsts::SET];
+            return std::move(result[JsonLdConsts::SET]);
         }
     }
     // 11)
@@ -537,30 +903,39 @@ json JsonLdApi::expandObjectElement(Context activeCtx, std::string * activePrope
 }
 
 RDF::RDFDataset JsonLdApi::toRDF(nlohmann::json element) {
-    auto nodeMap = ObjUtils::newMap();
-    nodeMap[JsonLdConsts::DEFAULT] = ObjUtils::newMap();
-    generateNodeMap(element, nodeMap);
-    RDF::RDFDataset dataset(options, &blankNodeUniqueNamer);
+    // the node map is thrown away once the dataset is built, so when asked to, build it
+    // in an arena and release it in one go on return
+    std::unique_ptr<Arena> arena;
+    if (options.getUseArena())
+        arena.reset(new Arena());
+    ArenaScope arenaScope(arena.get());
 
-    std::vector<std::string> keys;
-    for (json::iterator it = nodeMap.begin(); it != nodeMap.end(); ++it) {
-        keys.push_back(it.key());
+    RDF::RDFDataset dataset(options, &blankNodeUniqueNamer);
+    RDF::NodeMap nodeMap(*dataset.getTermDictionary());
+    nodeMap.getGraph(JsonLdConsts::DEFAULT);
+    if (arena) {
+        // copy the element into the arena too, as generating the node map takes it apart
+        arena_json arenaElement(element);
+        generateNodeMap(arenaElement, nodeMap);
+    }
+    else {
+        generateNodeMap(element, nodeMap);
     }
 
-    for (auto & graphName : keys) {
+    for (const RDF::NodeMap::Graph * graph : nodeMap.getGraphs()) {
         // 4.1)
-        if (JsonLdUtils::isRelativeIri(graphName)) {
+        if (JsonLdUtils::isRelativeIri(dataset.getTermDictionary()->get(graph->name))) {
             continue;
         }
-        json & graph = nodeMap[graphName];
-        dataset.graphToRDF(graphName, graph);
+        dataset.graphToRDF(*graph);
     }
 
     return dataset;
 }
 
-void JsonLdApi::generateNodeMap(json & element, json &nodeMap, std::string *activeGraph, nlohmann::json *activeSubject,
-                                std::string *activeProperty, json *list)
+template <class JSON>
+void JsonLdApi::generateNodeMap(JSON & element, RDF::NodeMap &nodeMap, std::string *activeGraph, arena_json *activeSubject,
+                                std::string *activeProperty, arena_json *list)
 {
     // 1)
     if (element.is_array()) {
@@ -572,25 +947,21 @@ void JsonLdApi::generateNodeMap(json & element, json &nodeMap, std::string *acti
     }
 
     // 2)
-    if (!nodeMap.contains(*activeGraph)) {
-        nodeMap[*activeGraph] = ObjUtils::newMap();
-    }
-    json & graph = nodeMap[*activeGraph];
+    RDF::NodeMap::Graph & graph = nodeMap.getGraph(*activeGraph);
 
-    json * node = nullptr;
-    if (activeSubject != nullptr && activeSubject->is_string() &&
-        graph.contains(activeSubject->get<std::string>())) {
-        node = &graph[activeSubject->get<std::string>()];
+    RDF::NodeMap::Node * node = nullptr;
+    if (activeSubject != nullptr && activeSubject->is_string()) {
+        node = nodeMap.findNode(graph, activeSubject->get_ref<const std::string &>());
     }
 
     // 3)
     if (element.contains(JsonLdConsts::TYPE)) {
         // 3.1)
-        json oldTypes;
-        json newTypes;
+        JSON oldTypes;
+        JSON newTypes;
         oldTypes = element[JsonLdConsts::TYPE];
         for (const auto& item : oldTypes) {
-            std::string s = item.get<std::string>();
+            std::string s = item.template get<std::string>();
             if (s.find_first_of("_:") == 0) {
                 newTypes.push_back(blankNodeUniqueNamer.get(item));
             } else {
@@ -612,23 +983,23 @@ void JsonLdApi::generateNodeMap(json & element, json &nodeMap, std::string *acti
             // todo: seems like at this point there shouldn't ever be a way for activeProperty to be null, but we might want to check anyway
             if(activeProperty == nullptr)
                 throw  std::runtime_error("activeProperty should not be nullptr");
-            JsonLdUtils::mergeValue(*node, *activeProperty, element);
+            mergedValues.mergeValue(nodeMap.getValues(*node, *activeProperty), arena_json(element));
         }
             // 4.2)
         else {
-            JsonLdUtils::mergeValue(*list, JsonLdConsts::LIST, element);
+            mergedValues.mergeValue(*list, JsonLdConsts::LIST, arena_json(element));
         }
     }
 
         // 5)
     else if (element.contains(JsonLdConsts::LIST)) {
         // 5.1)
-        json result = ObjUtils::newMap(JsonLdConsts::LIST, json::array());
+        arena_json result = arenaMap(JsonLdConsts::LIST, arena_json::array());
         // 5.2)
         generateNodeMap(element[JsonLdConsts::LIST], nodeMap, activeGraph, activeSubject,
                         activeProperty, &result);
         // 5.3)
-        JsonLdUtils::mergeValue(*node, *activeProperty, result);
+        mergedValues.mergeValue(nodeMap.getValues(*node, *activeProperty), result);
     }
 
     else {
@@ -646,68 +1017,64 @@ void JsonLdApi::generateNodeMap(json & element, json &nodeMap, std::string *acti
         else {
             id = blankNodeUniqueNamer.get();
         }
-        // 6.3)
-        if (!graph.contains(id)) {
-            json tmp = ObjUtils::newMap(JsonLdConsts::ID, id);
-            graph[id] = tmp;
-            graph["key_insertion_order"].push_back(id);
-        }
+        // 6.3) the node map keeps the order nodes are added in
+        RDF::NodeMap::Node & idNode = nodeMap.getNode(graph, id);
         // 6.4) removed for now
         // 6.5)
         if (activeSubject != nullptr && activeSubject->is_object()) {
             // 6.5.1)
-            JsonLdUtils::mergeValue(graph[id], *activeProperty, *activeSubject);
+            mergedValues.mergeValue(nodeMap.getValues(idNode, *activeProperty), *activeSubject);
         }
             // 6.6)
         else if (activeProperty != nullptr) {
-            json reference = ObjUtils::newMap(JsonLdConsts::ID, id);
+            arena_json reference = arenaMap(JsonLdConsts::ID, id);
             // 6.6.2)
             if (list == nullptr) {
                 // 6.6.2.1+2)
-                JsonLdUtils::mergeValue(*node, *activeProperty, reference);
+                mergedValues.mergeValue(nodeMap.getValues(*node, *activeProperty), reference);
             }
                 // 6.6.3) TODO: SPEC says to add ELEMENT to @list member, should be REFERENCE
             else {
-                JsonLdUtils::mergeValue(*list, JsonLdConsts::LIST, reference);
+                mergedValues.mergeValue(*list, JsonLdConsts::LIST, reference);
             }
         }
         // TODO: SPEC this is removed in the spec now, but it's still needed
         // (see 6.4)
-        node = &graph[id];
+        node = &idNode;
         // 6.7)
         if (element.contains(JsonLdConsts::TYPE)) {
-            json types = element[JsonLdConsts::TYPE];
+            JSON types = element[JsonLdConsts::TYPE];
             element.erase(JsonLdConsts::TYPE);
             for (const auto& type : types) {
-                JsonLdUtils::mergeValue(*node, JsonLdConsts::TYPE, type);
+                mergedValues.mergeValue(nodeMap.getValues(*node, JsonLdConsts::TYPE), arena_json(type));
             }
         }
         // 6.8)
         if (element.contains(JsonLdConsts::INDEX)) {
-            json elemIndex = element[JsonLdConsts::INDEX];
+            arena_json elemIndex(element[JsonLdConsts::INDEX]);
             element.erase(JsonLdConsts::INDEX);
-            if (node->contains(JsonLdConsts::INDEX)) {
-                if (!JsonLdUtils::deepCompare(node->at(JsonLdConsts::INDEX), elemIndex)) {
+            if (!node->index.is_null()) {
+                if (!JsonLdUtils::deepCompare(node->index, elemIndex)) {
                     throw JsonLdError(JsonLdError::ConflictingIndexes);
                 }
             } else {
-                (*node)[JsonLdConsts::INDEX] = elemIndex;
+                node->index = elemIndex;
             }
         }
         // 6.9)
         if (element.contains(JsonLdConsts::REVERSE)) {
             // 6.9.1)
-            json referencedNode = ObjUtils::newMap(JsonLdConsts::ID, id);
+            arena_json referencedNode = arenaMap(JsonLdConsts::ID, id);
             // 6.9.2+6.9.4)
-            json reverseMap = element[JsonLdConsts::REVERSE];
+            JSON reverseMap = element[JsonLdConsts::REVERSE];
             element.erase(JsonLdConsts::REVERSE);
             // 6.9.3)
             std::vector<std::string> reverseMap_keys;
-            for (json::iterator it = reverseMap.begin(); it != reverseMap.end(); ++it) {
+            for (typename JSON::iterator it = reverseMap.begin(); it != reverseMap.end(); ++it) {
                 reverseMap_keys.push_back(it.key());
             }
             for (auto property : reverseMap_keys) {
-                json values = reverseMap[property];
+                JSON values = reverseMap[property];
                 // 6.9.3.1)
                 for (auto reverseMap_value : values) {
                     // 6.9.3.1.1)
@@ -717,28 +1084,26 @@ void JsonLdApi::generateNodeMap(json & element, json &nodeMap, std::string *acti
         }
         // 6.10)
         if (element.contains(JsonLdConsts::GRAPH)) {
-            json elemGraph = element[JsonLdConsts::GRAPH];
+            JSON elemGraph = element[JsonLdConsts::GRAPH];
             element.erase(JsonLdConsts::GRAPH);
             generateNodeMap(elemGraph, nodeMap, &id, nullptr, nullptr, nullptr);
         }
         // 6.11)
         std::vector<std::string> keys;
-        for (json::iterator it = element.begin(); it != element.end(); ++it) {
+        for (typename JSON::iterator it = element.begin(); it != element.end(); ++it) {
             keys.push_back(it.key());
         }
         std::sort(keys.begin(), keys.end());
         for (auto property : keys) {
-            json & propertyValue = element[property];
+            JSON & propertyValue = element[property];
             // 6.11.1)
             if (property.find_first_of("_:") == 0) {
                 property = blankNodeUniqueNamer.get(property);
             }
             // 6.11.2)
-            if (node != nullptr && !node->contains(property)) {
-                (*node)[property] = json::array();
-            }
+            nodeMap.getValues(*node, property);
             // 6.11.3)
-            json jid = id;
+            arena_json jid = id;
             generateNodeMap(propertyValue, nodeMap, activeGraph, &jid, &property, nullptr);
         }
 
@@ -746,77 +1111,69 @@ void JsonLdApi::generateNodeMap(json & element, json &nodeMap, std::string *acti
 
 }
 
-void JsonLdApi::generateNodeMap(json & element, json & nodeMap)
+template <class JSON>
+void JsonLdApi::generateNodeMap(JSON & element, RDF::NodeMap & nodeMap)
 {
     std::string defaultGraph(JsonLdConsts::DEFAULT);
+    mergedValues.clear();
     generateNodeMap(element, nodeMap, &defaultGraph, nullptr, nullptr, nullptr);
+    mergedValues.clear();
 }
 
 std::string JsonLdApi::normalize(const RDF::RDFDataset& dataset) {
-    // create quads and map bnodes to their associated quads
-    std::vector<RDF::Quad> quads;
-    std::map<std::string, std::map<std::string, std::vector<RDF::Quad>>> bnodes; //todo: this is a crazy data type
-    std::vector<std::string> bnodes_insertion_order_keys;
-    for (auto graphName : dataset.graphNames()) {
-        std::vector<RDF::Quad> triples = dataset.getQuads(graphName);
-        std::string *graphNamePtr = &graphName;
-        if (graphName == "@default") {
-            graphNamePtr = nullptr;
-        }
-        for (auto quad : triples) {
-            if(graphNamePtr != nullptr) {
-               quad.setGraph(graphNamePtr);
-            }
-
-            quads.push_back(quad);
-
-            // todo: replace this with an iteration over function pointers
-            auto n = quad.getSubject();
-            if(n != nullptr) {
-                if(n->isBlankNode()) {
-                    std::string id = n->getValue();
-                    if(!bnodes.count(id)) {
-                        std::vector<RDF::Quad> tmp;
-                        bnodes[id]["quads"] = tmp;
-                        bnodes_insertion_order_keys.push_back(id);
-                    }
-                    bnodes[id]["quads"].push_back(quad);
-                }
-            }
-            n = quad.getObject();
-            if(n != nullptr) {
-                if(n->isBlankNode()) {
-                    std::string id = n->getValue();
-                    if(!bnodes.count(id)) {
-                        std::vector<RDF::Quad> tmp;
-                        bnodes[id]["quads"] = tmp;
-                        bnodes_insertion_order_keys.push_back(id);
-                    }
-                    bnodes[id]["quads"].push_back(quad);
-                }
-            }
-            n = quad.getGraph();
-            if(n != nullptr) {
-                if(n->isBlankNode()) {
-                    std::string id = n->getValue();
-                    if(!bnodes.count(id)) {
-                        std::vector<RDF::Quad> tmp;
-                        bnodes[id]["quads"] = tmp;
-                        bnodes_insertion_order_keys.push_back(id);
-                    }
-                    bnodes[id]["quads"].push_back(quad);
+    bool urdna2015 = options.getAlgorithm() == JsonLdOptions::URDNA2015;
+    if (!urdna2015 && options.getAlgorithm() != JsonLdOptions::URGNA2012)
+        throw JsonLdError(JsonLdError::UnknownFormat, options.getAlgorithm());
+    std::string hashAlgorithm = options.getHashAlgorithm();
+    if (hashAlgorithm.empty())
+        hashAlgorithm = urdna2015 ? MessageDigest::SHA_256 : MessageDigest::SHA_1;
+    if (MessageDigest::getInstance(hashAlgorithm) == nullptr)
+        throw JsonLdError(JsonLdError::UnknownFormat, hashAlgorithm);
+    if (urdna2015)
+        return URDNA2015(dataset, options).canonicalize();
+
+    NormalizeUtils normalizeUtils(dataset, UniqueNamer("_:c14n"), options, hashAlgorithm);
+    return normalizeUtils.hashBlankNodes();
+}
+
+
+json JsonLdApi::fromRDF(const RDF::RDFDataset& dataset) {
+    std::vector<json> nodes;
+    fromRDF(dataset, [&nodes](json node) {
+        nodes.push_back(std::move(node));
+    });
+    // 6)
+    std::sort(nodes.begin(), nodes.end(), idLess);
+    // 7)
+    json result = json::array();
+    for (auto & node : nodes)
+        result.push_back(std::move(node));
+    return result;
+}
+
+void JsonLdApi::fromRDF(const RDF::RDFDataset& dataset, const NodeSink& sink) {
+    std::set<std::string> graphNames = dataset.graphNames();
+    graphNames.erase(JsonLdConsts::DEFAULT);
+
+    // 6.1) the node of a graph name holds the nodes of that graph
+    std::set<std::string> attached;
+    GraphSerializer(dataset, dataset.getGraphRange(JsonLdConsts::DEFAULT), options).serialize(
+            [&](json node) {
+                const std::string & id = node.at(JsonLdConsts::ID).get_ref<const std::string &>();
+                if (graphNames.count(id)) {
+                    attached.insert(id);
+                    node[JsonLdConsts::GRAPH] = namedGraph(dataset, id, options);
                 }
-            }
-        }
-    }
+                sink(std::move(node));
+            });
 
-    // mapping complete, start canonical naming
-    NormalizeUtils normalizeUtils(quads, bnodes, UniqueNamer("_:c14n"), options);
-    std::vector<std::string> ids;
-    ids.reserve(bnodes.size()); // todo: need to make a keySet() function...
-    for(auto const & i : bnodes) {
-        ids.push_back(i.first);
+    // 3.2) graph names that are not the subject of any quad in the default graph
+    for (const auto & graphName : graphNames) {
+        if (attached.count(graphName))
+            continue;
+        json node = json::object();
+        node[JsonLdConsts::ID] = graphName;
+        node[JsonLdConsts::GRAPH] = namedGraph(dataset, graphName, options);
+        sink(std::move(node));
     }
-    return normalizeUtils.hashBlankNodes(bnodes_insertion_order_keys); // todo: this is the only call to hashblanknodes. that method should just always use all the ids so I don't have to pass them in?
 }
-
@@ -5,18 +5,28 @@
 #include "JsonLdOptions.h"
 #include "Context.h"
 #include "RDFDataset.h"
+#include "Arena.h"
+#include "MergeIndex.h"
+#include <functional>
 
 class JsonLdApi {
 private:
     JsonLdOptions options;
     UniqueNamer blankNodeUniqueNamer;
+    // the values merged into the node map being generated
+    MergeIndex mergedValues;
 
 public:
 
+    /**
+     * Receives the top-level node objects of a fromRDF() conversion one at a time.
+     */
+    typedef std::function<void(nlohmann::json)> NodeSink;
+
     JsonLdApi() = default;
     explicit JsonLdApi(JsonLdOptions options);
 
-    JsonLdOptions getOptions() const;
+    const JsonLdOptions& getOptions() const;
 
     /**
      * Expansion Algorithm
@@ -31,7 +41,7 @@ public:
      *            The current element
      * @return The expanded JSON-LD object.
      */
-    nlohmann::json expand(Context activeCtx, std::string *activeProperty, nlohmann::json element);
+    nlohmann::json expand(const Context & activeCtx, std::string *activeProperty, const nlohmann::json & element);
 
     /**
      * Expansion Algorithm
@@ -44,7 +54,7 @@ public:
      *            The current element
      * @return The expanded JSON-LD object.
      */
-    nlohmann::json expand(Context activeCtx, nlohmann::json element);
+    nlohmann::json expand(const Context & activeCtx, const nlohmann::json & element);
 
     /**
      * Adds RDF triples for each graph in the current node map to an RDF
@@ -55,26 +65,60 @@ public:
     RDF::RDFDataset toRDF(nlohmann::json element);
 
     /**
-     * Performs RDF normalization on the given JSON-LD input.
+     * Performs RDF normalization on the given JSON-LD input, with the algorithm
+     * selected by the algorithm option: URGNA2012, the default, or URDNA2015.
      *
      * @param dataset
      *            the expanded JSON-LD object to normalize.
      * @return The normalized JSON-LD object
      * @throws JsonLdError
-     *             If there was an error while normalizing.
+     *             If there was an error while normalizing, or the algorithm is unknown.
      */
     std::string normalize(const RDF::RDFDataset& dataset);
 
+    /**
+     * Serialize RDF as JSON-LD Algorithm
+     *
+     * http://www.w3.org/TR/json-ld-api/#serialize-rdf-as-json-ld-algorithm
+     *
+     * @param dataset
+     *            The RDF dataset to convert
+     * @return The expanded JSON-LD document, with top-level nodes sorted by @id
+     */
+    nlohmann::json fromRDF(const RDF::RDFDataset& dataset);
+
+    /**
+     * Serialize RDF as JSON-LD Algorithm, handing each top-level node object to sink as
+     * soon as it is complete instead of building the whole document.
+     *
+     * Nodes of the default graph are emitted in the order their subjects first appear in
+     * the dataset, followed by the named graphs that are not the subject of any quad in
+     * the default graph. If the quads of each graph are sorted by subject, as in a sorted
+     * N-Quads file, only the node being built, the contents of the named graph being
+     * attached to it and a small index of the blank nodes that make up lists are held in
+     * memory. Otherwise the quads of each graph are first grouped by subject through a
+     * permutation of their positions.
+     *
+     * @param dataset
+     *            The RDF dataset to convert
+     * @param sink
+     *            Receives the top-level node objects
+     */
+    void fromRDF(const RDF::RDFDataset& dataset, const NodeSink& sink);
+
 private:
 
-    nlohmann::json expandArrayElement(Context activeCtx, std::string *activeProperty, const nlohmann::json& element);
+    nlohmann::json expandArrayElement(const Context & activeCtx, std::string *activeProperty, const nlohmann::json& element);
 
-    nlohmann::json expandObjectElement(Context activeCtx, std::string *activeProperty, nlohmann::json element);
+    nlohmann::json expandObjectElement(const Context & parentCtx, std::string *activeProperty, const nlohmann::json & element);
 
-    void generateNodeMap(nlohmann::json &element, nlohmann::json &nodeMap);
+    // element is a nlohmann::json, or an arena_json when the node map is built in an arena
+    template <class JSON>
+    void generateNodeMap(JSON &element, RDF::NodeMap &nodeMap);
 
-    void generateNodeMap(nlohmann::json &element, nlohmann::json &nodeMap, std::string *activeGraph,
-                         nlohmann::json *activeSubject, std::string *activeProperty, nlohmann::json *list);
+    template <class JSON>
+    void generateNodeMap(JSON &element, RDF::NodeMap &nodeMap, std::string *activeGraph,
+                         arena_json *activeSubject, std::string *activeProperty, arena_json *list);
 };
 
 #endif //LIBJSONLD_CPP_JSONLDAPI_H
@@ -0,0 +1,28 @@
+#include "JsonLdConsts.h"
+
+namespace JsonLdConsts {
+
+    const std::string ID = "@id";
+    const std::string DEFAULT = "@default";
+    const std::string GRAPH = "@graph";
+    const std::string CONTEXT = "@context";
+    const std::string PRESERVE = "@preserve";
+    const std::string EXPLICIT = "@explicit";
+    const std::string OMIT_DEFAULT = "@omitDefault";
+    const std::string EMBED_CHILDREN = "@embedChildren";
+    const std::string EMBED = "@embed";
+    const std::string LIST = "@list";
+    const std::string LANGUAGE = "@language";
+    const std::string INDEX = "@index";
+    const std::string SET = "@set";
+    const std::string TYPE = "@type";
+    const std::string REVERSE = "@reverse";
+    const std::string VALUE = "@value";
+    const std::string ATNULL = "@null";
+    const std::string NONE = "@none";
+    const std::string CONTAINER = "@container";
+    const std::string VOCAB = "@vocab";
+    const std::string BASE = "@base";
+    const std::string REQUIRE_ALL = "@requireAll";
+
+}
@@ -1,6 +1,8 @@
 #ifndef LIBJSONLD_CPP_JSONLDCONSTS_H
 #define LIBJSONLD_CPP_JSONLDCONSTS_H
 
+#include <string>
+
 /**
  * Constants used in the JSON-LD parser.
  */
@@ -37,29 +39,45 @@ namespace JsonLdConsts {
     static constexpr const char COMPACTED[] = "compacted";
     static constexpr const char EXPANDED[] = "expanded";
 
-    static constexpr const char ID[] = "@id";
-    static constexpr const char DEFAULT[] = "@default";
-    static constexpr const char GRAPH[] = "@graph";
-    static constexpr const char CONTEXT[] = "@context";
-    static constexpr const char PRESERVE[] = "@preserve";
-    static constexpr const char EXPLICIT[] = "@explicit";
-    static constexpr const char OMIT_DEFAULT[] = "@omitDefault";
-    static constexpr const char EMBED_CHILDREN[] = "@embedChildren";
-    static constexpr const char EMBED[] = "@embed";
-    static constexpr const char LIST[] = "@list";
-    static constexpr const char LANGUAGE[] = "@language";
-    static constexpr const char INDEX[] = "@index";
-    static constexpr const char SET[] = "@set";
-    static constexpr const char TYPE[] = "@type";
-    static constexpr const char REVERSE[] = "@reverse";
-    static constexpr const char VALUE[] = "@value";
-    static constexpr const char ATNULL[] = "@null";
-    static constexpr const char NONE[] = "@none";
-    static constexpr const char CONTAINER[] = "@container";
     static constexpr const char BLANK_NODE_PREFIX[] = "_:";
-    static constexpr const char VOCAB[] = "@vocab";
-    static constexpr const char BASE[] = "@base";
-    static constexpr const char REQUIRE_ALL[] = "@requireAll";
+
+    /*
+     * The keywords are std::strings rather than char arrays because they are mostly used
+     * to look up members of json objects, and a char array would be made into a new
+     * std::string for every lookup. Being defined in JsonLdConsts.cpp, they must not be
+     * used to initialize other namespace scope objects.
+     */
+    extern const std::string ID;
+    extern const std::string DEFAULT;
+    extern const std::string GRAPH;
+    extern const std::string CONTEXT;
+    extern const std::string PRESERVE;
+    extern const std::string EXPLICIT;
+    extern const std::string OMIT_DEFAULT;
+    extern const std::string EMBED_CHILDREN;
+    extern const std::string EMBED;
+    extern const std::string LIST;
+    extern const std::string LANGUAGE;
+    extern const std::string INDEX;
+    extern const std::string SET;
+    extern const std::string TYPE;
+    extern const std::string REVERSE;
+    extern const std::string VALUE;
+    extern const std::string ATNULL;
+    extern const std::string NONE;
+    extern const std::string CONTAINER;
+    extern const std::string VOCAB;
+    extern const std::string BASE;
+    extern const std::string REQUIRE_ALL;
+
+    /**
+     * The keywords that JsonLdUtils::isKeyword() accepts, as told apart by
+     * JsonLdUtils::getKeyword(). NotAKeyword is anything else.
+     */
+    enum class Keyword : unsigned char {
+        NotAKeyword, Base, Container, Context, Default, Embed, Explicit, Graph, Id, Index,
+        Language, List, OmitDefault, Preserve, RequireAll, Reverse, Set, Type, Value, Vocab
+    };
 
     enum Embed {
         ALWAYS, NEVER, ONCE, LINK
@@ -54,4 +54,5 @@ const char JsonLdError::NotImplemented[] = "not implemented";
 const char JsonLdError::UnknownFormat[] = "unknown format";
 const char JsonLdError::InvalidInput[] = "invalid input";
 const char JsonLdError::ParseError[] = "parse error";
+const char JsonLdError::NormalizationBudgetExceeded[] = "normalization budget exceeded";
 const char JsonLdError::UnknownError[] = "unknown error";
@@ -46,6 +46,7 @@ public:
     static const char UnknownFormat[];
     static const char InvalidInput[];
     static const char ParseError[];
+    static const char NormalizationBudgetExceeded[];
     static const char UnknownError[];
 
 private:
@@ -5,4 +5,6 @@
 constexpr const char JsonLdOptions::JSON_LD_1_0[];
 constexpr const char JsonLdOptions::JSON_LD_1_1[];
 constexpr bool JsonLdOptions::DEFAULT_COMPACT_ARRAYS;
+constexpr const char JsonLdOptions::URGNA2012[];
+constexpr const char JsonLdOptions::URDNA2015[];
 
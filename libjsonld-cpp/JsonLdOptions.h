@@ -3,12 +3,20 @@
 
 // The JsonLdOptions type as specified in "JSON-LD-API specification":
 // http://www.w3.org/TR/json-ld-api/#the-jsonldoptions-type
+//
+// JsonLdOptions is copied into every JsonLdApi, Context and RDFDataset, so copies must
+// stay cheap: flags are stored inline, the base and the expand context are shared and
+// never modified once set (setters replace them), and the document loader is a handle
+// on a shared cache.
 
 #include "DocumentLoader.h"
 #include "JsonLdConsts.h"
+#include <memory>
 #include <string>
 #include <sstream>
 
+class ContextCache;
+
 class JsonLdOptions {
 private:
     // Base options : http://www.w3.org/TR/json-ld-api/#idl-def-JsonLdOptions
@@ -16,7 +24,7 @@ private:
     /**
      * http://www.w3.org/TR/json-ld-api/#widl-JsonLdOptions-base
      */
-    std::string base_;
+    std::shared_ptr<const std::string> base_;
 
     /**
      * http://www.w3.org/TR/json-ld-api/#widl-JsonLdOptions-compactArrays
@@ -25,7 +33,7 @@ private:
     /**
      * http://www.w3.org/TR/json-ld-api/#widl-JsonLdOptions-expandContext
      */
-    nlohmann::json expandContext_;
+    std::shared_ptr<const nlohmann::json> expandContext_;
     /**
      * http://www.w3.org/TR/json-ld-api/#widl-JsonLdOptions-processingMode
      */
@@ -53,6 +61,51 @@ private:
     bool useNativeTypes_ = false;
     bool produceGeneralizedRdf_ = false;
 
+    // Normalization options : https://json-ld.github.io/normalization/spec/
+
+    /**
+     * The canonicalization algorithm used by normalize(), URGNA2012 or URDNA2015.
+     */
+    std::string algorithm_ = URGNA2012;
+
+    /**
+     * The hash algorithm normalize() uses, MessageDigest::SHA_1 or SHA_256, or empty for
+     * the one the canonicalization algorithm specifies: SHA-1 for URGNA2012 and SHA-256
+     * for URDNA2015.
+     */
+    std::string hashAlgorithm_;
+
+    // Implementation options, not part of the specification
+
+    /**
+     * Allocate the objects and arrays of the temporary JSON structures of a call from an
+     * arena that is released when the call returns. Their strings are still allocated
+     * on the heap.
+     */
+    bool useArena_ = false;
+
+    /**
+     * The number of threads normalize() hashes blank nodes on. 1, the default, hashes
+     * on the calling thread only, 0 uses one thread per hardware thread.
+     */
+    unsigned int normalizationThreads_ = 1;
+
+    /**
+     * Limits on the work normalize() does to tell apart blank nodes that share a first
+     * degree hash: the permutations of blank nodes it tries, how deep its paths through
+     * them recurse, and how many of them it hashes. Going over one throws a
+     * NormalizationBudgetExceeded JsonLdError. 0, the default, means no limit; set them
+     * when normalizing documents from untrusted sources.
+     */
+    size_t maxNormalizationPermutations_ = 0;
+    size_t maxNormalizationDepth_ = 0;
+    size_t maxNormalizationHashes_ = 0;
+
+    /**
+     * Processed contexts shared between calls and documents, if set.
+     */
+    std::shared_ptr<ContextCache> contextCache_;
+
 public:
 
     static constexpr const char JSON_LD_1_0[] = "json-ld-1.0";
@@ -61,6 +114,10 @@ public:
 
     static constexpr bool DEFAULT_COMPACT_ARRAYS = true;
 
+    static constexpr const char URGNA2012[] = "URGNA2012";
+
+    static constexpr const char URDNA2015[] = "URDNA2015";
+
     /**
      * Constructs an instance of JsonLdOptions using the given base. Defaults to
      * empty base if none is given.
@@ -69,10 +126,10 @@ public:
      *            The base IRI for the document.
      */
     explicit JsonLdOptions(std::string base = "")
-    : base_(std::move(base)) {
+    : base_(std::make_shared<const std::string>(std::move(base))) {
     }
 
-    std::string getEmbed() {
+    std::string getEmbed() const {
         switch (embed_) {
             case JsonLdConsts::ALWAYS:
                 return "@always";
@@ -85,7 +142,7 @@ public:
         }
     }
 
-    JsonLdConsts::Embed getEmbedVal() {
+    JsonLdConsts::Embed getEmbedVal() const {
         return embed_;
     }
 
@@ -114,7 +171,7 @@ public:
         this->embed_ = embed;
     }
 
-    bool getExplicit() {
+    bool getExplicit() const {
         return explicit_;
     }
 
@@ -122,7 +179,7 @@ public:
         this->explicit_ = explicitFlag;
     }
 
-    bool getOmitDefault() {
+    bool getOmitDefault() const {
         return omitDefault_;
     }
 
@@ -130,7 +187,7 @@ public:
         this->omitDefault_ = omitDefault;
     }
 
-    bool getFrameExpansion() {
+    bool getFrameExpansion() const {
         return frameExpansion_;
     }
 
@@ -138,7 +195,7 @@ public:
         this->frameExpansion_ = frameExpansion;
     }
 
-    bool getOmitGraph() {
+    bool getOmitGraph() const {
         return omitGraph_;
     }
 
@@ -146,7 +203,7 @@ public:
         this->omitGraph_ = omitGraph;
     }
 
-    bool getPruneBlankNodeIdentifiers() {
+    bool getPruneBlankNodeIdentifiers() const {
         return pruneBlankNodeIdentifiers_;
     }
 
@@ -154,7 +211,7 @@ public:
         this->pruneBlankNodeIdentifiers_ = pruneBlankNodeIdentifiers;
     }
 
-    bool getRequireAll() {
+    bool getRequireAll() const {
         return requireAll_;
     }
 
@@ -162,7 +219,7 @@ public:
         this->requireAll_ = requireAll;
     }
 
-    bool getAllowContainerSetOnType() {
+    bool getAllowContainerSetOnType() const {
         return allowContainerSetOnType_;
     }
 
@@ -170,7 +227,7 @@ public:
         this->allowContainerSetOnType_ = allowContainerSetOnType;
     }
 
-    bool getCompactArrays() {
+    bool getCompactArrays() const {
         return compactArrays_;
     }
 
@@ -178,15 +235,19 @@ public:
         this->compactArrays_ = compactArrays;
     }
 
-    nlohmann::json getExpandContext() {
-        return expandContext_;
+    /**
+     * @return the expand context, or null if there is none
+     */
+    const nlohmann::json& getExpandContext() const {
+        static const nlohmann::json none;
+        return expandContext_ ? *expandContext_ : none;
     }
 
     void setExpandContext(nlohmann::json expandContext) {
-        this->expandContext_ = std::move(expandContext);
+        this->expandContext_ = std::make_shared<const nlohmann::json>(std::move(expandContext));
     }
 
-    std::string getProcessingMode() {
+    const std::string& getProcessingMode() const {
         return processingMode_;
     }
 
@@ -199,15 +260,15 @@ public:
         }
     }
 
-    std::string getBase() {
-        return base_;
+    const std::string& getBase() const {
+        return *base_;
     }
 
     void setBase(std::string base) {
-        this->base_ = std::move(base);
+        this->base_ = std::make_shared<const std::string>(std::move(base));
     }
 
-    bool getUseRdfType() {
+    bool getUseRdfType() const {
         return useRdfType_;
     }
 
@@ -215,7 +276,7 @@ public:
         this->useRdfType_ = useRdfType;
     }
 
-    bool getUseNativeTypes() {
+    bool getUseNativeTypes() const {
         return useNativeTypes_;
     }
 
@@ -223,7 +284,7 @@ public:
         this->useNativeTypes_ = useNativeTypes;
     }
 
-    bool getProduceGeneralizedRdf() {
+    bool getProduceGeneralizedRdf() const {
         return produceGeneralizedRdf_;
     }
 
@@ -231,7 +292,71 @@ public:
         this->produceGeneralizedRdf_ = produceGeneralizedRdf;
     }
 
-    DocumentLoader getDocumentLoader() {
+    const std::string& getAlgorithm() const {
+        return algorithm_;
+    }
+
+    void setAlgorithm(const std::string& algorithm) {
+        this->algorithm_ = algorithm;
+    }
+
+    bool getUseArena() const {
+        return useArena_;
+    }
+
+    void setUseArena(bool useArena) {
+        this->useArena_ = useArena;
+    }
+
+    const std::string& getHashAlgorithm() const {
+        return hashAlgorithm_;
+    }
+
+    void setHashAlgorithm(const std::string& hashAlgorithm) {
+        this->hashAlgorithm_ = hashAlgorithm;
+    }
+
+    unsigned int getNormalizationThreads() const {
+        return normalizationThreads_;
+    }
+
+    void setNormalizationThreads(unsigned int normalizationThreads) {
+        this->normalizationThreads_ = normalizationThreads;
+    }
+
+    size_t getMaxNormalizationPermutations() const {
+        return maxNormalizationPermutations_;
+    }
+
+    void setMaxNormalizationPermutations(size_t maxNormalizationPermutations) {
+        this->maxNormalizationPermutations_ = maxNormalizationPermutations;
+    }
+
+    size_t getMaxNormalizationDepth() const {
+        return maxNormalizationDepth_;
+    }
+
+    void setMaxNormalizationDepth(size_t maxNormalizationDepth) {
+        this->maxNormalizationDepth_ = maxNormalizationDepth;
+    }
+
+    size_t getMaxNormalizationHashes() const {
+        return maxNormalizationHashes_;
+    }
+
+    void setMaxNormalizationHashes(size_t maxNormalizationHashes) {
+        this->maxNormalizationHashes_ = maxNormalizationHashes;
+    }
+
+    const std::shared_ptr<ContextCache>& getContextCache() const {
+        return contextCache_;
+    }
+
+    void setContextCache(std::shared_ptr<ContextCache> contextCache) {
+        this->contextCache_ = std::move(contextCache);
+    }
+
+    const DocumentLoader& getDocumentLoader() const {
         return documentLoader_;
     }
 
@@ -1,6 +1,7 @@
 #include "JsonLdProcessor.h"
 #include "RDFDataset.h"
 #include "RDFDatasetUtils.h"
+#include "NQuadsParser.h"
 
 using RDF::RDFDataset;
 using nlohmann::json;
@@ -11,12 +12,13 @@ nlohmann::json JsonLdProcessor::expand(nlohmann::json input, JsonLdOptions opts)
     Context activeCtx(opts);
 
     // 4)
-    if (!opts.getExpandContext().empty()) {
-        json exCtx = opts.getExpandContext();
-        if (exCtx.contains(JsonLdConsts::CONTEXT)) {
-            exCtx = exCtx[JsonLdConsts::CONTEXT];
+    const json & expandContext = opts.getExpandContext();
+    if (!expandContext.empty()) {
+        const json * exCtx = &expandContext;
+        if (exCtx->contains(JsonLdConsts::CONTEXT)) {
+            exCtx = &exCtx->at(JsonLdConsts::CONTEXT);
         }
-        activeCtx = activeCtx.parse(exCtx);
+        activeCtx = activeCtx.parse(*exCtx);
     }
 
     // 5)
@@ -137,6 +139,10 @@ std::string JsonLdProcessor::toRDFString(const std::string& input, const JsonLdO
     return RDFDatasetUtils::toNQuads(dataset);
 }
 
+void JsonLdProcessor::toRDF(const std::string& input, const JsonLdOptions& options, RDF::NQuadsWriter& writer) {
+    writer.write(toRDF(input, options));
+}
+
 std::string JsonLdProcessor::normalize(const std::string& input, const JsonLdOptions& options) {
 
     RDFDataset dataset = toRDF(input, options);
@@ -144,6 +150,30 @@ std::string JsonLdProcessor::normalize(const std::string& input, const JsonLdOpt
     return api.normalize(dataset);
 }
 
+nlohmann::json JsonLdProcessor::fromRDF(const RDFDataset& dataset, const JsonLdOptions& options) {
+    JsonLdApi api(options);
+    return api.fromRDF(dataset);
+}
+
+nlohmann::json JsonLdProcessor::fromRDF(const std::string& nquads, const JsonLdOptions& options) {
+    RDFDataset dataset(options, nullptr);
+    RDF::NQuadsParser(dataset).parse(nquads);
+    return fromRDF(dataset, options);
+}
+
+void JsonLdProcessor::fromRDF(const RDFDataset& dataset, const JsonLdOptions& options,
+                              const JsonLdApi::NodeSink& sink) {
+    JsonLdApi api(options);
+    api.fromRDF(dataset, sink);
+}
+
+void JsonLdProcessor::fromRDF(const std::string& nquads, const JsonLdOptions& options,
+                              const JsonLdApi::NodeSink& sink) {
+    RDFDataset dataset(options, nullptr);
+    RDF::NQuadsParser(dataset).parse(nquads);
+    fromRDF(dataset, options, sink);
+}
+
 nlohmann::json JsonLdProcessor::expand(nlohmann::json input) {
     JsonLdOptions opts;
     return expand(std::move(input), opts);
@@ -7,6 +7,7 @@
 #include "Context.h"
 #include "RDFDataset.h"
 #include "JsonLdApi.h"
+#include "NQuadsWriter.h"
 
 /**
  * This class implements the
@@ -50,7 +51,39 @@ namespace JsonLdProcessor {
     RDF::RDFDataset toRDF(const std::string& input, const JsonLdOptions& options);
     std::string toRDFString(const std::string& input, const JsonLdOptions& options);
 
+    /**
+     * Converts the input to RDF and writes it in N-Quads format with the given writer,
+     * without building the whole output in memory.
+     */
+    void toRDF(const std::string& input, const JsonLdOptions& options, RDF::NQuadsWriter& writer);
+
     std::string normalize(const std::string& input, const JsonLdOptions& options);
+
+    /**
+     * Converts an RDF dataset to an expanded JSON-LD document according to the steps in
+     * the <a href="http://www.w3.org/TR/json-ld-api/#serialize-rdf-as-json-ld-algorithm">
+     * Serialize RDF as JSON-LD algorithm</a>, honouring the useRdfType and useNativeTypes
+     * options.
+     *
+     * @param dataset
+     *            The RDF dataset, or a string holding an N-Quads document.
+     * @param options
+     *            The {@link JsonLdOptions} to use.
+     * @return The expanded JSON-LD document
+     * @throws JsonLdError
+     *             If the N-Quads document is not valid.
+     */
+    nlohmann::json fromRDF(const RDF::RDFDataset& dataset, const JsonLdOptions& options);
+    nlohmann::json fromRDF(const std::string& nquads, const JsonLdOptions& options);
+
+    /**
+     * Converts an RDF dataset to JSON-LD, handing each top-level node object to sink as
+     * soon as it is complete instead of building the whole document. See
+     * JsonLdApi::fromRDF(const RDF::RDFDataset&, const JsonLdApi::NodeSink&) for the
+     * order of the nodes and what is held in memory.
+     */
+    void fromRDF(const RDF::RDFDataset& dataset, const JsonLdOptions& options, const JsonLdApi::NodeSink& sink);
+    void fromRDF(const std::string& nquads, const JsonLdOptions& options, const JsonLdApi::NodeSink& sink);
 }
 
 #endif //LIBJSONLD_CPP_JSONLDPROCESSOR_H
@@ -1,28 +1,79 @@
 #include "JsonLdUtils.h"
 #include "JsonLdConsts.h"
+#include <cstdint>
+#include <functional>
 
 bool JsonLdUtils::isKeyword(const std::string& property) {
+    return getKeyword(property) != JsonLdConsts::Keyword::NotAKeyword;
+}
+
+JsonLdConsts::Keyword JsonLdUtils::getKeyword(const std::string& property) {
+    using JsonLdConsts::Keyword;
+
+    if (property.size() < 3 || property[0] != '@')
+        return Keyword::NotAKeyword;
 
-    return
-            property == "@base" ||
-            property == "@context" ||
-            property == "@container" ||
-            property == "@default" ||
-            property == "@embed" ||
-            property == "@explicit" ||
-            property == "@graph" ||
-            property == "@id" ||
-            property == "@index" ||
-            property == "@language" ||
-            property == "@list" ||
-            property == "@omitDefault" ||
-            property == "@reverse" ||
-            property == "@preserve" ||
-            property == "@set" ||
-            property == "@type" ||
-            property == "@value" ||
-            property == "@vocab" ||
-            property == "@requireAll";
+    // the one keyword with this length and first letter, if any
+    Keyword keyword = Keyword::NotAKeyword;
+    const char * name = nullptr;
+    switch (property.size()) {
+        case 3:
+            if (property[1] == 'i') { keyword = Keyword::Id; name = "@id"; }
+            break;
+        case 4:
+            if (property[1] == 's') { keyword = Keyword::Set; name = "@set"; }
+            break;
+        case 5:
+            switch (property[1]) {
+                case 'b': keyword = Keyword::Base; name = "@base"; break;
+                case 'l': keyword = Keyword::List; name = "@list"; break;
+                case 't': keyword = Keyword::Type; name = "@type"; break;
+                default: break;
+            }
+            break;
+        case 6:
+            switch (property[1]) {
+                case 'e': keyword = Keyword::Embed; name = "@embed"; break;
+                case 'g': keyword = Keyword::Graph; name = "@graph"; break;
+                case 'i': keyword = Keyword::Index; name = "@index"; break;
+                case 'v':
+                    if (property[2] == 'a') { keyword = Keyword::Value; name = "@value"; }
+                    else { keyword = Keyword::Vocab; name = "@vocab"; }
+                    break;
+                default: break;
+            }
+            break;
+        case 8:
+            switch (property[1]) {
+                case 'c': keyword = Keyword::Context; name = "@context"; break;
+                case 'd': keyword = Keyword::Default; name = "@default"; break;
+                case 'r': keyword = Keyword::Reverse; name = "@reverse"; break;
+                default: break;
+            }
+            break;
+        case 9:
+            switch (property[1]) {
+                case 'e': keyword = Keyword::Explicit; name = "@explicit"; break;
+                case 'l': keyword = Keyword::Language; name = "@language"; break;
+                case 'p': keyword = Keyword::Preserve; name = "@preserve"; break;
+                default: break;
+            }
+            break;
+        case 10:
+            if (property[1] == 'c') { keyword = Keyword::Container; name = "@container"; }
+            break;
+        case 11:
+            if (property[1] == 'r') { keyword = Keyword::RequireAll; name = "@requireAll"; }
+            break;
+        case 12:
+            if (property[1] == 'o') { keyword = Keyword::OmitDefault; name = "@omitDefault"; }
+            break;
+        default:
+            break;
+    }
+    if (name == nullptr || property.compare(name) != 0)
+        return Keyword::NotAKeyword;
+    return keyword;
 }
 
 bool JsonLdUtils::isAbsoluteIri(const std::string &value) {
@@ -34,80 +85,181 @@ bool JsonLdUtils::isRelativeIri(const std::string &value) {
     return !(isKeyword(value) || isAbsoluteIri(value));
 }
 
-bool JsonLdUtils::deepCompare(JsonLdUtils::json v1, JsonLdUtils::json v2) {
-    if (v1.is_null()) {
-        return v2.is_null();
-    } else if (v2.is_null()) {
-        return v1.is_null();
-    } else if (v1.is_object() && v2.is_object()) {
-        if (v1.size() != v2.size()) {
-            return false;
-        }
-        for (auto& el : v1.items()) {
-            if(!v2.contains(el.key()) || !deepCompare(el.value(), v2.at(el.key())))
+namespace {
+
+    // the algorithms below work the same on nlohmann::json and arena_json
+
+    template<typename JSON>
+    bool deepCompareImpl(const JSON& v1, const JSON& v2) {
+        if (v1.is_null()) {
+            return v2.is_null();
+        } else if (v2.is_null()) {
+            return v1.is_null();
+        } else if (v1.is_object() && v2.is_object()) {
+            if (v1.size() != v2.size()) {
                 return false;
+            }
+            for (auto& el : v1.items()) {
+                if(!v2.contains(el.key()) || !deepCompareImpl(el.value(), v2.at(el.key())))
+                    return false;
+            }
+            return true;
+        } else if (v1.is_array() && v2.is_array()) {
+            if (v1.size() != v2.size()) {
+                return false;
+            }
+            // used to mark members of v2 that we have already matched to avoid
+            // matching the same item twice for lists that have duplicates
+            std::vector<bool> alreadyMatched(v2.size());
+            for (const auto& o1 : v1) {
+                bool gotmatch = false;
+
+                for (size_t j = 0; j < v2.size(); j++) {
+                    if (!alreadyMatched[j] && deepCompareImpl(o1, v2.at(j))) {
+                        alreadyMatched[j] = true;
+                        gotmatch = true;
+                        break;
+                    }
+                }
+
+                if (!gotmatch) {
+                    return false;
+                }
+            }
+            return true;
+        } else {
+            return v1 == v2;
         }
-        return true;
-    } else if (v1.is_array() && v2.is_array()) {
-        if (v1.size() != v2.size()) {
-            return false;
-        }
-        // used to mark members of v2 that we have already matched to avoid
-        // matching the same item twice for lists that have duplicates
-        std::vector<bool> alreadyMatched(v2.size());
-        for (const auto& o1 : v1) {
-            bool gotmatch = false;
-
-            for (size_t j = 0; j < v2.size(); j++) {
-                if (!alreadyMatched[j] && deepCompare(o1, v2.at(j))) {
-                    alreadyMatched[j] = true;
-                    gotmatch = true;
-                    break;
+    }
+
+    size_t mix(size_t h) {
+        uint64_t x = h;
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return static_cast<size_t>(x);
+    }
+
+    template<typename JSON>
+    size_t deepHashImpl(const JSON& value, bool orderedArrays) {
+        switch (value.type()) {
+            case JSON::value_t::object: {
+                size_t h = 1;
+                for (auto it = value.begin(); it != value.end(); ++it) {
+                    h = mix(h + std::hash<std::string>()(it.key()));
+                    h = mix(h + deepHashImpl(it.value(), orderedArrays));
+                }
+                return h;
+            }
+            case JSON::value_t::array: {
+                // deepCompare matches up array elements in any order
+                size_t h = 2 + value.size();
+                for (const auto& item : value) {
+                    if (orderedArrays)
+                        h = mix(h + deepHashImpl(item, orderedArrays));
+                    else
+                        h += mix(deepHashImpl(item, orderedArrays));
                 }
+                return mix(h);
+            }
+            case JSON::value_t::string:
+                return std::hash<std::string>()(value.template get_ref<const std::string &>());
+            case JSON::value_t::boolean:
+                return value.template get<bool>() ? 3 : 4;
+            case JSON::value_t::number_integer:
+            case JSON::value_t::number_unsigned:
+            case JSON::value_t::number_float: {
+                // 1 and 1.0 are equal, as are 0.0 and -0.0
+                double d = value.template get<double>();
+                if (d == 0)
+                    d = 0;
+                return mix(std::hash<double>()(d));
             }
+            default:
+                return 0;
+        }
+    }
 
-            if (!gotmatch) {
-                return false;
+    template<typename JSON>
+    bool deepContainsImpl(const JSON& values, const JSON& value) {
+        for (const auto& item : values) {
+            if (deepCompareImpl(item, value)) {
+                return true;
             }
         }
-        return true;
-    } else {
-        return v1 == v2;
+        return false;
     }
+
+    template<typename JSON>
+    void mergeValueImpl(JSON & obj, const std::string& key, const JSON& value) {
+        if (obj.is_null()) {
+            return;
+        }
+        JSON & values = obj[key];
+        if (values.is_null()) {
+            values = JSON::array();
+        }
+        if (key == JsonLdConsts::LIST || value.contains(JsonLdConsts::LIST) || !deepContainsImpl(values, value)) {
+            values.push_back(value);
+        }
+    }
+
+}
+
+bool JsonLdUtils::deepCompare(JsonLdUtils::json v1, JsonLdUtils::json v2) {
+    return deepCompareImpl(v1, v2);
+}
+
+bool JsonLdUtils::deepCompare(const arena_json& v1, const arena_json& v2) {
+    return deepCompareImpl(v1, v2);
+}
+
+size_t JsonLdUtils::deepHash(const JsonLdUtils::json& value, bool orderedArrays) {
+    return deepHashImpl(value, orderedArrays);
+}
+
+size_t JsonLdUtils::deepHash(const arena_json& value, bool orderedArrays) {
+    return deepHashImpl(value, orderedArrays);
 }
 
 bool JsonLdUtils::isList(const JsonLdUtils::json& j) {
     return j.contains(JsonLdConsts::LIST);
 }
 
+bool JsonLdUtils::isList(const arena_json& j) {
+    return j.contains(JsonLdConsts::LIST);
+}
+
 bool JsonLdUtils::isValue(const JsonLdUtils::json& j) {
     return j.contains(JsonLdConsts::VALUE);
 }
 
+bool JsonLdUtils::isValue(const arena_json& j) {
+    return j.contains(JsonLdConsts::VALUE);
+}
+
 bool JsonLdUtils::isObject(const JsonLdUtils::json& j) {
     return j.is_object();
 }
 
+bool JsonLdUtils::isObject(const arena_json& j) {
+    return j.is_object();
+}
+
 bool JsonLdUtils::deepContains(const JsonLdUtils::json& values, const JsonLdUtils::json& value) {
-    for (const auto& item : values) {
-        if (deepCompare(item, value)) {
-            return true;
-        }
-    }
-    return false;
+    return deepContainsImpl(values, value);
 }
 
+bool JsonLdUtils::deepContains(const arena_json& values, const arena_json& value) {
+    return deepContainsImpl(values, value);
+}
 
 void JsonLdUtils::mergeValue(json & obj, const std::string& key, const json& value) {
-    if (obj.is_null()) {
-        return;
-    }
-    json & values = obj[key];
-    if (values.is_null()) {
-        values = json::array();
-        obj[key] = values;
-    }
-    if (key == "@list" || value.contains("@list") || !deepContains(values, value)) {
-        values.push_back(value);
-    }
+    mergeValueImpl(obj, key, value);
+}
+
+void JsonLdUtils::mergeValue(arena_json & obj, const std::string& key, const arena_json& value) {
+    mergeValueImpl(obj, key, value);
 }
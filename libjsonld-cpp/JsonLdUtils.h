@@ -2,12 +2,24 @@
 #define LIBJSONLD_CPP_JSONLDUTILS_H
 
 #include "jsoninc.h"
+#include "Arena.h"
+#include "JsonLdConsts.h"
 
 namespace JsonLdUtils {
 
     using json = nlohmann::json;
 
     bool deepCompare(json v1, json v2);
+    bool deepCompare(const arena_json& v1, const arena_json& v2);
+
+    /**
+     * Returns a hash of the given value that is the same for any two values deepCompare
+     * finds equal: array elements are hashed in any order, and numbers by their value
+     * whatever their type. With orderedArrays, the order of array elements counts too,
+     * so that the hash is the same for any two values == finds equal.
+     */
+    size_t deepHash(const json& value, bool orderedArrays = false);
+    size_t deepHash(const arena_json& value, bool orderedArrays = false);
 
     /**
      * Returns whether or not the given value is a keyword (or a keyword alias).
@@ -18,19 +30,35 @@ namespace JsonLdUtils {
      */
     bool isKeyword(const std::string& property);
 
+    /**
+     * Returns which keyword the given value is, with a switch on its length and first
+     * letter followed by a single comparison, so it is cheap enough to call for every key
+     * of every object.
+     *
+     * @param property
+     *            the value to check.
+     * @return the keyword, or Keyword::NotAKeyword.
+     */
+    JsonLdConsts::Keyword getKeyword(const std::string& property);
+
     bool isAbsoluteIri(const std::string& value);
 
     bool isRelativeIri(const std::string& value);
 
     bool isList(const json& j);
+    bool isList(const arena_json& j);
 
     bool isValue(const json& j);
+    bool isValue(const arena_json& j);
 
     bool isObject(const json& j);
+    bool isObject(const arena_json& j);
 
     bool deepContains(const json& values, const json& value);
+    bool deepContains(const arena_json& values, const arena_json& value);
 
     void mergeValue(json & obj, const std::string& key, const json& value);
+    void mergeValue(arena_json & obj, const std::string& key, const arena_json& value);
 }
 
 #endif //LIBJSONLD_CPP_JSONLDUTILS_H
@@ -0,0 +1,50 @@
+#include "MergeIndex.h"
+#include "JsonLdConsts.h"
+#include "JsonLdUtils.h"
+#include <utility>
+
+void MergeIndex::mergeValue(arena_json & obj, const std::string & key, arena_json value) {
+    if (obj.is_null()) {
+        return;
+    }
+    arena_json & values = obj[key];
+    if (values.is_null()) {
+        values = arena_json::array();
+    }
+    if (key == JsonLdConsts::LIST || value.contains(JsonLdConsts::LIST) || !values.is_array()) {
+        JsonLdUtils::mergeValue(obj, key, value);
+        return;
+    }
+    mergeValue(values, std::move(value));
+}
+
+void MergeIndex::mergeValue(arena_json & values, arena_json value) {
+    if (value.contains(JsonLdConsts::LIST)) {
+        values.push_back(std::move(value));
+        return;
+    }
+
+    Values & entry = index[&values];
+    if (entry.indexed > values.size()) {
+        // the array was replaced
+        entry = Values();
+    }
+    for (; entry.indexed < values.size(); entry.indexed++) {
+        entry.positions.emplace(JsonLdUtils::deepHash(values[entry.indexed]), entry.indexed);
+    }
+
+    size_t hash = JsonLdUtils::deepHash(value);
+    auto range = entry.positions.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (JsonLdUtils::deepCompare(values[it->second], value)) {
+            return;
+        }
+    }
+    entry.positions.emplace(hash, values.size());
+    values.push_back(std::move(value));
+    entry.indexed++;
+}
+
+void MergeIndex::clear() {
+    index.clear();
+}
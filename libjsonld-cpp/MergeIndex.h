@@ -0,0 +1,44 @@
+#ifndef LIBJSONLD_CPP_MERGEINDEX_H
+#define LIBJSONLD_CPP_MERGEINDEX_H
+
+#include "Arena.h"
+#include <string>
+#include <unordered_map>
+
+/**
+ * Does what JsonLdUtils::mergeValue does, but remembers the values of each property it
+ * merges into by their JsonLdUtils::deepHash. Telling whether a value is already there
+ * then takes one probe, and a deepCompare only with the values whose hash is the same,
+ * instead of a deepCompare with every value of the property.
+ *
+ * Values added to an array behind the index's back are indexed the next time it merges
+ * into that array. The arrays themselves are known by their address, so none of them
+ * may be destroyed while the index is in use.
+ */
+class MergeIndex {
+private:
+    struct Values {
+        // values [0, indexed) of the array are in positions, by hash
+        size_t indexed = 0;
+        std::unordered_multimap<size_t, size_t> positions;
+    };
+
+    std::unordered_map<const arena_json *, Values> index;
+
+public:
+    /**
+     * Adds value to the array at obj[key], unless the array already holds a value that
+     * deepCompare finds equal. Values of @list, and list objects, are always added.
+     */
+    void mergeValue(arena_json & obj, const std::string & key, arena_json value);
+
+    /**
+     * Adds value to the values of a property, which must be an array, unless they already
+     * hold a value that deepCompare finds equal. List objects are always added.
+     */
+    void mergeValue(arena_json & values, arena_json value);
+
+    void clear();
+};
+
+#endif //LIBJSONLD_CPP_MERGEINDEX_H
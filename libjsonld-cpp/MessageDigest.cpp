@@ -0,0 +1,39 @@
+#include "MessageDigest.h"
+#include "sha1.h"
+#include "sha256.h"
+
+const char MessageDigest::SHA_1[] = "SHA-1";
+const char MessageDigest::SHA_256[] = "SHA-256";
+
+std::string MessageDigest::digest() {
+    unsigned char bytes[64];
+    size_t size = digestSize();
+    digestTo(bytes);
+    return toHex(bytes, size);
+}
+
+void MessageDigest::digestEach(const std::string *messages, size_t count, std::string *hexDigests) {
+    reset();
+    for (size_t i = 0; i < count; i++) {
+        update(messages[i]);
+        hexDigests[i] = digest();
+    }
+}
+
+std::unique_ptr<MessageDigest> MessageDigest::getInstance(const std::string &algorithm) {
+    if (algorithm == SHA_1)
+        return std::unique_ptr<MessageDigest>(new SHA1());
+    if (algorithm == SHA_256)
+        return std::unique_ptr<MessageDigest>(new SHA256());
+    return nullptr;
+}
+
+std::string MessageDigest::toHex(const unsigned char *bytes, size_t size) {
+    static const char hex[] = "0123456789abcdef";
+    std::string result(size * 2, '0');
+    for (size_t i = 0; i < size; i++) {
+        result[2 * i] = hex[bytes[i] >> 4u];
+        result[2 * i + 1] = hex[bytes[i] & 0xfu];
+    }
+    return result;
+}
@@ -0,0 +1,62 @@
+#ifndef LIBJSONLD_CPP_MESSAGEDIGEST_H
+#define LIBJSONLD_CPP_MESSAGEDIGEST_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+/**
+ * An incremental hash function, in the spirit of Java's MessageDigest. Input is hashed as
+ * raw bytes, and the digest is produced in binary; hex encoding only happens in digest().
+ *
+ * SHA1 and SHA256 are the implementations, and getInstance() picks one by name, so
+ * canonicalization can take the hash algorithm as a parameter.
+ */
+class MessageDigest {
+public:
+    static const char SHA_1[];
+    static const char SHA_256[];
+
+    virtual ~MessageDigest() = default;
+
+    virtual void update(const char *data, size_t size) = 0;
+
+    void update(const std::string &s) {
+        update(s.data(), s.size());
+    }
+
+    /**
+     * @return the number of bytes digestTo() writes
+     */
+    virtual size_t digestSize() const = 0;
+
+    /**
+     * Writes the binary digest of everything hashed so far to out, and resets the
+     * digest so it can be reused.
+     */
+    virtual void digestTo(unsigned char *out) = 0;
+
+    virtual void reset() = 0;
+
+    /**
+     * @return the hex encoded digest of everything hashed so far. Resets the digest
+     */
+    std::string digest();
+
+    /**
+     * Hashes each of count messages on its own, writing their hex encoded digests to
+     * hexDigests. Implementations may hash several messages at once, so prefer this to a
+     * loop when there are many short messages. Resets the digest.
+     */
+    virtual void digestEach(const std::string *messages, size_t count, std::string *hexDigests);
+
+    /**
+     * @return a new digest for algorithm, SHA_1 or SHA_256, using any hardware
+     * acceleration available, or nullptr if the algorithm is unknown
+     */
+    static std::unique_ptr<MessageDigest> getInstance(const std::string &algorithm);
+
+    static std::string toHex(const unsigned char *bytes, size_t size);
+};
+
+#endif //LIBJSONLD_CPP_MESSAGEDIGEST_H
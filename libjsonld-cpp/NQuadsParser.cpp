@@ -0,0 +1,323 @@
+#include "NQuadsParser.h"
+#include "JsonLdError.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace RDF {
+
+    namespace {
+
+        /**
+         * A read-only memory mapping of a whole file.
+         */
+        class MappedFile {
+        private:
+            void * data = nullptr;
+            size_t size = 0;
+
+        public:
+            explicit MappedFile(const std::string & path) {
+                int fd = ::open(path.c_str(), O_RDONLY);
+                if (fd < 0)
+                    throw JsonLdError(JsonLdError::LoadingDocumentFailed, path + ": " + std::strerror(errno));
+                struct stat st;
+                if (::fstat(fd, &st) < 0) {
+                    int error = errno;
+                    ::close(fd);
+                    throw JsonLdError(JsonLdError::LoadingDocumentFailed, path + ": " + std::strerror(error));
+                }
+                size = static_cast<size_t>(st.st_size);
+                if (size > 0) {
+                    data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (data == MAP_FAILED) {
+                        int error = errno;
+                        ::close(fd);
+                        throw JsonLdError(JsonLdError::LoadingDocumentFailed, path + ": " + std::strerror(error));
+                    }
+                    ::madvise(data, size, MADV_SEQUENTIAL);
+                }
+                ::close(fd);
+            }
+
+            ~MappedFile() {
+                if (data != nullptr)
+                    ::munmap(data, size);
+            }
+
+            MappedFile(const MappedFile &) = delete;
+            MappedFile & operator=(const MappedFile &) = delete;
+
+            const char * begin() const { return static_cast<const char *>(data); }
+            size_t getSize() const { return size; }
+        };
+
+        inline const char * skipWhitespace(const char * p, const char * end) {
+            while (p != end && (*p == ' ' || *p == '\t'))
+                ++p;
+            return p;
+        }
+
+        inline bool isBlankNodeEnd(char c) {
+            return c == ' ' || c == '\t' || c == '<' || c == '"' || c == '#';
+        }
+
+        inline bool isLanguageChar(char c) {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-';
+        }
+
+        int hexValue(char c) {
+            if (c >= '0' && c <= '9')
+                return c - '0';
+            if (c >= 'a' && c <= 'f')
+                return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F')
+                return c - 'A' + 10;
+            return -1;
+        }
+
+        void appendUtf8(uint32_t codePoint, std::string & out) {
+            if (codePoint < 0x80) {
+                out += static_cast<char>(codePoint);
+            } else if (codePoint < 0x800) {
+                out += static_cast<char>(0xC0 | (codePoint >> 6));
+                out += static_cast<char>(0x80 | (codePoint & 0x3F));
+            } else if (codePoint < 0x10000) {
+                out += static_cast<char>(0xE0 | (codePoint >> 12));
+                out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (codePoint & 0x3F));
+            } else {
+                out += static_cast<char>(0xF0 | (codePoint >> 18));
+                out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+        }
+
+    }
+
+    NQuadsParser::NQuadsParser(RDFDataset & idataset)
+            : dataset(idataset), dictionary(*idataset.getTermDictionary()), lineNumber(0) {
+        xsdString = dictionary.intern(JsonLdConsts::XSD_STRING);
+        rdfLangString = dictionary.intern(JsonLdConsts::RDF_LANGSTRING);
+        std::fill(recent, recent + POSITIONS, TermDictionary::NOT_FOUND);
+    }
+
+    void NQuadsParser::parse(const char * data, size_t size) {
+        const char * p = data;
+        const char * end = data + size;
+        lineNumber = 0;
+        try {
+            while (p != end) {
+                auto newline = static_cast<const char *>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+                const char * lineEnd = newline != nullptr ? newline : end;
+                ++lineNumber;
+                parseLine(p, lineEnd != p && lineEnd[-1] == '\r' ? lineEnd - 1 : lineEnd);
+                p = newline != nullptr ? newline + 1 : end;
+            }
+        } catch (...) {
+            // leave the dataset as it was
+            dataset.dropAppended();
+            throw;
+        }
+        dataset.insertAppended();
+    }
+
+    void NQuadsParser::parse(const std::string & nquads) {
+        parse(nquads.data(), nquads.size());
+    }
+
+    void NQuadsParser::parseFile(const std::string & path) {
+        MappedFile file(path);
+        parse(file.begin(), file.getSize());
+    }
+
+    void NQuadsParser::parseLine(const char * p, const char * end) {
+        p = skipWhitespace(p, end);
+        // empty line or comment
+        if (p == end || *p == '#')
+            return;
+
+        Term subject;
+        p = parseSubjectOrGraph(p, end, subject, SUBJECT);
+
+        Term predicate;
+        p = skipWhitespace(p, end);
+        if (p == end || *p != '<')
+            fail("expected a predicate IRI");
+        p = parseIri(p, end, predicate, PREDICATE);
+
+        Term object;
+        p = skipWhitespace(p, end);
+        if (p == end)
+            fail("expected an object");
+        if (*p == '<')
+            p = parseIri(p, end, object, OBJECT);
+        else if (*p == '_')
+            p = parseBlankNode(p, end, object, OBJECT);
+        else if (*p == '"')
+            p = parseLiteral(p, end, object);
+        else
+            fail("expected an object");
+
+        Term graph = Term::defaultGraph();
+        p = skipWhitespace(p, end);
+        if (p != end && *p != '.') {
+            p = parseSubjectOrGraph(p, end, graph, GRAPH);
+            p = skipWhitespace(p, end);
+        }
+
+        if (p == end || *p != '.')
+            fail("expected '.'");
+        p = skipWhitespace(p + 1, end);
+        if (p != end && *p != '#')
+            fail("unexpected characters after '.'");
+
+        dataset.appendQuad(subject, predicate, object, graph);
+    }
+
+    const char * NQuadsParser::parseSubjectOrGraph(const char * p, const char * end, Term & term,
+                                                     Position position) {
+        if (*p == '<')
+            return parseIri(p, end, term, position);
+        if (*p == '_')
+            return parseBlankNode(p, end, term, position);
+        fail("expected an IRI or a blank node");
+    }
+
+    const char * NQuadsParser::parseIri(const char * p, const char * end, Term & term, Position position) {
+        ++p;
+        auto close = static_cast<const char *>(std::memchr(p, '>', static_cast<size_t>(end - p)));
+        if (close == nullptr)
+            fail("unterminated IRI");
+        auto size = static_cast<size_t>(close - p);
+        term.kind = Term::Kind::IRI;
+        term.value = intern(p, size, std::memchr(p, '\\', size) != nullptr, position);
+        return close + 1;
+    }
+
+    const char * NQuadsParser::parseBlankNode(const char * p, const char * end, Term & term, Position position) {
+        if (end - p < 3 || p[1] != ':')
+            fail("invalid blank node label");
+        const char * labelEnd = p + 2;
+        while (labelEnd != end && !isBlankNodeEnd(*labelEnd))
+            ++labelEnd;
+        // a label can contain '.' but not end with one
+        while (labelEnd[-1] == '.')
+            --labelEnd;
+        if (labelEnd == p + 2)
+            fail("invalid blank node label");
+        term.kind = Term::Kind::BlankNode;
+        term.value = intern(p, static_cast<size_t>(labelEnd - p), false, position);
+        return labelEnd;
+    }
+
+    const char * NQuadsParser::parseLiteral(const char * p, const char * end, Term & term) {
+        const char * start = p + 1;
+        const char * close = start;
+        while (true) {
+            close = static_cast<const char *>(std::memchr(close, '"', static_cast<size_t>(end - close)));
+            if (close == nullptr)
+                fail("unterminated literal");
+            // the quote is escaped if it follows an odd number of backslashes
+            const char * b = close;
+            while (b != start && b[-1] == '\\')
+                --b;
+            if ((close - b) % 2 == 0)
+                break;
+            ++close;
+        }
+        auto size = static_cast<size_t>(close - start);
+        term.kind = Term::Kind::Literal;
+        term.value = intern(start, size, std::memchr(start, '\\', size) != nullptr, OBJECT);
+        term.datatype = xsdString;
+        term.language = TermDictionary::EMPTY;
+
+        p = close + 1;
+        if (end - p >= 2 && p[0] == '^' && p[1] == '^') {
+            p += 2;
+            if (p == end || *p != '<')
+                fail("expected a datatype IRI");
+            Term datatype;
+            p = parseIri(p, end, datatype, DATATYPE);
+            term.datatype = datatype.value;
+        } else if (p != end && *p == '@') {
+            const char * language = ++p;
+            while (p != end && isLanguageChar(*p))
+                ++p;
+            if (p == language)
+                fail("invalid language tag");
+            term.datatype = rdfLangString;
+            term.language = intern(language, static_cast<size_t>(p - language), false, LANGUAGE);
+        }
+        return p;
+    }
+
+    TermId NQuadsParser::intern(const char * data, size_t size, bool hasEscapes, Position position) {
+        TermId & last = recent[position];
+        if (!hasEscapes) {
+            if (last != TermDictionary::NOT_FOUND) {
+                const std::string & lastString = dictionary.get(last);
+                if (lastString.size() == size && std::memcmp(lastString.data(), data, size) == 0)
+                    return last;
+            }
+            return last = dictionary.intern(data, size);
+        }
+
+        unescaped.clear();
+        const char * p = data;
+        const char * end = data + size;
+        while (p != end) {
+            auto backslash = static_cast<const char *>(std::memchr(p, '\\', static_cast<size_t>(end - p)));
+            if (backslash == nullptr) {
+                unescaped.append(p, static_cast<size_t>(end - p));
+                break;
+            }
+            unescaped.append(p, static_cast<size_t>(backslash - p));
+            p = backslash + 1;
+            if (p == end)
+                fail("invalid escape sequence");
+            char c = *p++;
+            switch (c) {
+                case 't': unescaped += '\t'; break;
+                case 'b': unescaped += '\b'; break;
+                case 'n': unescaped += '\n'; break;
+                case 'r': unescaped += '\r'; break;
+                case 'f': unescaped += '\f'; break;
+                case '"': unescaped += '"'; break;
+                case '\'': unescaped += '\''; break;
+                case '\\': unescaped += '\\'; break;
+                case 'u':
+                case 'U': {
+                    int digits = c == 'u' ? 4 : 8;
+                    if (end - p < digits)
+                        fail("invalid escape sequence");
+                    uint32_t codePoint = 0;
+                    for (int i = 0; i < digits; i++) {
+                        int v = hexValue(*p++);
+                        if (v < 0)
+                            fail("invalid escape sequence");
+                        codePoint = (codePoint << 4) | static_cast<uint32_t>(v);
+                    }
+                    if (codePoint > 0x10FFFF)
+                        fail("invalid escape sequence");
+                    appendUtf8(codePoint, unescaped);
+                    break;
+                }
+                default:
+                    fail("invalid escape sequence");
+            }
+        }
+        return last = dictionary.intern(unescaped);
+    }
+
+    void NQuadsParser::fail(const std::string & message) const {
+        throw JsonLdError(JsonLdError::SyntaxError, "line " + std::to_string(lineNumber) + ": " + message);
+    }
+
+}
@@ -0,0 +1,71 @@
+#ifndef LIBJSONLD_CPP_NQUADSPARSER_H
+#define LIBJSONLD_CPP_NQUADSPARSER_H
+
+#include "RDFDataset.h"
+#include <string>
+
+namespace RDF {
+
+    /**
+     * Reads N-Quads into an RDFDataset.
+     *
+     * The input is tokenized in place: terms are interned in the dataset's
+     * TermDictionary straight from the input bytes, and only terms that contain
+     * escape sequences are unescaped, into a buffer that is reused for the whole input.
+     * A term is only ever copied when it is seen for the first time.
+     *
+     * The quads are appended straight to the dataset's quad store, and each call to a
+     * parse function then adds the quads it read to their graphs, see
+     * RDFDataset::insertAppended(). So input may be parsed in several chunks, each of
+     * whole lines. Errors are reported as a JsonLdError::SyntaxError naming the line,
+     * and leave the dataset as it was.
+     */
+    class NQuadsParser {
+    private:
+        RDFDataset & dataset;
+        TermDictionary & dictionary;
+
+        TermId xsdString;
+        TermId rdfLangString;
+
+        // the last term read at each position of a quad. Consecutive quads often share
+        // their subject, predicate or graph, which then need not be looked up
+        enum Position { SUBJECT, PREDICATE, OBJECT, GRAPH, DATATYPE, LANGUAGE, POSITIONS };
+        TermId recent[POSITIONS];
+
+        // holds the unescaped form of the current term when it has escape sequences
+        std::string unescaped;
+
+        size_t lineNumber;
+
+        void parseLine(const char * p, const char * end);
+        const char * parseIri(const char * p, const char * end, Term & term, Position position);
+        const char * parseBlankNode(const char * p, const char * end, Term & term, Position position);
+        const char * parseLiteral(const char * p, const char * end, Term & term);
+        const char * parseSubjectOrGraph(const char * p, const char * end, Term & term, Position position);
+        TermId intern(const char * data, size_t size, bool hasEscapes, Position position);
+
+        [[noreturn]] void fail(const std::string & message) const;
+
+    public:
+        explicit NQuadsParser(RDFDataset & idataset);
+
+        NQuadsParser(const NQuadsParser &) = delete;
+        NQuadsParser & operator=(const NQuadsParser &) = delete;
+
+        /**
+         * Parses size bytes of N-Quads at data, which need not be null terminated.
+         */
+        void parse(const char * data, size_t size);
+
+        void parse(const std::string & nquads);
+
+        /**
+         * Parses an N-Quads file, which is memory mapped rather than read.
+         */
+        void parseFile(const std::string & path);
+    };
+
+}
+
+#endif //LIBJSONLD_CPP_NQUADSPARSER_H
@@ -0,0 +1,91 @@
+#include "NQuadsWriter.h"
+#include "RDFDatasetUtils.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include <unistd.h>
+
+namespace RDF {
+
+    constexpr size_t NQuadsWriter::DEFAULT_BUFFER_SIZE;
+
+    NQuadsWriter::NQuadsWriter(Sink isink, Order iorder, size_t ibufferSize)
+            : sink(std::move(isink)), order(iorder), bufferSize(ibufferSize) {
+        buffer.reserve(bufferSize);
+    }
+
+    NQuadsWriter::NQuadsWriter(std::ostream & out, Order iorder, size_t ibufferSize)
+            : NQuadsWriter([&out](const char * data, size_t size) {
+                  out.write(data, static_cast<std::streamsize>(size));
+              }, iorder, ibufferSize) {
+    }
+
+    NQuadsWriter::Sink NQuadsWriter::fileDescriptorSink(int fd) {
+        return [fd](const char * data, size_t size) {
+            while (size > 0) {
+                ssize_t written = ::write(fd, data, size);
+                if (written < 0) {
+                    if (errno == EINTR)
+                        continue;
+                    throw std::runtime_error(std::string("Error: write failed: ") + std::strerror(errno));
+                }
+                data += written;
+                size -= static_cast<size_t>(written);
+            }
+        };
+    }
+
+    void NQuadsWriter::write(const RDFDataset & dataset) {
+        size_t quadCount = dataset.getQuadStore().size();
+
+        if (order == Order::Unsorted) {
+            for (size_t i = 0; i < quadCount; i++) {
+                RDFDatasetUtils::appendNQuad(dataset, i, buffer);
+                if (buffer.size() >= bufferSize)
+                    flush();
+            }
+            flush();
+            return;
+        }
+
+        // every line is serialized once into lines; only the (offset, length) pairs
+        // that refer to them are sorted
+        std::string lines;
+        std::vector<std::pair<size_t, size_t>> index;
+        index.reserve(quadCount);
+        for (size_t i = 0; i < quadCount; i++) {
+            size_t offset = lines.size();
+            RDFDatasetUtils::appendNQuad(dataset, i, lines);
+            index.emplace_back(offset, lines.size() - offset);
+        }
+
+        const char * data = lines.data();
+        std::sort(index.begin(), index.end(),
+                  [data](const std::pair<size_t, size_t> & a, const std::pair<size_t, size_t> & b) {
+                      // same order as std::string::compare
+                      int c = std::memcmp(data + a.first, data + b.first, std::min(a.second, b.second));
+                      return c != 0 ? c < 0 : a.second < b.second;
+                  });
+
+        for (const auto & line : index)
+            append(data + line.first, line.second);
+        flush();
+    }
+
+    void NQuadsWriter::append(const char * data, size_t size) {
+        buffer.append(data, size);
+        if (buffer.size() >= bufferSize)
+            flush();
+    }
+
+    void NQuadsWriter::flush() {
+        if (buffer.empty())
+            return;
+        sink(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+
+}
@@ -0,0 +1,61 @@
+#ifndef LIBJSONLD_CPP_NQUADSWRITER_H
+#define LIBJSONLD_CPP_NQUADSWRITER_H
+
+#include "RDFDataset.h"
+#include <functional>
+#include <ostream>
+#include <string>
+
+namespace RDF {
+
+    /**
+     * Serializes datasets in N-Quads format straight into a sink.
+     *
+     * Quads are written into a reusable buffer which is handed to the sink whenever it
+     * holds bufferSize bytes, so unsorted output never holds more than a buffer of
+     * N-Quads in memory. Sorted output serializes every quad once into a single buffer
+     * and sorts references to the lines, rather than the lines themselves.
+     */
+    class NQuadsWriter {
+    public:
+        /**
+         * Receives the bytes of the output, in order. The data is only valid for the
+         * duration of the call.
+         */
+        typedef std::function<void(const char * data, size_t size)> Sink;
+
+        enum class Order { Sorted, Unsorted };
+
+        static constexpr size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+    private:
+        Sink sink;
+        Order order;
+        size_t bufferSize;
+        std::string buffer;
+
+        void append(const char * data, size_t size);
+
+    public:
+        explicit NQuadsWriter(Sink isink, Order iorder = Order::Sorted, size_t ibufferSize = DEFAULT_BUFFER_SIZE);
+        explicit NQuadsWriter(std::ostream & out, Order iorder = Order::Sorted, size_t ibufferSize = DEFAULT_BUFFER_SIZE);
+
+        /**
+         * @return a sink writing to the file descriptor fd, which it does not close
+         */
+        static Sink fileDescriptorSink(int fd);
+
+        /**
+         * Writes all the quads of the dataset, then flushes the buffer.
+         */
+        void write(const RDFDataset & dataset);
+
+        /**
+         * Hands the buffered bytes to the sink.
+         */
+        void flush();
+    };
+
+}
+
+#endif //LIBJSONLD_CPP_NQUADSWRITER_H
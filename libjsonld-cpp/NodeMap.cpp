@@ -0,0 +1,71 @@
+#include "NodeMap.h"
+#include <algorithm>
+
+namespace RDF {
+
+    NodeMap::NodeMap(TermDictionary & idictionary)
+            : dictionary(idictionary) {
+    }
+
+    NodeMap::Graph & NodeMap::getGraph(const std::string & name) {
+        TermId id = dictionary.intern(name);
+        auto it = graphsByName.find(id);
+        if (it != graphsByName.end())
+            return *it->second;
+        graphs.emplace_back();
+        Graph & graph = graphs.back();
+        graph.name = id;
+        graphsByName[id] = &graph;
+        return graph;
+    }
+
+    std::vector<const NodeMap::Graph *> NodeMap::getGraphs() const {
+        std::vector<const Graph *> result;
+        result.reserve(graphs.size());
+        for (const auto & graph : graphs)
+            result.push_back(&graph);
+        const TermDictionary & d = dictionary;
+        std::sort(result.begin(), result.end(), [&d](const Graph * lhs, const Graph * rhs) {
+            return d.get(lhs->name) < d.get(rhs->name);
+        });
+        return result;
+    }
+
+    NodeMap::Node * NodeMap::findNode(Graph & graph, const std::string & id) const {
+        TermId termId = dictionary.find(id);
+        if (termId == TermDictionary::NOT_FOUND)
+            return nullptr;
+        auto it = graph.nodesById.find(termId);
+        return it != graph.nodesById.end() ? it->second : nullptr;
+    }
+
+    NodeMap::Node & NodeMap::getNode(Graph & graph, const std::string & id) {
+        TermId termId = dictionary.intern(id);
+        auto it = graph.nodesById.find(termId);
+        if (it != graph.nodesById.end())
+            return *it->second;
+        nodes.emplace_back();
+        Node & node = nodes.back();
+        node.id = termId;
+        graph.nodes.push_back(&node);
+        graph.nodesById[termId] = &node;
+        return node;
+    }
+
+    arena_json & NodeMap::getValues(Node & node, const std::string & property) {
+        TermId name = dictionary.intern(property);
+        const TermDictionary & d = dictionary;
+        auto it = std::lower_bound(node.properties.begin(), node.properties.end(), property,
+                                   [&d](const Property * p, const std::string & value) {
+            return d.get(p->name) < value;
+        });
+        if (it != node.properties.end() && (*it)->name == name)
+            return (*it)->values;
+        properties.emplace_back();
+        Property & p = properties.back();
+        p.name = name;
+        node.properties.insert(it, &p);
+        return p.values;
+    }
+
+}
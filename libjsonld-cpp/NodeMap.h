@@ -0,0 +1,96 @@
+#ifndef LIBJSONLD_CPP_NODEMAP_H
+#define LIBJSONLD_CPP_NODEMAP_H
+
+#include "Arena.h"
+#include "TermDictionary.h"
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace RDF {
+
+    /**
+     * The node map built by the Node Map Generation algorithm:
+     *
+     * http://json-ld.org/spec/latest/json-ld-api/#node-map-generation
+     *
+     * Graph names, node ids and property names are interned in a TermDictionary, which
+     * should be the one of the dataset the node map is turned into, so that the ids can
+     * be used as they are in its terms. The nodes of each graph are kept in the order
+     * they were added, and the properties of each node in order of their names, as
+     * RDF is generated from them. The values of a property
+     * are a json array of node references, value objects and list objects.
+     *
+     * Graphs, nodes and property values are never moved, so references to them stay
+     * valid for the lifetime of the node map. Values allocated from an arena must be
+     * destroyed, with the node map, before the arena is.
+     */
+    class NodeMap {
+    public:
+        struct Property {
+            TermId name;
+            arena_json values = arena_json::array();
+        };
+
+        struct Node {
+            TermId id;
+            // in order of their names
+            std::vector<Property *> properties;
+            // null if the node has no @index
+            arena_json index;
+        };
+
+        struct Graph {
+            TermId name;
+            // in the order they were added
+            std::vector<Node *> nodes;
+            std::unordered_map<TermId, Node *> nodesById;
+        };
+
+    private:
+        TermDictionary & dictionary;
+        std::deque<Graph> graphs;
+        std::unordered_map<TermId, Graph *> graphsByName;
+        std::deque<Node> nodes;
+        std::deque<Property> properties;
+
+    public:
+        explicit NodeMap(TermDictionary & idictionary);
+
+        NodeMap(const NodeMap &) = delete;
+        NodeMap & operator=(const NodeMap &) = delete;
+
+        TermDictionary & getTermDictionary() const { return dictionary; }
+
+        /**
+         * Returns the graph with the given name, adding it if there is none.
+         */
+        Graph & getGraph(const std::string & name);
+
+        /**
+         * Returns the graphs in order of their names, as the graphs of a json node map
+         * are iterated in.
+         */
+        std::vector<const Graph *> getGraphs() const;
+
+        /**
+         * Returns the node of the graph with the given id, or nullptr if there is none.
+         */
+        Node * findNode(Graph & graph, const std::string & id) const;
+
+        /**
+         * Returns the node of the graph with the given id, adding it if there is none.
+         */
+        Node & getNode(Graph & graph, const std::string & id);
+
+        /**
+         * Returns the values of a property of a node, adding the property with no values
+         * if the node does not have it.
+         */
+        arena_json & getValues(Node & node, const std::string & property);
+    };
+
+}
+
+#endif //LIBJSONLD_CPP_NODEMAP_H
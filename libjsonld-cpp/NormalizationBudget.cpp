@@ -0,0 +1,25 @@
+#include "NormalizationBudget.h"
+#include "JsonLdError.h"
+
+NormalizationBudget::NormalizationBudget(const JsonLdOptions & options)
+        : maxPermutations(options.getMaxNormalizationPermutations()),
+          maxDepth(options.getMaxNormalizationDepth()),
+          maxHashes(options.getMaxNormalizationHashes()),
+          permutations(0),
+          hashes(0) {
+}
+
+void NormalizationBudget::countPermutation() {
+    if (maxPermutations != 0 && ++permutations > maxPermutations)
+        throw JsonLdError(JsonLdError::NormalizationBudgetExceeded,
+                          "more than " + std::to_string(maxPermutations) + " permutations");
+}
+
+void NormalizationBudget::countHash(size_t depth) {
+    if (maxDepth != 0 && depth > maxDepth)
+        throw JsonLdError(JsonLdError::NormalizationBudgetExceeded,
+                          "recursion deeper than " + std::to_string(maxDepth));
+    if (maxHashes != 0 && ++hashes > maxHashes)
+        throw JsonLdError(JsonLdError::NormalizationBudgetExceeded,
+                          "more than " + std::to_string(maxHashes) + " hashes");
+}
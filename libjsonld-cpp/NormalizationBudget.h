@@ -0,0 +1,44 @@
+#ifndef LIBJSONLD_CPP_NORMALIZATIONBUDGET_H
+#define LIBJSONLD_CPP_NORMALIZATIONBUDGET_H
+
+#include "JsonLdOptions.h"
+#include <atomic>
+#include <cstddef>
+
+/**
+ * Counts the work a normalize() call does to tell apart blank nodes that share a first
+ * degree hash, against the limits in JsonLdOptions. A very symmetric graph, like a
+ * clique of identical blank nodes, takes factorial time to canonicalize, so documents
+ * from untrusted sources should fail instead of keeping a thread busy for minutes.
+ *
+ * The counts are shared by all the threads of the call.
+ */
+class NormalizationBudget {
+private:
+    size_t maxPermutations;
+    size_t maxDepth;
+    size_t maxHashes;
+    std::atomic<size_t> permutations;
+    std::atomic<size_t> hashes;
+
+public:
+    explicit NormalizationBudget(const JsonLdOptions & options);
+
+    NormalizationBudget(const NormalizationBudget &) = delete;
+    NormalizationBudget & operator=(const NormalizationBudget &) = delete;
+
+    /**
+     * Counts one permutation of blank nodes tried while choosing a path.
+     * @throws JsonLdError NormalizationBudgetExceeded if there have been too many
+     */
+    void countPermutation();
+
+    /**
+     * Counts one N-degree hash of a blank node, computed depth recursions deep.
+     * @throws JsonLdError NormalizationBudgetExceeded if there have been too many, or
+     * the recursion is too deep
+     */
+    void countHash(size_t depth);
+};
+
+#endif //LIBJSONLD_CPP_NORMALIZATIONBUDGET_H
@@ -1,30 +1,69 @@
 #include "NormalizeUtils.h"
-#include "RDFDatasetUtils.h"
-#include "sha1.h"
 #include "Permutator.h"
+#include "ParallelUtils.h"
+#include <algorithm>
 #include <utility>
 
 using nlohmann::json;
 
 
 NormalizeUtils::NormalizeUtils(
-        std::vector<RDF::Quad> iquads,
-        std::map<std::string, std::map<std::string, std::vector<RDF::Quad>>> ibnodes,
+        const RDF::RDFDataset & idataset,
         UniqueNamer iuniqueNamer,
-        JsonLdOptions iopts)
-        : quads(std::move(iquads)),
-          bnodes(std::move(ibnodes)),
+        JsonLdOptions iopts,
+        std::string ihashAlgorithm)
+        : dataset(idataset),
+          quads(idataset.getQuadStore()),
+          dictionary(*idataset.getTermDictionary()),
+          // the original implementation lists a quad once for each time a blank node
+          // appears in it, and that changes the hashes
+          index(idataset, RDF::BlankNodeIndex::Occurrences::EveryOccurrence),
+          serializer(idataset),
+          cachedHashes(index.size()),
           uniqueNamer(std::move(iuniqueNamer)),
-          opts(std::move(iopts))
+          opts(std::move(iopts)),
+          hashAlgorithm(std::move(ihashAlgorithm)),
+          budget(opts),
+          quadDigest(MessageDigest::getInstance(hashAlgorithm))
 {}
 
+const std::string & NormalizeUtils::label(NodeId id) const {
+    return dictionary.get(index.getLabel(id));
+}
+
+NormalizeUtils::NodeId NormalizeUtils::nodeOf(const std::string & label) const {
+    return index.find(dictionary.find(label));
+}
+
+namespace {
+
+    // how hashQuads() writes the blank nodes of the quads it hashes
+    const std::string REFERENCE_LABEL = "_:a";
+    const std::string OTHER_LABEL = "_:z";
+    const std::string GRAPH_LABEL = "_:g";
+
+    // whether a path that starts with path compares greater than chosenPath whatever
+    // follows, so can no longer be chosen over it
+    bool cannotBeChosen(const std::string & path, const std::string * chosenPath) {
+        return chosenPath != nullptr && path.compare(0, path.size(), *chosenPath, 0, path.size()) > 0;
+    }
+
+}
+
 
 // for all unnamed blank node ids, generate unique names for them
-std::string NormalizeUtils::hashBlankNodes(const std::vector<std::string> & unnamed_) {
-    std::vector<std::string> unnamed = unnamed_;
-    std::vector<std::string> nextUnnamed;
-    std::map<std::string, std::vector<std::string>> duplicates;
-    std::map<std::string, std::string> unique;
+std::string NormalizeUtils::hashBlankNodes() {
+    // the hash of a blank node's quads does not depend on any name given out, so they
+    // can all be computed up front, at the same time
+    if (ParallelUtils::threadCount(opts.getNormalizationThreads()) > 1)
+        hashQuadsInParallel();
+
+    std::vector<NodeId> unnamed(index.size());
+    for (size_t i = 0; i < unnamed.size(); i++)
+        unnamed[i] = static_cast<NodeId>(i);
+    std::vector<NodeId> nextUnnamed;
+    std::map<std::string, std::vector<NodeId>> duplicates;
+    std::map<std::string, NodeId> unique;
 
     // rather than initialize hui to 0, which would make sense, we are going to initialize to 1
     // and refer to hui as (hui-1) in most instances. This allows us to declare hui a size_t rather
@@ -43,8 +82,7 @@ std::string NormalizeUtils::hashBlankNodes(const std::vector<std::string> & unna
                 std::sort(hashes.begin(), hashes.end());
 
                 for (const auto & hash : hashes) {
-                    std::string bnode = unique.at(hash);
-                    uniqueNamer.get(bnode);
+                    uniqueNamer.get(label(unique.at(hash)));
                     named = true;
                 }
 
@@ -78,7 +116,6 @@ std::string NormalizeUtils::hashBlankNodes(const std::vector<std::string> & unna
                     for (size_t pgi = 0;; pgi++) {
                         if (pgi == hashes.size()) {
                             // done, create JSON-LD array
-                            std::vector<std::string> normalized;
 
                             // Note: At this point all bnodes in the set of RDF
                             // quads have been
@@ -88,59 +125,29 @@ std::string NormalizeUtils::hashBlankNodes(const std::vector<std::string> & unna
                             // its bnodes its new name
                             // via the 'uniqueNamer' object.
 
-                            // update bnode names in each quad and serialize
-                            for (const auto& quad : quads) {
-                                // todo: replace this with an iteration over function pointers
-                                auto n = quad.getSubject();
-                                if(n != nullptr) {
-                                    if(n->isBlankNode()) {
-                                        std::string id = n->getValue();
-                                        if(id.find("_:c14n") != 0){
-                                            n->setValue(uniqueNamer.get(id));
-                                        }
-                                    }
-                                }
-                                n = quad.getObject();
-                                if(n != nullptr) {
-                                    if(n->isBlankNode()) {
-                                        std::string id = n->getValue();
-                                        if(id.find("_:c14n") != 0){
-                                            n->setValue(uniqueNamer.get(id));
-                                        }
-                                    }
-                                }
-                                n = quad.getGraph();
-                                if(n != nullptr) {
-                                    if(n->isBlankNode()) {
-                                        std::string id = n->getValue();
-                                        if(id.find("_:c14n") != 0){
-                                            n->setValue(uniqueNamer.get(id));
-                                        }
-                                    }
-                                }
-
-                                n = quad.getGraph();
-                                if(n != nullptr) {
-                                    std::string name;
-                                    name = n->getValue();
-                                    normalized.push_back(RDFDatasetUtils::toNQuad(quad, &name));
-                                }
-                                else {
-                                    normalized.push_back(RDFDatasetUtils::toNQuad(quad, nullptr));
-                                }
+                            // serialize each quad with the new names. Labels
+                            // that look like canonical ones are left alone
+                            std::vector<std::string> names(index.size());
+                            for (size_t i = 0; i < names.size(); i++) {
+                                const std::string & id = label(static_cast<NodeId>(i));
+                                names[i] = id.find("_:c14n") == 0 ? id : uniqueNamer.get(id);
                             }
+                            auto name = [&](RDF::TermId id, bool) -> const std::string & {
+                                return names[index.find(id)];
+                            };
+                            RDF::CanonicalSerializer::Lines normalized;
+                            for (size_t i = 0; i < quads.size(); i++)
+                                serializer.add(i, name, normalized);
 
                             // sort normalized output
-                            std::sort(normalized.begin(), normalized.end());
+                            normalized.sort();
 
                             // handle output format
 //                            if (opts.format != null) {
 //                                if (JsonLdConsts.APPLICATION_NQUADS.equals(options.format)) {
-                                    std::stringstream rval;
-                                    for (const auto & n : normalized) {
-                                        rval << n;
-                                    }
-                                    return rval.str();
+                                    std::string rval;
+                                    normalized.appendTo(rval);
+                                    return rval;
 //                                } else {
 //                                    throw new JsonLdError(JsonLdError.Error.UNKNOWN_FORMAT,
 //                                                          options.format);
@@ -154,35 +161,36 @@ std::string NormalizeUtils::hashBlankNodes(const std::vector<std::string> & unna
                         }
 
                         // name each group member
-                        std::vector<std::string> group = duplicates.at(hashes.at(pgi));
-                        std::vector<HashResult> results;
-                        for (size_t n = 0;; n++) {
-                            if (n == group.size()) {
-                                // name bnodes in hash order
-
-                                std::sort(results.begin(), results.end(),
-                                        [](const HashResult & result1, const HashResult & result2) {
-                                    return result1.hash < result2.hash;
-                                });
-                                for (auto r : results) {
-                                    // name all bnodes in path namer in key-entry order
-                                    for (const auto& key : r.pathNamer.getKeys()) {
-                                        auto s = uniqueNamer.get(key);
-                                    }
-                                }
-                                break;
-                            } else {
-                                // skip already-named bnodes
-                                std::string bnode = group.at(n);
-                                if (uniqueNamer.exists(bnode)) {
-                                    continue;
-                                }
-
-                                // hash bnode paths
-                                UniqueNamer pathNamer;
-                                pathNamer.get(bnode);
-                                HashResult result = hashPaths(bnode, pathNamer);
-                                results.push_back(result);
+                        const std::vector<NodeId> & group = duplicates.at(hashes.at(pgi));
+                        // skip already-named bnodes
+                        std::vector<NodeId> members;
+                        for (NodeId bnode : group) {
+                            if (!uniqueNamer.exists(label(bnode)))
+                                members.push_back(bnode);
+                        }
+
+                        // hash bnode paths. Nothing is named until all members are
+                        // hashed, so they can be hashed at the same time; any threads
+                        // left over go to the permutations inside each member
+                        std::vector<HashResult> results(members.size());
+                        unsigned int threads = ParallelUtils::threadCount(opts.getNormalizationThreads());
+                        unsigned int memberThreads = members.empty() ? 1 :
+                                std::max(1u, threads / static_cast<unsigned int>(members.size()));
+                        ParallelUtils::parallelFor(members.size(), threads, [&](size_t n, unsigned int) {
+                            UniqueNamer pathNamer;
+                            pathNamer.get(label(members[n]));
+                            results[n] = hashPaths(members[n], pathNamer, memberThreads, 0);
+                        });
+
+                        // name bnodes in hash order
+                        std::sort(results.begin(), results.end(),
+                                [](const HashResult & result1, const HashResult & result2) {
+                            return result1.hash < result2.hash;
+                        });
+                        for (auto r : results) {
+                            // name all bnodes in path namer in key-entry order
+                            for (const auto& key : r.pathNamer.getKeys()) {
+                                auto s = uniqueNamer.get(key);
                             }
                         }
                     }
@@ -190,7 +198,7 @@ std::string NormalizeUtils::hashBlankNodes(const std::vector<std::string> & unna
             }
 
             // hash unnamed bnode
-            std::string bnode = unnamed.at(hui-1);
+            NodeId bnode = unnamed.at(hui-1);
             std::string hash = hashQuads(bnode);
 
             // store hash as unique or a duplicate
@@ -198,7 +206,7 @@ std::string NormalizeUtils::hashBlankNodes(const std::vector<std::string> & unna
                 duplicates.at(hash).push_back(bnode);
                 nextUnnamed.push_back(bnode);
             } else if (unique.count(hash)) {
-                std::vector<std::string> tmp;
+                std::vector<NodeId> tmp;
                 tmp.push_back(unique.at(hash));
                 tmp.push_back(bnode);
                 duplicates[hash] = tmp;
@@ -211,14 +219,26 @@ std::string NormalizeUtils::hashBlankNodes(const std::vector<std::string> & unna
         }
 }
 
-NormalizeUtils::HashResult NormalizeUtils::hashPaths(const std::string& id, UniqueNamer pathUniqueNamer) {
+NormalizeUtils::HashResult NormalizeUtils::hashPaths(NodeId id, UniqueNamer pathUniqueNamer,
+                                                     unsigned int threads, size_t depth) {
+    budget.countHash(depth);
 
     std::map<std::string, std::vector<std::string>> groups;
-    std::vector<RDF::Quad> bnode_quads = bnodes.at(id).at("quads");
-    SHA1 md;
+    RDF::BlankNodeIndex::QuadPositions bnode_quads = index.getQuads(id);
+    RDF::TermId idLabel = index.getLabel(id);
+    std::unique_ptr<MessageDigest> md = MessageDigest::getInstance(hashAlgorithm);
+    // the blank nodes next to this one, and what to hash to group them by
+    std::vector<std::string> adjacent;
+    std::vector<std::string> groupInputs;
 
     for (size_t hpi = 0;; hpi++) {
         if (hpi == bnode_quads.size()) {
+            // hash all the group inputs at once
+            std::vector<std::string> adjacentHashes(groupInputs.size());
+            md->digestEach(groupInputs.data(), groupInputs.size(), adjacentHashes.data());
+            for (size_t i = 0; i < adjacent.size(); i++)
+                groups[adjacentHashes[i]].push_back(adjacent[i]);
+
             // done , hash groups
             std::vector<std::string> groupHashes;
             groupHashes.reserve(groups.size()); // todo: need to make a keySet() function...
@@ -231,173 +251,201 @@ NormalizeUtils::HashResult NormalizeUtils::hashPaths(const std::string& id, Uniq
             for (size_t hgi = 0;; hgi++) {
                 if (hgi == groupHashes.size()) {
                     HashResult res;
-                    res.hash = md.digest();
+                    res.hash = md->digest();
                     res.pathNamer = pathUniqueNamer;
                     return res;
                 }
                 // digest group hash
                 std::string groupHash = groupHashes.at(hgi);
-                md.update(groupHash);
+                md->update(groupHash);
 
                 // choose a path and namer from the permutations
-                std::shared_ptr<std::string> chosenPath = nullptr;
+                std::string chosenPath;
                 UniqueNamer chosenNamer;
-                Permutator permutator(groups.at(groupHash));
-
-                while (true) {
-                    bool contPermutation = false;
-                    bool breakOut = false;
-                    std::vector<std::string> permutation = permutator.next();
-                    UniqueNamer pathUniqueNamerCopy = pathUniqueNamer;
-
-                    // build adjacent path
-                    std::string path;
-                    std::vector<std::string> recurse;
-                    for (const auto& bnode : permutation) {
-                        // use canonical name if available
-                        if (uniqueNamer.exists(bnode)) {
-                            path += uniqueNamer.get(bnode);
-                        } else {
-                            // recurse if bnode isn't named in the path yet
-                            if (!pathUniqueNamerCopy.exists(bnode)) {
-                                recurse.push_back(bnode);
-                            }
-                            path += pathUniqueNamerCopy.get(bnode);
+                const std::vector<std::string> & group = groups.at(groupHash);
+                if (threads > 1 && group.size() >= PARALLEL_PERMUTATIONS_MIN_GROUP_SIZE &&
+                    Permutator::count(group.size()) != 0) {
+                    choosePathInParallel(group, pathUniqueNamer, threads, chosenPath, chosenNamer, depth);
+                } else {
+                    bool chosen = false;
+                    Permutator permutator(group);
+                    while (permutator.hasNext()) {
+                        budget.countPermutation();
+                        std::vector<std::string> permutation = permutator.next();
+                        UniqueNamer pathUniqueNamerCopy = pathUniqueNamer;
+                        std::string path;
+                        if (!buildPath(permutation, chosen ? &chosenPath : nullptr, path, pathUniqueNamerCopy, depth))
+                            continue;
+                        if (!chosen || path < chosenPath) {
+                            chosenPath = path;
+                            chosenNamer = pathUniqueNamerCopy;
+                            chosen = true;
                         }
-
-                        // skip permutation if path is already >= chosen path
-                        if (chosenPath != nullptr && path.length() >= chosenPath->length() && path > *chosenPath) {
-                            if(permutator.hasNext()) {
-                                contPermutation = true;
-                            } else {
-                                // digest chosen path and update namer
-                                md.update(*chosenPath);
-                                pathUniqueNamer = chosenNamer;
-                                // hash the nextGroup
-                                breakOut = true;
-                            }
-                            break;
-                        }
-                    }
-
-                    // if we should do the next permutation
-                    if (contPermutation) {
-                        continue;
-                    }
-                    // if we should stop processing this group
-                    if (breakOut) {
-                        break;
-                    }
-
-                    // does the next recursion
-                    for (size_t nrn = 0;; nrn++) {
-                        if (nrn == recurse.size()) {
-                            if (chosenPath == nullptr || path < *chosenPath) {
-                                chosenPath = std::make_shared<std::string>(path);
-                                chosenNamer = pathUniqueNamerCopy;
-                            }
-                            if (!permutator.hasNext()) {
-                                // digest chosen path and update namer
-                                md.update(*chosenPath);
-                                pathUniqueNamer = chosenNamer;
-                                // hash the nextGroup
-                                breakOut = true;
-                            }
-                            break;
-                        }
-
-                        // do recursion
-                        std::string bnode = recurse.at(nrn);
-                        HashResult result = hashPaths(bnode, pathUniqueNamerCopy);
-                        path += pathUniqueNamerCopy.get(bnode) + "<" + result.hash + ">";
-                        pathUniqueNamerCopy = result.pathNamer;
-
-                        // skip permutation if path is already >= chosen path
-                        if (chosenPath != nullptr && path.length() >= chosenPath->length() && path > *chosenPath) {
-                            if (!permutator.hasNext()) {
-                                // digest chosen path and update namer
-                                md.update(*chosenPath);
-                                pathUniqueNamer = chosenNamer;
-                                // hash the nextGroup
-                                breakOut = true;
-                            }
-                            break;
-                        }
-                        // do next recursion
-                    }
-
-                    // if we should stop processing this group
-                    if (breakOut) {
-                        break;
                     }
                 }
+
+                // digest chosen path and update namer
+                md->update(chosenPath);
+                pathUniqueNamer = chosenNamer;
+                // hash the nextGroup
             }
         }
         // get adjacent bnode
-        RDF::Quad quad = bnode_quads.at(hpi);
-        std::shared_ptr<std::string> bnode = getAdjacentBlankNodeName(quad.getSubject(), id);
-        std::string direction;
-        if (bnode != nullptr) {
+        size_t quad = bnode_quads[hpi];
+        const RDF::Term & subject = quads.getSubject(quad);
+        const RDF::Term & object = quads.getObject(quad);
+        const RDF::Term * bnode = nullptr;
+        const char * direction = nullptr;
+        if (subject.isBlankNode() && subject.value != idLabel) {
             // normal property
+            bnode = &subject;
             direction = "p";
-        } else {
-            bnode = getAdjacentBlankNodeName(quad.getObject(), id);
-            if (bnode != nullptr) {
-                // reverse property
-                direction = "r";
-            }
+        } else if (object.isBlankNode() && object.value != idLabel) {
+            // reverse property
+            bnode = &object;
+            direction = "r";
         }
 
         if (bnode != nullptr) {
             // get bnode name (try canonical, path, then hash)
+            const std::string & bnodeLabel = dictionary.get(bnode->value);
             std::string name;
-            if (uniqueNamer.exists(*bnode)) {
-                name = uniqueNamer.get(*bnode);
-            } else if (pathUniqueNamer.exists(*bnode)) {
-                name = pathUniqueNamer.get(*bnode);
+            if (uniqueNamer.exists(bnodeLabel)) {
+                name = uniqueNamer.get(bnodeLabel);
+            } else if (pathUniqueNamer.exists(bnodeLabel)) {
+                name = pathUniqueNamer.get(bnodeLabel);
             } else {
-                name = hashQuads(*bnode);
+                name = hashQuads(index.find(bnode->value));
             }
 
             // hash direction, property, end bnode name/hash
-            SHA1 md1;
-            md1.update(direction);
-            md1.update(quad.getPredicate()->getValue());
-            md1.update(name);
-            std::string groupHash = md1.digest();
-            if (groups.count(groupHash)) {
-                groups[groupHash].push_back(*bnode);
-            } else {
-                std::vector<std::string> tmp;
-                tmp.push_back(*bnode);
-                groups[groupHash] = tmp;
+            adjacent.push_back(bnodeLabel);
+            groupInputs.push_back(direction + dictionary.get(quads.getPredicate(quad).value) + name);
+        }
+    }
+}
+
+bool NormalizeUtils::buildPath(const std::vector<std::string> & permutation, const std::string * chosenPath,
+                               std::string & path, UniqueNamer & pathUniqueNamerCopy, size_t depth) {
+    // build adjacent path
+    std::vector<std::string> recurse;
+    for (const auto& bnode : permutation) {
+        // use canonical name if available
+        if (uniqueNamer.exists(bnode)) {
+            path += uniqueNamer.get(bnode);
+        } else {
+            // recurse if bnode isn't named in the path yet
+            if (!pathUniqueNamerCopy.exists(bnode)) {
+                recurse.push_back(bnode);
             }
+            path += pathUniqueNamerCopy.get(bnode);
+        }
+
+        // skip permutation if path is already > chosen path, whatever comes next
+        if (cannotBeChosen(path, chosenPath)) {
+            return false;
         }
     }
+
+    // does the next recursion
+    for (const auto& bnode : recurse) {
+        // the name comes before the hash, so check it before recursing
+        path += pathUniqueNamerCopy.get(bnode) + "<";
+        if (cannotBeChosen(path, chosenPath)) {
+            return false;
+        }
+
+        HashResult result = hashPaths(nodeOf(bnode), pathUniqueNamerCopy, 1, depth + 1);
+        path += result.hash + ">";
+        pathUniqueNamerCopy = result.pathNamer;
+
+        // skip permutation if path is already > chosen path, whatever comes next
+        if (cannotBeChosen(path, chosenPath)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void NormalizeUtils::choosePathInParallel(const std::vector<std::string> & group, const UniqueNamer & pathUniqueNamer,
+                                          unsigned int threads, std::string & chosenPath, UniqueNamer & chosenNamer,
+                                          size_t depth) {
+    // the permutations are numbered in the order a Permutator goes through them, and
+    // each worker builds the ones it is handed from their number
+    size_t permutations = Permutator::count(group.size());
+
+    // each worker keeps the smallest path of the permutations it tried, and since a
+    // worker is handed its permutations in order, the first one of any equal paths.
+    // The smallest of those, first in permutation order, is the one the sequential
+    // loop would have chosen.
+    struct Candidate {
+        bool chosen = false;
+        size_t index = 0;
+        std::string path;
+        UniqueNamer namer;
+    };
+    std::vector<Candidate> candidates(threads);
+    ParallelUtils::parallelFor(permutations, threads, [&](size_t i, unsigned int worker) {
+        budget.countPermutation();
+        Candidate & best = candidates[worker];
+        UniqueNamer pathUniqueNamerCopy = pathUniqueNamer;
+        std::string path;
+        if (!buildPath(Permutator::permutation(group, i), best.chosen ? &best.path : nullptr, path, pathUniqueNamerCopy, depth))
+            return;
+        if (!best.chosen || path < best.path) {
+            best.chosen = true;
+            best.index = i;
+            best.path = std::move(path);
+            best.namer = std::move(pathUniqueNamerCopy);
+        }
+    });
+
+    const Candidate * chosen = nullptr;
+    for (const auto & candidate : candidates) {
+        if (!candidate.chosen)
+            continue;
+        if (chosen == nullptr || candidate.path < chosen->path ||
+            (candidate.path == chosen->path && candidate.index < chosen->index))
+            chosen = &candidate;
+    }
+    chosenPath = chosen->path;
+    chosenNamer = chosen->namer;
 }
 
-std::string NormalizeUtils::hashQuads(std::string id) {
+const std::string & NormalizeUtils::hashQuads(NodeId id) {
     // return cached hash
-    if(cachedHashes.count(id))
-        return cachedHashes[id];
+    std::string & hash = cachedHashes[id];
+    if (hash.empty())
+        hash = computeQuadsHash(id, quadLines, *quadDigest);
+    return hash;
+}
 
+std::string NormalizeUtils::computeQuadsHash(NodeId id, RDF::CanonicalSerializer::Lines & lines,
+                                             MessageDigest & md) const {
     // serialize all of bnode's quads
-    std::vector<RDF::Quad> bnode_quads = bnodes.at(id).at("quads");
-    std::vector<std::string> nquads;
-    for (const auto & quad : bnode_quads) {
-        std::string graphName;
-        auto name = quad.getGraph();
-        if(name != nullptr)
-            graphName = name->getValue();
-        nquads.push_back(
-                RDFDatasetUtils::toNQuad(quad,name == nullptr ? nullptr : &graphName, &id));
-    }
+    RDF::TermId idLabel = index.getLabel(id);
+    auto name = [idLabel](RDF::TermId label, bool graphName) -> const std::string & {
+        return graphName ? GRAPH_LABEL : label == idLabel ? REFERENCE_LABEL : OTHER_LABEL;
+    };
+    lines.clear();
+    for (size_t quad : index.getQuads(id))
+        serializer.add(quad, name, lines);
     // sort serialized quads
-    std::sort(nquads.begin(), nquads.end());
+    lines.sort();
     // return hashed quads
-    std::string hash = sha1(nquads);
-    cachedHashes[id] = hash;
-    return hash;
+    lines.digest(md);
+    return md.digest();
+}
+
+void NormalizeUtils::hashQuadsInParallel() {
+    unsigned int threads = ParallelUtils::threadCount(opts.getNormalizationThreads());
+    std::vector<RDF::CanonicalSerializer::Lines> scratch(threads);
+    std::vector<std::unique_ptr<MessageDigest>> digests(threads);
+    for (auto & md : digests)
+        md = MessageDigest::getInstance(hashAlgorithm);
+    ParallelUtils::parallelFor(index.size(), threads, [&](size_t i, unsigned int worker) {
+        cachedHashes[i] = computeQuadsHash(static_cast<NodeId>(i), scratch[worker], *digests[worker]);
+    });
 }
 
 
@@ -5,33 +5,92 @@
 #include "JsonLdOptions.h"
 #include "UniqueNamer.h"
 #include "RDFDataset.h"
+#include "BlankNodeIndex.h"
+#include "CanonicalSerializer.h"
+#include "MessageDigest.h"
+#include "NormalizationBudget.h"
 
 class NormalizeUtils {
 private:
-    std::vector<RDF::Quad> quads;
-    std::map<std::string, std::map<std::string, std::vector<RDF::Quad>>> bnodes;
-    std::map<std::string, std::string> cachedHashes;
+    typedef RDF::BlankNodeIndex::NodeId NodeId;
+
+    const RDF::RDFDataset & dataset;
+    const RDF::QuadStore & quads;
+    const RDF::TermDictionary & dictionary;
+    RDF::BlankNodeIndex index;
+    RDF::CanonicalSerializer serializer;
+    // the hash of the quads of each blank node, empty until it is computed
+    std::vector<std::string> cachedHashes;
     UniqueNamer uniqueNamer;
     JsonLdOptions opts;
+    std::string hashAlgorithm;
+    NormalizationBudget budget;
+    // scratch space for hashQuads(), which only computes one hash at a time
+    RDF::CanonicalSerializer::Lines quadLines;
+    std::unique_ptr<MessageDigest> quadDigest;
 
     struct HashResult {
         std::string hash;
         UniqueNamer pathNamer;
     };
 
-    HashResult hashPaths(const std::string& id, UniqueNamer pathUniqueNamer);
+    // groups of blank nodes at least this big have their permutations tried on more
+    // than one thread, if there are threads to spare
+    static const size_t PARALLEL_PERMUTATIONS_MIN_GROUP_SIZE = 4;
+
+    // hashes the paths from a blank node, trying the permutations of its neighbours on
+    // up to threads threads. depth counts the hashPaths calls this one is nested in. Must
+    // not be called on more than one thread at once unless the quads of every blank node
+    // are already hashed
+    HashResult hashPaths(NodeId id, UniqueNamer pathUniqueNamer, unsigned int threads, size_t depth);
+
+    // builds the path through the blank nodes of a permutation, naming them in
+    // pathUniqueNamerCopy. Returns false once the path can no longer be chosen over
+    // chosenPath, if there is one
+    bool buildPath(const std::vector<std::string> & permutation, const std::string * chosenPath,
+                   std::string & path, UniqueNamer & pathUniqueNamerCopy, size_t depth);
+
+    // chooses the smallest path through the permutations of group, on up to threads
+    // threads, picking the same path and namer as trying them in order would
+    void choosePathInParallel(const std::vector<std::string> & group, const UniqueNamer & pathUniqueNamer,
+                              unsigned int threads, std::string & chosenPath, UniqueNamer & chosenNamer,
+                              size_t depth);
+
+    const std::string & label(NodeId id) const;
 
-    std::string hashQuads(std::string id);
+    NodeId nodeOf(const std::string & label) const;
+
+    const std::string & hashQuads(NodeId id);
+
+    // hashes the quads of a blank node with md, serializing them into lines, which is
+    // only scratch space so may be reused from call to call
+    std::string computeQuadsHash(NodeId id, RDF::CanonicalSerializer::Lines & lines, MessageDigest & md) const;
+
+    // fills cachedHashes for every blank node, on the threads the options ask for
+    void hashQuadsInParallel();
 
 public:
 
+    /**
+     * Indexes the blank nodes of dataset, which must outlive the NormalizeUtils and not
+     * change while it is in use.
+     */
     NormalizeUtils(
-            std::vector<RDF::Quad> quads,
-            std::map<std::string, std::map<std::string, std::vector<RDF::Quad>>> bnodes,
+            const RDF::RDFDataset & dataset,
             UniqueNamer  iuniqueNamer,
-            JsonLdOptions opts);
+            JsonLdOptions opts,
+            std::string hashAlgorithm = MessageDigest::SHA_1);
+
+    NormalizeUtils(const NormalizeUtils &) = delete;
+    NormalizeUtils & operator=(const NormalizeUtils &) = delete;
 
-    std::string hashBlankNodes(const std::vector<std::string> &unnamed_);
+    /**
+     * Names every blank node of the dataset.
+     *
+     * @return the quads of the dataset in N-Quads format, with the blank nodes named,
+     * sorted
+     */
+    std::string hashBlankNodes();
 
     static std::shared_ptr<std::string> getAdjacentBlankNodeName(std::shared_ptr<RDF::Node> node, std::string id);
 
@@ -0,0 +1,152 @@
+#include "ParallelUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    /**
+     * One call to parallelFor. The calling thread works on it as worker 0, and pool
+     * threads that are free join it as the next workers until it has as many as it
+     * asked for, or until the caller has run out of indices and withdraws it.
+     */
+    struct Job {
+        size_t n;
+        // a few chunks per worker, so that a slow chunk does not hold up the others
+        size_t chunk;
+        const std::function<void(size_t, unsigned int)> & body;
+        std::atomic<size_t> next;
+        std::atomic<bool> failed;
+        std::exception_ptr error;
+        std::mutex errorMutex;
+
+        // guarded by the pool's mutex
+        unsigned int workers;
+        unsigned int joined = 1;
+        unsigned int running = 0;
+
+        Job(size_t in, unsigned int iworkers, const std::function<void(size_t, unsigned int)> & ibody)
+                : n(in), chunk(std::max<size_t>(1, in / (iworkers * 8))), body(ibody), next(0), failed(false),
+                  workers(iworkers) {}
+
+        void work(unsigned int worker) {
+            try {
+                while (!failed) {
+                    size_t begin = next.fetch_add(chunk);
+                    if (begin >= n)
+                        break;
+                    size_t end = std::min(n, begin + chunk);
+                    for (size_t i = begin; i < end; i++)
+                        body(i, worker);
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error)
+                    error = std::current_exception();
+                failed = true;
+            }
+        }
+    };
+
+    /**
+     * The threads that help with parallelFor, started as they are first needed and
+     * kept for the life of the process.
+     *
+     * The caller of a job never waits for a pool thread to pick it up: when all pool
+     * threads are busy, such as with a parallelFor nested in the body of another, the
+     * caller works through the indices alone. So nested calls cannot deadlock.
+     */
+    class ThreadPool {
+    private:
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable finished;
+        // jobs that can take more workers, oldest first
+        std::deque<Job *> jobs;
+        std::vector<std::thread> threads;
+        bool stopping = false;
+
+        void loop() {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                wake.wait(lock, [this]() { return stopping || !jobs.empty(); });
+                if (stopping)
+                    return;
+                Job & job = *jobs.front();
+                unsigned int worker = job.joined++;
+                if (job.joined == job.workers)
+                    jobs.pop_front();
+                job.running++;
+                lock.unlock();
+                job.work(worker);
+                lock.lock();
+                if (--job.running == 0)
+                    finished.notify_all();
+            }
+        }
+
+    public:
+        static ThreadPool & instance() {
+            static ThreadPool pool;
+            return pool;
+        }
+
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (auto & thread : threads)
+                thread.join();
+        }
+
+        void run(Job & job) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                while (threads.size() + 1 < job.workers)
+                    threads.emplace_back(&ThreadPool::loop, this);
+                jobs.push_back(&job);
+            }
+            wake.notify_all();
+
+            job.work(0);
+
+            // no more workers may join once the indices are all handed out, and the
+            // ones that did are waited for
+            std::unique_lock<std::mutex> lock(mutex);
+            auto queued = std::find(jobs.begin(), jobs.end(), &job);
+            if (queued != jobs.end())
+                jobs.erase(queued);
+            finished.wait(lock, [&job]() { return job.running == 0; });
+        }
+    };
+
+}
+
+unsigned int ParallelUtils::threadCount(unsigned int threads) {
+    if (threads != 0)
+        return threads;
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void ParallelUtils::parallelFor(size_t n, unsigned int threads,
+                                const std::function<void(size_t, unsigned int)> & body) {
+    size_t workers = std::min<size_t>(threadCount(threads), n);
+    if (workers <= 1) {
+        for (size_t i = 0; i < n; i++)
+            body(i, 0);
+        return;
+    }
+
+    Job job(n, static_cast<unsigned int>(workers), body);
+    ThreadPool::instance().run(job);
+
+    if (job.error)
+        std::rethrow_exception(job.error);
+}
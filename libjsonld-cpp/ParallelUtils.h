@@ -0,0 +1,32 @@
+#ifndef LIBJSONLD_CPP_PARALLELUTILS_H
+#define LIBJSONLD_CPP_PARALLELUTILS_H
+
+#include <cstddef>
+#include <functional>
+
+namespace ParallelUtils {
+
+    /**
+     * @return threads, or the number of hardware threads if threads is 0
+     */
+    unsigned int threadCount(unsigned int threads);
+
+    /**
+     * Calls body(i, worker) for every i in [0, n), on up to threadCount(threads) threads
+     * including the calling one. worker is in [0, threadCount(threads)) and no two
+     * threads run with the same worker at once, so body can keep scratch space per
+     * worker. Indices are handed out in small chunks, so uneven work is balanced.
+     *
+     * The other threads come from a pool that lives as long as the process, so calls
+     * with little work each, such as one per hash group, do not start threads every
+     * time. Calls may be nested in body: when no pool thread is free, the calling
+     * thread does the work alone.
+     *
+     * If body throws, the indices not started yet are skipped and the first exception
+     * is rethrown once all threads have stopped.
+     */
+    void parallelFor(size_t n, unsigned int threads, const std::function<void(size_t, unsigned int)> & body);
+
+}
+
+#endif //LIBJSONLD_CPP_PARALLELUTILS_H
@@ -2,6 +2,7 @@
 
 #include <utility>
 #include <algorithm>
+#include <limits>
 
 using std::vector;
 using std::map;
@@ -68,3 +69,38 @@ vector<string> Permutator::next() {
     return rval;
 
 }
+
+size_t Permutator::count(size_t n) {
+    size_t rval = 1;
+    for (size_t k = 2; k <= n; k++) {
+        if (rval > std::numeric_limits<size_t>::max() / k)
+            return 0;
+        rval *= k;
+    }
+    return rval;
+}
+
+vector<string> Permutator::permutation(vector<string> strings, size_t rank) {
+    std::sort(strings.begin(), strings.end());
+
+    // In Steinhaus-Johnson-Trotter order, the permutations of the k + 1 smallest strings
+    // are each permutation of the k smallest with the (k + 1)th inserted at every
+    // position in turn: from the right end if the rank of the permutation of the k
+    // smallest is even, else from the left end
+    string::size_type length = strings.size();
+    vector<size_t> offset(length, 0);
+    vector<bool> fromRight(length, false);
+    for (string::size_type k = length; k > 1; k--) {
+        offset[k - 1] = rank % k;
+        rank /= k;
+        fromRight[k - 1] = rank % 2 == 0;
+    }
+
+    vector<string> rval;
+    rval.reserve(length);
+    for (string::size_type k = 0; k < length; k++) {
+        string::size_type pos = fromRight[k] ? k - offset[k] : offset[k];
+        rval.insert(rval.begin() + pos, std::move(strings[k]));
+    }
+    return rval;
+}
@@ -1,6 +1,7 @@
 #ifndef LIBJSONLD_CPP_PERMUTATOR_H
 #define LIBJSONLD_CPP_PERMUTATOR_H
 
+#include <cstddef>
 #include <vector>
 #include <map>
 #include <string>
@@ -15,6 +16,18 @@ public:
     explicit Permutator(std::vector <std::string> strings);
     bool hasNext();
     std::vector<std::string> next();
+
+    /**
+     * @return the number of permutations of n strings, or 0 if it does not fit in a size_t
+     */
+    static size_t count(size_t n);
+
+    /**
+     * @return the permutation next() returns on its (rank + 1)th call, for a Permutator
+     * of strings, without going through the ones before it. rank must be less than
+     * count(strings.size()).
+     */
+    static std::vector<std::string> permutation(std::vector<std::string> strings, size_t rank);
 };
 
 #endif //LIBJSONLD_CPP_PERMUTATOR_H
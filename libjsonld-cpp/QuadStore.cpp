@@ -0,0 +1,67 @@
+#include "QuadStore.h"
+
+namespace RDF {
+
+    void QuadStore::add(const Term &subject, const Term &predicate, const Term &object, const Term &graph) {
+        subjects.push_back(subject);
+        predicates.push_back(predicate);
+        objects.push_back(object);
+        graphs.push_back(graph);
+    }
+
+    void QuadStore::reserve(size_t n) {
+        subjects.reserve(n);
+        predicates.reserve(n);
+        objects.reserve(n);
+        graphs.reserve(n);
+    }
+
+    void QuadStore::select(std::vector<size_t> order) {
+        size_t n = size();
+        size_t kept = order.size();
+
+        // complete the order to a permutation of all positions, the dropped quads last
+        std::vector<bool> selected(n);
+        for (size_t i : order)
+            selected[i] = true;
+        order.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            if (!selected[i])
+                order.push_back(i);
+        }
+        std::vector<bool>().swap(selected);
+
+        // follow each cycle, marking the positions already filled as fixed points
+        for (size_t k = 0; k < n; k++) {
+            if (order[k] == k)
+                continue;
+            Term subject = subjects[k], predicate = predicates[k], object = objects[k], graph = graphs[k];
+            size_t j = k;
+            while (order[j] != k) {
+                size_t from = order[j];
+                subjects[j] = subjects[from];
+                predicates[j] = predicates[from];
+                objects[j] = objects[from];
+                graphs[j] = graphs[from];
+                order[j] = j;
+                j = from;
+            }
+            subjects[j] = subject;
+            predicates[j] = predicate;
+            objects[j] = object;
+            graphs[j] = graph;
+            order[j] = j;
+        }
+        truncate(kept);
+    }
+
+    void QuadStore::truncate(size_t n) {
+        if (n >= size())
+            return;
+        subjects.resize(n);
+        predicates.resize(n);
+        objects.resize(n);
+        graphs.resize(n);
+    }
+
+}
@@ -0,0 +1,58 @@
+#ifndef LIBJSONLD_CPP_QUADSTORE_H
+#define LIBJSONLD_CPP_QUADSTORE_H
+
+#include "Term.h"
+#include <vector>
+
+namespace RDF {
+
+    /**
+     * Column-oriented storage for quads. The subjects, predicates, objects and graph
+     * names of the quads are kept in four parallel arrays of Terms, so the i-th quad is
+     * (getSubject(i), getPredicate(i), getObject(i), getGraph(i)). All terms are interned
+     * in a single TermDictionary, which is owned by whoever owns the store.
+     *
+     * Quads in the default graph have Term::defaultGraph() as their graph name.
+     */
+    class QuadStore {
+    private:
+        std::vector<Term> subjects;
+        std::vector<Term> predicates;
+        std::vector<Term> objects;
+        std::vector<Term> graphs;
+
+    public:
+        void add(const Term & subject, const Term & predicate, const Term & object, const Term & graph);
+        void reserve(size_t n);
+
+        /**
+         * Keeps only the quads at the given positions, in that order: the quad at
+         * order[k] moves to position k. The positions must be distinct. The quads are
+         * moved in place, along the cycles of the permutation.
+         */
+        void select(std::vector<size_t> order);
+
+        /**
+         * Drops the quads from position n on.
+         */
+        void truncate(size_t n);
+
+        size_t size() const { return subjects.size(); }
+        bool empty() const { return subjects.empty(); }
+
+        const Term & getSubject(size_t i) const { return subjects[i]; }
+        const Term & getPredicate(size_t i) const { return predicates[i]; }
+        const Term & getObject(size_t i) const { return objects[i]; }
+        const Term & getGraph(size_t i) const { return graphs[i]; }
+
+        const std::vector<Term> & getSubjects() const { return subjects; }
+        const std::vector<Term> & getPredicates() const { return predicates; }
+        const std::vector<Term> & getObjects() const { return objects; }
+        const std::vector<Term> & getGraphs() const { return graphs; }
+
+        static bool isDefaultGraph(const Term & graph) { return graph.isDefaultGraph(); }
+    };
+
+}
+
+#endif //LIBJSONLD_CPP_QUADSTORE_H
@@ -2,157 +2,364 @@
 #include "JsonLdOptions.h"
 #include "JsonLdUtils.h"
 #include "DoubleFormatter.h"
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
 
 using VectorMap = RDF::RDFDataset::VectorMap;
 using nlohmann::json;
 
 namespace RDF {
 
-    RDF::RDFDataset::RDFDataset(JsonLdOptions ioptions, UniqueNamer *iblankNodeUniqueNamer)
-            : options(std::move(ioptions)), blankNodeUniqueNamer(iblankNodeUniqueNamer) {
+    RDF::RDFDataset::RDFDataset(JsonLdOptions ioptions, UniqueNamer *iblankNodeUniqueNamer,
+                                std::shared_ptr<TermDictionary> itermDictionary)
+            : termDictionary(std::move(itermDictionary)),
+              options(std::move(ioptions)), blankNodeUniqueNamer(iblankNodeUniqueNamer) {
+        if (termDictionary == nullptr)
+            termDictionary = std::make_shared<TermDictionary>();
+    }
+
+    const std::shared_ptr<TermDictionary> &RDFDataset::getTermDictionary() const {
+        return termDictionary;
+    }
+
+    bool RDF::RDFDataset::insert(const VectorMap::value_type &value) {
+        if (graphRanges.count(value.first))
+            return false;
+
+        Term graph = graphNameToTerm(value.first);
+        size_t first = quadStore.size();
+        quadStore.reserve(first + value.second.size());
+        for (const auto & quad : value.second) {
+            // re-intern the terms unless the quad was built on our own dictionary
+            Term t[3];
+            const std::shared_ptr<Node> * n[3] = {&quad.getSubject(), &quad.getPredicate(), &quad.getObject()};
+            for (int k = 0; k < 3; k++) {
+                const Node & node = **n[k];
+                t[k] = node.getTerm();
+                if (node.getDictionary() != termDictionary) {
+                    t[k].value = termDictionary->intern(node.getValue());
+                    t[k].datatype = termDictionary->intern(node.getDatatype());
+                    t[k].language = termDictionary->intern(node.getLanguage());
+                }
+            }
+            quadStore.add(t[0], t[1], t[2], graph);
+        }
+        graphRanges[value.first] = std::make_pair(first, quadStore.size());
+        return true;
+    }
+
+    namespace {
+
+        size_t hashTerm(size_t seed, const Term & term) {
+            uint64_t h = seed;
+            h = (h ^ static_cast<uint64_t>(term.kind)) * 0x100000001b3ULL;
+            h = (h ^ term.value) * 0x100000001b3ULL;
+            h = (h ^ term.datatype) * 0x100000001b3ULL;
+            h = (h ^ term.language) * 0x100000001b3ULL;
+            return static_cast<size_t>(h ^ (h >> 32));
+        }
+
+        struct TermHash {
+            size_t operator()(const Term & term) const { return hashTerm(0xcbf29ce484222325ULL, term); }
+        };
+
+        size_t hashQuad(const QuadStore & quads, size_t i) {
+            size_t h = hashTerm(0xcbf29ce484222325ULL, quads.getSubject(i));
+            h = hashTerm(h, quads.getPredicate(i));
+            h = hashTerm(h, quads.getObject(i));
+            return hashTerm(h, quads.getGraph(i));
+        }
+
+        bool sameQuad(const QuadStore & quads, size_t i, size_t j) {
+            return quads.getSubject(i) == quads.getSubject(j) && quads.getPredicate(i) == quads.getPredicate(j) &&
+                   quads.getObject(i) == quads.getObject(j) && quads.getGraph(i) == quads.getGraph(j);
+        }
 
     }
 
-    VectorMap::mapped_type &RDF::RDFDataset::at(const VectorMap::key_type &s) {
-        return vectorMap.at(s);
+    void RDF::RDFDataset::insert(const QuadStore &quads) {
+        quadStore.reserve(quadStore.size() + quads.size());
+        for (size_t i = 0; i < quads.size(); i++)
+            appendQuad(quads.getSubject(i), quads.getPredicate(i), quads.getObject(i), quads.getGraph(i));
+        insertAppended();
+    }
+
+    void RDF::RDFDataset::appendQuad(const Term &subject, const Term &predicate, const Term &object,
+                                     const Term &graph) {
+        quadStore.add(subject, predicate, object, graph);
+    }
+
+    size_t RDF::RDFDataset::insertedSize() const {
+        size_t size = 0;
+        for (const auto & it : graphRanges)
+            size = std::max(size, it.second.second);
+        return size;
+    }
+
+    void RDF::RDFDataset::dropAppended() {
+        quadStore.truncate(insertedSize());
+    }
+
+    void RDF::RDFDataset::insertAppended() {
+        const uint32_t SKIP = UINT32_MAX;
+        size_t first = insertedSize();
+        size_t n = quadStore.size();
+        if (first == n)
+            return;
+
+        // the graphs of the appended quads, in order of first appearance, with the range
+        // of the quads they already have
+        struct Group {
+            std::string name;
+            bool existing;
+            std::pair<size_t, size_t> range;
+            size_t added;
+            // where the group starts, and where its next appended quad goes, once merged
+            size_t start;
+            size_t next;
+        };
+        std::unordered_map<Term, uint32_t, TermHash> graphIndex;
+        std::vector<Group> groups;
+        std::vector<uint32_t> groupOf(n - first);
+        size_t existingSize = 0;
+        for (size_t i = first; i < n; i++) {
+            const Term & graph = quadStore.getGraph(i);
+            auto g = graphIndex.find(graph);
+            if (g == graphIndex.end()) {
+                Group group;
+                group.name = QuadStore::isDefaultGraph(graph) ?
+                             std::string(JsonLdConsts::DEFAULT) : termDictionary->get(graph.value);
+                auto range = graphRanges.find(group.name);
+                group.existing = range != graphRanges.end();
+                group.range = group.existing ? range->second : std::make_pair(first, first);
+                group.added = 0;
+                existingSize += group.range.second - group.range.first;
+                g = graphIndex.insert(std::make_pair(graph, static_cast<uint32_t>(groups.size()))).first;
+                groups.push_back(group);
+            }
+            groupOf[i - first] = g->second;
+        }
+
+        // skip duplicates, of each other or of quads their graph already has, with an
+        // open addressing set of quad positions
+        size_t capacity = 16;
+        while (capacity < 2 * (n - first + existingSize))
+            capacity *= 2;
+        const size_t EMPTY_SLOT = SIZE_MAX;
+        std::vector<size_t> seen(capacity, EMPTY_SLOT);
+        auto addSeen = [&](size_t i) -> bool {
+            size_t slot = hashQuad(quadStore, i) & (capacity - 1);
+            while (seen[slot] != EMPTY_SLOT) {
+                if (sameQuad(quadStore, seen[slot], i))
+                    return false;
+                slot = (slot + 1) & (capacity - 1);
+            }
+            seen[slot] = i;
+            return true;
+        };
+        for (const Group & group : groups) {
+            for (size_t i = group.range.first; i < group.range.second; i++)
+                addSeen(i);
+        }
+        size_t total = first;
+        for (size_t i = first; i < n; i++) {
+            uint32_t & g = groupOf[i - first];
+            if (addSeen(i)) {
+                groups[g].added++;
+                total++;
+            } else {
+                g = SKIP;
+            }
+        }
+        std::vector<size_t>().swap(seen);
+
+        // the new order of the quads: the appended quads of an existing graph go right
+        // after its old ones, moving the graphs after it, and new graphs go last. Room
+        // is reserved for QuadStore::select() to complete the order with the duplicates
+        std::vector<Group *> merged;
+        for (Group & group : groups) {
+            if (group.existing)
+                merged.push_back(&group);
+        }
+        std::sort(merged.begin(), merged.end(), [](const Group * lhs, const Group * rhs) {
+            return std::make_pair(lhs->range.second, lhs->range.first) <
+                   std::make_pair(rhs->range.second, rhs->range.first);
+        });
+        std::vector<size_t> order;
+        order.reserve(n);
+        order.resize(total);
+        size_t k = 0;
+        size_t previous = 0;
+        for (Group * group : merged) {
+            group->start = k + (group->range.first - previous);
+            for (size_t i = previous; i < group->range.second; i++)
+                order[k++] = i;
+            group->next = k;
+            k += group->added;
+            previous = group->range.second;
+        }
+        for (size_t i = previous; i < first; i++)
+            order[k++] = i;
+        for (Group & group : groups) {
+            if (!group.existing) {
+                group.start = group.next = k;
+                k += group.added;
+            }
+        }
+        for (size_t i = first; i < n; i++) {
+            if (groupOf[i - first] != SKIP)
+                order[groups[groupOf[i - first]].next++] = i;
+        }
+        std::vector<uint32_t>().swap(groupOf);
+        quadStore.select(std::move(order));
+
+        // the other graphs move by the quads added to the merged graphs before them
+        std::vector<size_t> ends;
+        std::vector<size_t> addedBefore;
+        for (const Group * group : merged) {
+            ends.push_back(group->range.second);
+            addedBefore.push_back(group->added + (addedBefore.empty() ? 0 : addedBefore.back()));
+        }
+        for (auto & it : graphRanges) {
+            auto before = std::upper_bound(ends.begin(), ends.end(), it.second.first) - ends.begin();
+            if (before > 0) {
+                it.second.first += addedBefore[before - 1];
+                it.second.second += addedBefore[before - 1];
+            }
+        }
+        for (const Group & group : groups)
+            graphRanges[group.name] = std::make_pair(group.start, group.next);
     }
 
-    std::pair<VectorMap::iterator, bool>
-    RDF::RDFDataset::insert(const std::map<std::string, std::vector<Quad>>::value_type &value) {
-        return vectorMap.insert(value);
+    Term RDF::RDFDataset::graphNameToTerm(const std::string &graphName) {
+        if (graphName == JsonLdConsts::DEFAULT)
+            return Term::defaultGraph();
+        return graphName.find_first_of("_:") == 0 ?
+               Term::blankNode(*termDictionary, graphName) :
+               Term::iri(*termDictionary, graphName);
     }
 
 /**
  * Creates an array of RDF triples for the given graph.
  *
- * @param graphName
- *            The graph URI
  * @param graph
- *            the graph to create RDF triples for.
+ *            the graph to create RDF triples for, from a node map whose ids are interned
+ *            in this dataset's dictionary.
  */
-    void RDF::RDFDataset::graphToRDF(std::string &graphName, const json & graph) {
+    void RDF::RDFDataset::graphToRDF(const NodeMap::Graph & graph) {
 
-        std::shared_ptr<Node> rdf_first = std::make_shared<IRI>(JsonLdConsts::RDF_FIRST);
-        std::shared_ptr<Node> rdf_rest = std::make_shared<IRI>(JsonLdConsts::RDF_REST);
-        std::shared_ptr<Node> rdf_nil = std::make_shared<IRI>(JsonLdConsts::RDF_NIL);
+        TermDictionary & dictionary = *termDictionary;
+        const std::string & graphName = dictionary.get(graph.name);
+        if (graphRanges.count(graphName))
+            return;
 
+        Term rdf_first = Term::iri(dictionary, JsonLdConsts::RDF_FIRST);
+        Term rdf_rest = Term::iri(dictionary, JsonLdConsts::RDF_REST);
+        Term rdf_nil = Term::iri(dictionary, JsonLdConsts::RDF_NIL);
+        Term rdf_type = Term::iri(dictionary, JsonLdConsts::RDF_TYPE);
+        Term graphTerm = graphNameToTerm(graphName);
 
         // 4.2)
-        std::vector<Quad> triples;
+        size_t first = quadStore.size();
 
-        //todo: so, wait! ... will rdfdataset ever needs to store shared_ptr to quads, or just quads? If
-        // just quads, did I have to go through all that bother with shared_ptr comparisons? probably need to see
-        // what java does with the list of quads later.
-
-        // 4.3)
-        std::vector<std::string> subjects;
-        if(graph.contains("key_insertion_order")) {
-            for (const auto & it : graph["key_insertion_order"]) {
-                subjects.push_back(it);
-            }
-        }
-        // else?
-
-        for (auto id : subjects) {
+        // 4.3) nodes in the order they were added to the node map
+        for (const NodeMap::Node * node : graph.nodes) {
+            const std::string & id = dictionary.get(node->id);
             if (JsonLdUtils::isRelativeIri(id)) {
                 continue;
             }
-            const json & node = graph[id];
 
-            std::vector<std::string> properties;
-            for (json::const_iterator it = node.begin(); it != node.end(); ++it) {
-                properties.push_back(it.key());
-            }
+            // NOTE: don't rename blank nodes, just set them as blank nodes
+            Term subject;
+            subject.kind = id.find_first_of("_:") == 0 ? Term::Kind::BlankNode : Term::Kind::IRI;
+            subject.value = node->id;
 
-            std::sort(properties.begin(), properties.end());
-
-            for (auto property : properties) {
-                const json * values;
+            // the node map keeps them ordered by name
+            for (const NodeMap::Property * property : node->properties) {
+                const std::string & name = dictionary.get(property->name);
+                Term predicate;
+                const JsonLdConsts::Keyword keyword = JsonLdUtils::getKeyword(name);
                 // 4.3.2.1)
-                if (property == "@type") {
-                    values = &node["@type"];
-                    property = JsonLdConsts::RDF_TYPE;
+                if (keyword == JsonLdConsts::Keyword::Type) {
+                    predicate = rdf_type;
                 }
                     // 4.3.2.2)
-                else if (JsonLdUtils::isKeyword(property)) {
+                else if (keyword != JsonLdConsts::Keyword::NotAKeyword) {
                     continue;
                 }
                     // 4.3.2.3)
-                else if (property.find_first_of("_:") == 0 && !options.getProduceGeneralizedRdf()) {
-                    continue;
+                else if (name.find_first_of("_:") == 0) {
+                    if (!options.getProduceGeneralizedRdf())
+                        continue;
+                    predicate.kind = Term::Kind::BlankNode;
+                    predicate.value = property->name;
                 }
-                    // 4.3.2.4)
-                else if (JsonLdUtils::isRelativeIri(property)) {
+                    // 4.3.2.4) not a keyword, so relative unless absolute
+                else if (!JsonLdUtils::isAbsoluteIri(name)) {
                     continue;
                 } else {
-                    values = &node[property];
-                }
-
-                std::shared_ptr<Node> subject;
-                if (id.find_first_of("_:") == 0) {
-                    // NOTE: don't rename, just set it as a blank node
-                    subject = std::make_shared<BlankNode>(id);
-                } else {
-                    subject = std::make_shared<IRI>(id);
-                }
-
-                // RDF predicates
-                std::shared_ptr<Node> predicate;
-                if (property.find_first_of("_:") == 0) {
-                    predicate = std::make_shared<BlankNode>(property);
-                } else {
-                    predicate = std::make_shared<IRI>(property);
+                    predicate.kind = Term::Kind::IRI;
+                    predicate.value = property->name;
                 }
 
-                for (auto item : *values) {
+                for (const auto & item : property->values) {
                     // convert @list to triples
                     if (JsonLdUtils::isList(item)) {
-                        auto & list = item["@list"];
-                        std::shared_ptr<Node> last;
-                        std::shared_ptr<Node> firstBNode = rdf_nil;
+                        const auto & list = item[JsonLdConsts::LIST];
+                        Term last;
+                        bool haveLast = false;
+                        Term firstBNode = rdf_nil;
                         if (!list.empty()) {
-                            last = objectToRDF(list.back());
-                            firstBNode = std::make_shared<BlankNode>(blankNodeUniqueNamer->get());
+                            haveLast = objectToRDF(list.back(), last);
+                            firstBNode = Term::blankNode(dictionary, blankNodeUniqueNamer->get());
                         }
-                        triples.emplace_back(subject, predicate, firstBNode, &graphName);
+                        quadStore.add(subject, predicate, firstBNode, graphTerm);
                         if (!list.empty()) {
-                            for (json::size_type i = 0; i < list.size() - 1; i++) {
-                                std::shared_ptr<Node> object = objectToRDF(list.at(i));
-                                triples.emplace_back(firstBNode, rdf_first, object, &graphName);
-                                std::shared_ptr<Node> restBNode = std::make_shared<BlankNode>(
-                                        blankNodeUniqueNamer->get());
-                                triples.emplace_back(firstBNode, rdf_rest, restBNode, &graphName);
+                            for (size_t i = 0; i < list.size() - 1; i++) {
+                                Term object;
+                                if (objectToRDF(list.at(i), object))
+                                    quadStore.add(firstBNode, rdf_first, object, graphTerm);
+                                Term restBNode = Term::blankNode(dictionary, blankNodeUniqueNamer->get());
+                                quadStore.add(firstBNode, rdf_rest, restBNode, graphTerm);
                                 firstBNode = restBNode;
                             }
                         }
-                        if (last != nullptr) {
-                            triples.emplace_back(firstBNode, rdf_first, last, &graphName);
-                            triples.emplace_back(firstBNode, rdf_rest, rdf_nil, &graphName);
+                        if (haveLast) {
+                            quadStore.add(firstBNode, rdf_first, last, graphTerm);
+                            quadStore.add(firstBNode, rdf_rest, rdf_nil, graphTerm);
                         }
                     }
                         // convert value or node object to triple
                     else {
-                        std::shared_ptr<Node> object = objectToRDF(item);
-                        if (object != nullptr) {
-                            triples.push_back(Quad(subject, predicate, object, &graphName));
+                        Term object;
+                        if (objectToRDF(item, object)) {
+                            quadStore.add(subject, predicate, object, graphTerm);
                         }
                     }
                 }
             }
         }
 
-        insert(std::make_pair(graphName, triples));
-
+        graphRanges[graphName] = std::make_pair(first, quadStore.size());
     }
 
-    std::shared_ptr<RDF::Node> RDF::RDFDataset::objectToRDF(json item) {
+    /**
+     * Converts a JSON-LD value or node object to an RDF term.
+     *
+     * @return false if the item is a node object with a relative IRI, which has no
+     *         RDF representation
+     */
+    template<typename JSON>
+    bool RDF::RDFDataset::objectToRDF(const JSON & item, Term & object) {
+        TermDictionary & dictionary = *termDictionary;
         // convert value object to RDF
         if (JsonLdUtils::isValue(item)) {
-            json value = item["@value"];
-            json datatype = item["@type"];
+            const JSON & value = item[JsonLdConsts::VALUE];
+            JSON datatype = item.contains(JsonLdConsts::TYPE) ? item[JsonLdConsts::TYPE] : JSON();
             std::string datatypeStr;
             if (!datatype.is_null())
-                datatypeStr = datatype.get<std::string>();
+                datatypeStr = datatype.template get<std::string>();
 
             // convert to XSD datatypes as appropriate
             if (value.is_boolean()) {
@@ -161,72 +368,65 @@ namespace RDF {
                 bool b = value;
                 std::stringstream ss;
                 ss << std::boolalpha << b;
-                return std::make_shared<Literal>(
-                        ss.str(),
-                        &datatypeStr,
-                        nullptr);
+                object = Term::literal(dictionary, ss.str(), &datatypeStr, nullptr);
+                return true;
             }
             if (value.is_number()) {
                 if (value.is_number_float() || datatype == JsonLdConsts::XSD_DOUBLE) {
                     if (datatype.is_null())
                         datatypeStr = JsonLdConsts::XSD_DOUBLE;
                     double d = value;
-                    return std::make_shared<Literal>(
-                            DoubleFormatter::format(d),
-                            &datatypeStr,
-                            nullptr);
+                    object = Term::literal(dictionary, DoubleFormatter::format(d), &datatypeStr, nullptr);
                 } else {
                     if (datatype.is_null())
                         datatypeStr = JsonLdConsts::XSD_INTEGER;
                     int i = value;
-                    return std::make_shared<Literal>(
-                            std::to_string(i),
-                            &datatypeStr,
-                            nullptr);
+                    object = Term::literal(dictionary, std::to_string(i), &datatypeStr, nullptr);
                 }
-            } else if (item.contains("@language")) {
-                std::string languageStr = item["@language"].get<std::string>();
+            } else if (item.contains(JsonLdConsts::LANGUAGE)) {
+                std::string languageStr = item[JsonLdConsts::LANGUAGE].template get<std::string>();
                 if (datatype.is_null())
                     datatypeStr = JsonLdConsts::RDF_LANGSTRING;
-                return std::make_shared<Literal>(
-                        value.get<std::string>(),
-                        &datatypeStr,
-                        &languageStr);
+                object = Term::literal(dictionary, value.template get<std::string>(), &datatypeStr, &languageStr);
             } else {
                 if (datatype.is_null())
                     datatypeStr = JsonLdConsts::XSD_STRING;
-                return std::make_shared<Literal>(
-                        value.get<std::string>(),
-                        &datatypeStr,
-                        nullptr);
+                object = Term::literal(dictionary, value.template get<std::string>(), &datatypeStr, nullptr);
             }
+            return true;
         }
             // convert string/node object to RDF
         else {
             std::string id;
             if (JsonLdUtils::isObject(item)) {
-                id = item["@id"];
+                id = item[JsonLdConsts::ID];
                 if (JsonLdUtils::isRelativeIri(id)) {
-                    return nullptr;
+                    return false;
                 }
             } else {
                 id = item;
             }
             if (id.find_first_of("_:") == 0) {
                 // NOTE: once again no need to rename existing blank nodes
-                return std::make_shared<BlankNode>(id);
+                object = Term::blankNode(dictionary, id);
             } else {
-                return std::make_shared<IRI>(id);
+                object = Term::iri(dictionary, id);
             }
+            return true;
         }
     }
 
     bool operator==(const Node &lhs, const Node &rhs) {
-        return lhs.map == rhs.map;
+        if (lhs.dictionary != nullptr && lhs.dictionary == rhs.dictionary)
+            return lhs.term == rhs.term;
+        return lhs.term.kind == rhs.term.kind &&
+               lhs.getValue() == rhs.getValue() &&
+               lhs.getDatatype() == rhs.getDatatype() &&
+               lhs.getLanguage() == rhs.getLanguage();
     }
 
     bool operator!=(const Node &lhs, const Node &rhs) {
-        return !(lhs.map == rhs.map);
+        return !(lhs == rhs);
     }
 
     bool operator<(const Node &lhs, const Node &rhs) {
@@ -246,45 +446,40 @@ namespace RDF {
         return !(lhs < rhs);
     }
 
-    std::string Node::getValue() const {
-        return map["value"];
+    const std::string & Node::getValue() const {
+        return dictionary != nullptr ? dictionary->get(term.value) : value;
     }
 
     void Node::setValue(const std::string &s) {
-        map["value"] = s;
-    }
-
-    std::string Node::getDatatype() const {
-        if(map.count("datatype") > 0)
-            return map["datatype"];
+        if (dictionary != nullptr)
+            term.value = dictionary->intern(s);
         else
-            return "";
+            value = s;
     }
 
-    std::string Node::getLanguage() const {
-        if(map.count("language") > 0)
-            return map["language"];
-        else
-            return "";
+    const std::string & Node::getDatatype() const {
+        return dictionary != nullptr ? dictionary->get(term.datatype) : datatype;
     }
 
-    Node::Node() = default;
-    Node::~Node() = default;
-
-    bool operator==(const RDF::Quad &lhs, const RDF::Quad &rhs) {
+    const std::string & Node::getLanguage() const {
+        return dictionary != nullptr ? dictionary->get(term.language) : language;
+    }
 
-        // there is no easy way to check that two maps of shared_ptrs are equal, so we will do it
-        // the hard way (first check sizes, then compare keys and values with a lambda comparator)
+    Node::Node(std::shared_ptr<TermDictionary> idictionary, const Term &iterm)
+            : dictionary(std::move(idictionary)), term(iterm) {
+    }
 
-        return
-                lhs.map.size() == rhs.map.size() &&
-                std::equal(lhs.map.begin(), lhs.map.end(), rhs.map.begin(),
-                           [](const decltype(lhs.map)::value_type &a,
-                              const decltype(rhs.map)::value_type &b) {
-                               return (a.first == b.first) &&
-                                      (*(a.second) == *(b.second));
-                           });
+    Node::Node(Term::Kind kind, std::string ivalue, std::string idatatype, std::string ilanguage)
+            : value(std::move(ivalue)), datatype(std::move(idatatype)), language(std::move(ilanguage)) {
+        term.kind = kind;
+    }
 
+    bool operator==(const RDF::Quad &lhs, const RDF::Quad &rhs) {
+        NodePtrEquals equals;
+        return equals(lhs.subject, rhs.subject) &&
+               equals(lhs.predicate, rhs.predicate) &&
+               equals(lhs.object, rhs.object) &&
+               equals(lhs.graph, rhs.graph);
     }
 
     bool operator!=(const RDF::Quad &lhs, const RDF::Quad &rhs) {
@@ -316,204 +511,132 @@ namespace RDF {
         return !(lhs < rhs);
     }
 
-    void Quad::init(std::string subject, std::string predicate, std::shared_ptr<Node> object, std::string *graph) {
-        subject.find_first_of("_:") == 0 ?
-        setSubject(std::make_shared<BlankNode>(subject)) :
-        setSubject(std::make_shared<IRI>(subject));
+    void Quad::init(std::string isubject, std::string ipredicate, std::shared_ptr<Node> iobject,
+                    const std::string *igraph) {
+        isubject.find_first_of("_:") == 0 ?
+        setSubject(std::make_shared<BlankNode>(isubject)) :
+        setSubject(std::make_shared<IRI>(isubject));
 
-        setPredicate(std::make_shared<IRI>(predicate));
+        setPredicate(std::make_shared<IRI>(ipredicate));
 
-        setObject(std::move(object));
-        setGraph(graph);
+        setObject(std::move(iobject));
+        setGraph(igraph);
     }
 
-    Quad::Quad(std::shared_ptr<Node> subject, std::shared_ptr<Node> predicate, std::shared_ptr<Node> object,
-               std::string *graph) {
-        setSubject(std::move(subject));
-        setPredicate(std::move(predicate));
-        setObject(std::move(object));
-        setGraph(graph);
+    Quad::Quad(std::shared_ptr<Node> isubject, std::shared_ptr<Node> ipredicate, std::shared_ptr<Node> iobject,
+               const std::string *igraph) {
+        setSubject(std::move(isubject));
+        setPredicate(std::move(ipredicate));
+        setObject(std::move(iobject));
+        setGraph(igraph);
     }
 
-    Quad::Quad(std::string subject, std::string predicate, std::string object, std::string *graph) {
+    Quad::Quad(std::string isubject, std::string ipredicate, std::string iobject, const std::string *igraph) {
         std::shared_ptr<Node> o;
-        object.find_first_of("_:") == 0 ?
-                o = std::make_shared<BlankNode>(object) :
-                o = std::make_shared<IRI>(object);
-
-        init(std::move(subject), std::move(predicate), o, graph);
-    }
-
-    Quad::Quad(std::string subject, std::string predicate, const std::string &value, std::string datatype,
-               std::string language, std::string *graph) {
-        init(std::move(subject), std::move(predicate), std::make_shared<Literal>(value, &datatype, &language), graph);
-    }
-
-    std::shared_ptr<Node> Quad::getPredicate() const {
-        if(map.count("predicate"))
-            return map.at("predicate");
-        else
-            return nullptr;
-    }
-
-    std::shared_ptr<Node> Quad::getObject() const {
-        if(map.count("object"))
-            return map.at("object");
-        else
-            return nullptr;
-    }
-
-    std::shared_ptr<Node> Quad::getGraph() const {
-        if(map.count("name"))
-            return map.at("name");
-        else
-            return nullptr;
-    }
-
-    std::shared_ptr<Node> Quad::getSubject() const {
-        if(map.count("subject"))
-            return map.at("subject");
-        else
-            return nullptr;
-    }
-
-    void Quad::setGraph(const std::string *graph) { // todo: maybe make this private? friends needed?
-        if (graph != nullptr && *graph != "@default") {
-            std::shared_ptr<Node> n;
-            graph->find_first_of("_:") == 0 ?
-                    n = std::make_shared<BlankNode>(*graph) :
-                    n = std::make_shared<IRI>(*graph);
-            map["name"] = n;
+        iobject.find_first_of("_:") == 0 ?
+                o = std::make_shared<BlankNode>(iobject) :
+                o = std::make_shared<IRI>(iobject);
+
+        init(std::move(isubject), std::move(ipredicate), o, igraph);
+    }
+
+    Quad::Quad(std::string isubject, std::string ipredicate, const std::string &value, std::string datatype,
+               std::string language, const std::string *igraph) {
+        init(std::move(isubject), std::move(ipredicate), std::make_shared<Literal>(value, &datatype, &language),
+             igraph);
+    }
+
+    void Quad::setGraph(const std::string *igraph) { // todo: maybe make this private? friends needed?
+        if (igraph != nullptr && *igraph != JsonLdConsts::DEFAULT) {
+            // intern the graph name next to the rest of the quad's terms, if they are
+            std::shared_ptr<TermDictionary> d = getSubject() != nullptr ? getSubject()->getDictionary() : nullptr;
+            bool blankNode = igraph->find_first_of("_:") == 0;
+            if (d != nullptr)
+                this->graph = blankNode ? std::shared_ptr<Node>(std::make_shared<BlankNode>(d, *igraph)) :
+                              std::shared_ptr<Node>(std::make_shared<IRI>(d, *igraph));
+            else
+                this->graph = blankNode ? std::shared_ptr<Node>(std::make_shared<BlankNode>(*igraph)) :
+                              std::shared_ptr<Node>(std::make_shared<IRI>(*igraph));
         }
     }
 
     std::set<std::string> RDFDataset::graphNames() const {
         std::set<std::string> names;
-        for (const auto & it : vectorMap) {
+        for (const auto & it : graphRanges) {
             names.insert(it.first);
         }
         return names;
     }
 
     std::vector<Quad> RDFDataset::getQuads(const std::string & graphName) const {
-        if(vectorMap.count(graphName))
-            return vectorMap.at(graphName);
-        return std::vector<Quad>();
-    }
-
-    bool Literal::isLiteral() const {
-        return true;
-    }
-
-    bool Literal::isIRI() const {
-        return false;
-    }
-
-    bool Literal::isBlankNode() const {
-        return false;
-    }
-
-    Literal::Literal(const std::string &value, std::string *datatype, std::string *language) {
-        map["type"] = "literal";
-        map["value"] = value;
-        map["datatype"] = datatype != nullptr ? *datatype : JsonLdConsts::XSD_STRING;
-        if (language != nullptr) {
-            map["language"] = *language;
+        std::vector<Quad> quads;
+        auto range = getGraphRange(graphName);
+        quads.reserve(range.second - range.first);
+        const std::string * graph = graphName == JsonLdConsts::DEFAULT ? nullptr : &graphName;
+        for (size_t i = range.first; i < range.second; i++) {
+            quads.emplace_back(std::make_shared<Node>(termDictionary, quadStore.getSubject(i)),
+                               std::make_shared<Node>(termDictionary, quadStore.getPredicate(i)),
+                               std::make_shared<Node>(termDictionary, quadStore.getObject(i)),
+                               graph);
         }
+        return quads;
     }
 
-    bool IRI::isLiteral() const {
-        return false;
+    const QuadStore &RDFDataset::getQuadStore() const {
+        return quadStore;
     }
 
-    bool IRI::isIRI() const {
-        return true;
+    std::pair<size_t, size_t> RDFDataset::getGraphRange(const std::string &graphName) const {
+        auto it = graphRanges.find(graphName);
+        if (it == graphRanges.end())
+            return std::make_pair<size_t, size_t>(0, 0);
+        return it->second;
     }
 
-    bool IRI::isBlankNode() const {
-        return false;
+    Literal::Literal(const std::string &value, std::string *datatype, std::string *language)
+            : Node(Term::Kind::Literal, value, datatype != nullptr ? *datatype : std::string(JsonLdConsts::XSD_STRING),
+                   language != nullptr ? *language : std::string()) {
     }
 
-    IRI::IRI(const std::string &iri) {
-        map["type"] = "IRI";
-        map["value"] = iri;
+    Literal::Literal(std::shared_ptr<TermDictionary> idictionary, const std::string &value,
+                     const std::string *datatype, const std::string *language)
+            : Node(idictionary, Term::literal(*idictionary, value, datatype, language)) {
     }
 
-    bool BlankNode::isBlankNode() const {
-        return true;
+    IRI::IRI(const std::string &iri)
+            : Node(Term::Kind::IRI, iri, std::string(), std::string()) {
     }
 
-    bool BlankNode::isIRI() const {
-        return false;
+    IRI::IRI(std::shared_ptr<TermDictionary> idictionary, const std::string &iri)
+            : Node(idictionary, Term::iri(*idictionary, iri)) {
     }
 
-    bool BlankNode::isLiteral() const {
-        return false;
+    BlankNode::BlankNode(const std::string &attribute)
+            : Node(Term::Kind::BlankNode, attribute, std::string(), std::string()) {
     }
 
-    BlankNode::BlankNode(const std::string &attribute) {
-        map["type"] = "blank node";
-        map["value"] = attribute;
+    BlankNode::BlankNode(std::shared_ptr<TermDictionary> idictionary, const std::string &attribute)
+            : Node(idictionary, Term::blankNode(*idictionary, attribute)) {
     }
 
     bool NodeLess::operator()(const Node &lhs, const Node &rhs) const {
-        if(lhs.isIRI()) {
-            if(!rhs.isIRI())
-                return false;
-        }
-        else if (lhs.isBlankNode()) {
-            if(rhs.isIRI())
-                return true;
-            else if(rhs.isLiteral())
-                return false;
-        }
-        else if(lhs.isLiteral()) {
-            if(rhs.isIRI() || rhs.isBlankNode())
-                return true;
-            else {
-                // lhs and rhs are literals
-                if(lhs.getValue() != rhs.getValue()) {
-                    return lhs.getValue() < rhs.getValue();
-                }
-                else {
-                    if (!lhs.getLanguage().empty() || !rhs.getLanguage().empty())
-                        return lhs.getLanguage() < rhs.getLanguage();
-                    else
-                        return lhs.getDatatype() < rhs.getDatatype();
-                }
-            }
-        }
-        return lhs.getValue() < rhs.getValue();
+        if (lhs.getDictionary() != nullptr && rhs.getDictionary() != nullptr)
+            return compare(*lhs.getDictionary(), lhs.getTerm(), *rhs.getDictionary(), rhs.getTerm()) < 0;
+
+        // the same order as compare(), on the strings of detached nodes
+        if (lhs.getTerm().kind != rhs.getTerm().kind)
+            return lhs.getTerm().kind < rhs.getTerm().kind;
+        int c = lhs.getValue().compare(rhs.getValue());
+        if (c != 0 || !lhs.isLiteral())
+            return c < 0;
+        if (!lhs.getLanguage().empty() || !rhs.getLanguage().empty())
+            return lhs.getLanguage() < rhs.getLanguage();
+        return lhs.getDatatype() < rhs.getDatatype();
     }
 
     bool NodePtrLess::operator()(const std::shared_ptr<Node> &lhs, const std::shared_ptr<Node> &rhs) const {
-        if(lhs->isIRI()) {
-            if(!rhs->isIRI())
-                return false;
-        }
-        else if (lhs->isBlankNode()) {
-            if(rhs->isIRI())
-                return true;
-            else if(rhs->isLiteral())
-                return false;
-        }
-        else if(lhs->isLiteral()) {
-            if(rhs->isIRI() || rhs->isBlankNode())
-                return true;
-            else {
-                // lhs and rhs are literals
-                if(lhs->getValue() != rhs->getValue()) {
-                    return lhs->getValue() < rhs->getValue();
-                }
-                else {
-                    if (!lhs->getLanguage().empty() || !rhs->getLanguage().empty())
-                        return lhs->getLanguage() < rhs->getLanguage();
-                    else
-                        return lhs->getDatatype() < rhs->getDatatype();
-                }
-            }
-        }
-        return lhs->getValue() < rhs->getValue();
+        NodeLess less;
+        return less(*lhs, *rhs);
     }
 
     bool NodePtrEquals::operator()(const std::shared_ptr<Node> &lhs, const std::shared_ptr<Node> &rhs) const {
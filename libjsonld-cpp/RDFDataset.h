@@ -5,6 +5,11 @@
 #include "JsonLdConsts.h"
 #include "JsonLdOptions.h"
 #include "UniqueNamer.h"
+#include "TermDictionary.h"
+#include "Term.h"
+#include "QuadStore.h"
+#include "Arena.h"
+#include "NodeMap.h"
 #include <memory>
 #include <string>
 #include <iostream>
@@ -13,23 +18,44 @@
 
 namespace RDF {
 
+    /**
+     * A Node is a Term together with the dictionary it was interned in, so that it can be
+     * used on its own. Literal, IRI and BlankNode only differ in how they are constructed.
+     *
+     * Nodes constructed from strings alone, without a dictionary, are detached: they keep
+     * their strings themselves, have no dictionary, and only the kind of their Term is
+     * meaningful.
+     */
     class Node {
     protected:
-        nlohmann::json map;
+        // null if the node is detached
+        std::shared_ptr<TermDictionary> dictionary;
+        Term term;
+        // the strings of a detached node
+        std::string value;
+        std::string datatype;
+        std::string language;
+
+        Node(Term::Kind kind, std::string value, std::string datatype, std::string language);
 
     public:
-        Node();
-        virtual ~Node();
+        Node(std::shared_ptr<TermDictionary> dictionary, const Term & term);
 
-        virtual bool isLiteral() const = 0;
-        virtual bool isIRI() const = 0;
-        virtual bool isBlankNode() const = 0;
+        bool isLiteral() const { return term.isLiteral(); }
+        bool isIRI() const { return term.isIRI(); }
+        bool isBlankNode() const { return term.isBlankNode(); }
 
-        std::string getDatatype() const;
-        std::string getLanguage() const;
-        std::string getValue() const;
+        const std::string & getDatatype() const;
+        const std::string & getLanguage() const;
+        const std::string & getValue() const;
         void setValue(const std::string & s); // todo: only used in one place. make a friend?
 
+        const Term & getTerm() const { return term; }
+        TermId getValueId() const { return term.value; }
+        TermId getDatatypeId() const { return term.datatype; }
+        TermId getLanguageId() const { return term.language; }
+        const std::shared_ptr<TermDictionary> & getDictionary() const { return dictionary; }
+
         friend bool operator==(const Node& lhs, const Node& rhs);
         friend bool operator!=(const Node& lhs, const Node& rhs);
 
@@ -46,28 +72,20 @@ namespace RDF {
     class Literal : public Node {
     public:
         explicit Literal(const std::string& value, std::string * datatype = nullptr, std::string * language = nullptr);
-
-        bool isLiteral() const override;
-        bool isIRI() const override;
-        bool isBlankNode() const override;
+        Literal(std::shared_ptr<TermDictionary> dictionary, const std::string& value,
+                const std::string * datatype, const std::string * language);
     };
 
     class IRI : public Node {
     public:
         explicit IRI(const std::string& iri);
-
-        bool isLiteral() const override;
-        bool isIRI() const override;
-        bool isBlankNode() const override;
+        IRI(std::shared_ptr<TermDictionary> dictionary, const std::string& iri);
     };
 
     class BlankNode : public Node {
     public:
         explicit BlankNode(const std::string& attribute);
-
-        bool isLiteral() const override;
-        bool isIRI() const override;
-        bool isBlankNode() const override;
+        BlankNode(std::shared_ptr<TermDictionary> dictionary, const std::string& attribute);
     };
 
 
@@ -97,30 +115,35 @@ namespace RDF {
     class Quad {
     private:
 
-        std::map<std::string, std::shared_ptr<Node>> map;
+        std::shared_ptr<Node> subject;
+        std::shared_ptr<Node> predicate;
+        std::shared_ptr<Node> object;
+        std::shared_ptr<Node> graph;
 
-        void setSubject(std::shared_ptr<Node> subject) { map["subject"] = std::move(subject); }
-        void setPredicate(std::shared_ptr<Node> predicate)  { map["predicate"] = std::move(predicate); }
-        void setObject(std::shared_ptr<Node> object)  { map["object"] = std::move(object); }
+        void setSubject(std::shared_ptr<Node> isubject) { subject = std::move(isubject); }
+        void setPredicate(std::shared_ptr<Node> ipredicate)  { predicate = std::move(ipredicate); }
+        void setObject(std::shared_ptr<Node> iobject)  { object = std::move(iobject); }
 
-        void init( std::string subject,  std::string predicate,  std::shared_ptr<Node> object,
-                   std::string * graph);
+        void init(std::string subject, std::string predicate, std::shared_ptr<Node> object,
+                  const std::string * graph);
 
     public:
 
         Quad(std::shared_ptr<Node> subject, std::shared_ptr<Node> predicate, std::shared_ptr<Node> object,
-             std::string * graph);
+             const std::string * graph);
+
+        // build a quad of detached nodes
 
-        Quad( std::string subject,  std::string predicate,  std::string object, std::string * graph);
+        Quad( std::string subject,  std::string predicate,  std::string object, const std::string * graph);
 
         Quad( std::string subject,  std::string predicate,  const std::string& value,
-              std::string datatype,  std::string language,  std::string * graph);
+              std::string datatype,  std::string language,  const std::string * graph);
 
-        std::shared_ptr<Node> getPredicate() const;
-        std::shared_ptr<Node> getObject() const;
-        std::shared_ptr<Node> getSubject() const;
+        const std::shared_ptr<Node> & getPredicate() const { return predicate; }
+        const std::shared_ptr<Node> & getObject() const { return object; }
+        const std::shared_ptr<Node> & getSubject() const { return subject; }
 
-        std::shared_ptr<Node> getGraph() const;
+        const std::shared_ptr<Node> & getGraph() const { return graph; }
         void setGraph(const std::string *graph);
 
         friend bool operator==(const Quad &lhs, const Quad &rhs);
@@ -153,23 +176,87 @@ namespace RDF {
         typedef std::map<std::string, std::string> StringMap;
 
     private:
-        VectorMap vectorMap;
+        std::shared_ptr<TermDictionary> termDictionary;
+        QuadStore quadStore;
+        // the quads of each graph are stored contiguously, at [first, second) in quadStore
+        std::map<std::string, std::pair<size_t, size_t>> graphRanges;
 
-        std::shared_ptr<Node> objectToRDF(nlohmann::json item);
+        template<typename JSON>
+        bool objectToRDF(const JSON & item, Term & object);
+        Term graphNameToTerm(const std::string & graphName);
+        // the number of quads that belong to a graph; the rest were appended since
+        size_t insertedSize() const;
 
     public:
         JsonLdOptions options;
         UniqueNamer *blankNodeUniqueNamer;
 
-        RDFDataset(JsonLdOptions options, UniqueNamer *blankNodeUniqueNamer);
-
-        VectorMap::mapped_type & at(const VectorMap::key_type& s);
-        std::pair<VectorMap::iterator,bool> insert( const VectorMap::value_type& value );
-
-        void graphToRDF(std::string &graphName, const nlohmann::json & graph);
+        /**
+         * Creates an empty dataset. Terms are interned in the given dictionary, which
+         * may be shared with other datasets, or in a new dictionary if none is given.
+         */
+        RDFDataset(JsonLdOptions options, UniqueNamer *blankNodeUniqueNamer,
+                   std::shared_ptr<TermDictionary> termDictionary = nullptr);
+
+        const std::shared_ptr<TermDictionary> & getTermDictionary() const;
+
+        /**
+         * Adds the quads of a graph to the dataset, unless the dataset already has a graph
+         * with that name.
+         *
+         * @return true if the quads were added
+         */
+        bool insert( const VectorMap::value_type& value );
+
+        /**
+         * Adds quads whose terms are interned in this dataset's dictionary. Same as
+         * appending each of them and calling insertAppended().
+         */
+        void insert(const QuadStore & quads);
+
+        /**
+         * Appends a quad whose terms are interned in this dataset's dictionary, such as
+         * one read by an NQuadsParser, to the end of the quad store. It belongs to no
+         * graph until insertAppended() is called, and no other quads may be inserted
+         * before then.
+         */
+        void appendQuad(const Term & subject, const Term & predicate, const Term & object, const Term & graph);
+
+        /**
+         * Adds the quads appended since the last insert to their graphs, in place. Each
+         * graph's quads are kept together and in the order they were appended, after the
+         * quads the graph already had, and duplicates are dropped. Unlike with
+         * insert(const VectorMap::value_type&), quads of graphs the dataset already has
+         * are merged into them.
+         */
+        void insertAppended();
+
+        /**
+         * Drops the quads appended since the last insert.
+         */
+        void dropAppended();
+
+        /**
+         * Adds the quads of a graph of a node map, unless the dataset already has a graph
+         * with that name. The node map must intern its ids in this dataset's dictionary.
+         */
+        void graphToRDF(const NodeMap::Graph & graph);
 
         std::set<std::string> graphNames() const;
+
+        /**
+         * Returns copies of the quads of a graph. Prefer getQuadStore() and getGraphRange()
+         * for scanning large datasets.
+         */
         std::vector<Quad> getQuads(const std::string & graphName) const;
+
+        const QuadStore & getQuadStore() const;
+
+        /**
+         * Returns the [first, second) positions of the quads of a graph in the quad store,
+         * or an empty range if the dataset has no such graph.
+         */
+        std::pair<size_t, size_t> getGraphRange(const std::string & graphName) const;
     };
 
 }
@@ -1,31 +1,183 @@
 #include "RDFDatasetUtils.h"
+#include "NQuadsWriter.h"
 
 #include <string>
 #include <sstream>
 #include <vector>
-#include <iomanip>
 
-std::string RDFDatasetUtils::toNQuads(const RDF::RDFDataset &dataset) {
-    std::stringstream ss;
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+    // the strings that make up one term of a quad, wherever they are stored
+    struct TermStrings {
+        const RDF::Term * term;
+        RDF::Term::Kind kind;
+        const std::string * value;
+        const std::string * datatype;
+        const std::string * language;
+    };
+
+    TermStrings termStrings(const RDF::Node & node) {
+        return { &node.getTerm(), node.getTerm().kind, &node.getValue(), &node.getDatatype(), &node.getLanguage() };
+    }
+
+    TermStrings termStrings(const RDF::TermDictionary & dictionary, const RDF::Term & term) {
+        return { &term, term.kind, &dictionary.get(term.value), &dictionary.get(term.datatype),
+                 &dictionary.get(term.language) };
+    }
 
-    std::vector<std::string> quads;
+    // writes blank nodes as they are labelled
+    struct PlainLabels {
+        void node(std::string & out, const TermStrings & t) const { out += *t.value; }
+        void graph(std::string & out, const std::string & graphName) const { out += graphName; }
+    };
 
-    for (auto graphName : dataset.graphNames()) {
-        std::vector<RDF::Quad> triples = dataset.getQuads(graphName);
-        std::string *graphNamePtr = &graphName;
-        if (graphName == "@default") {
-            graphNamePtr = nullptr;
+    // writes blank nodes as _:a if their label is bnode and as _:z otherwise, and blank
+    // node graph names as _:g, as normalization hashes them
+    struct NormalizationLabels {
+        const std::string & bnode;
+
+        void node(std::string & out, const TermStrings & t) const { out += (*t.value == bnode) ? "_:a" : "_:z"; }
+        void graph(std::string & out, const std::string &) const { out += "_:g"; }
+    };
+
+    // writes nothing where blank nodes go, calling gap instead
+    struct Gaps {
+        const RDF::Term & graphTerm;
+        const std::function<void(const RDF::Term &, bool)> & gap;
+
+        void node(std::string &, const TermStrings & t) const { gap(*t.term, false); }
+        void graph(std::string & out, const std::string & graphName) const {
+            if (graphTerm.isBlankNode())
+                gap(graphTerm, true);
+            else
+                out += graphName;
         }
-        for (const auto& triple : triples) {
-            quads.push_back(toNQuad(triple, graphNamePtr));
+    };
+
+    template<typename Labels, void (*escape)(const std::string &, std::string &) = RDFDatasetUtils::escape>
+    void writeNQuad(std::string & out, const TermStrings & s, const TermStrings & p, const TermStrings & o,
+                    const std::string *graphName, const Labels & labels) {
+
+        // subject is an IRI or bnode
+        if (s.kind == RDF::Term::Kind::IRI) {
+            out += "<";
+            escape(*s.value, out);
+            out += ">";
+        } else {
+            labels.node(out, s);
         }
+
+        if (p.kind == RDF::Term::Kind::IRI) {
+            out += " <";
+            escape(*p.value, out);
+            out += "> ";
+        }
+            // otherwise it must be a bnode (TODO: can we only allow this if the flag is set in options?)
+        else {
+            out += " ";
+            escape(*p.value, out);
+            out += " ";
+        }
+
+        // object is IRI, bnode or literal
+        if (o.kind == RDF::Term::Kind::IRI) {
+            out += "<";
+            escape(*o.value, out);
+            out += ">";
+        } else if (o.kind == RDF::Term::Kind::BlankNode) {
+            labels.node(out, o);
+        } else {
+            out += "\"";
+            escape(*o.value, out);
+            out += "\"";
+            if (*o.datatype == JsonLdConsts::RDF_LANGSTRING) {
+                out += "@";
+                out += *o.language;
+            } else if (*o.datatype != JsonLdConsts::XSD_STRING) {
+                out += "^^<";
+                escape(*o.datatype, out);
+                out += ">";
+            }
+        }
+
+        // graph
+        if (graphName != nullptr) {
+            if (graphName->find_first_of("_:") != 0) {
+                out += " <";
+                escape(*graphName, out);
+                out += ">";
+            } else {
+                out += " ";
+                labels.graph(out, *graphName);
+            }
+        }
+
+        out += " .\n";
     }
-    std::sort(quads.begin(), quads.end());
-    for (const auto& quad : quads) {
-        ss << quad;
+
+}
+
+std::string RDFDatasetUtils::toNQuads(const RDF::RDFDataset &dataset) {
+    std::string nquads;
+    RDF::NQuadsWriter writer([&nquads](const char * data, size_t size) { nquads.append(data, size); });
+    writer.write(dataset);
+    return nquads;
+}
+
+void RDFDatasetUtils::appendNQuad(const RDF::RDFDataset &dataset, size_t index, std::string &out) {
+    const RDF::QuadStore & store = dataset.getQuadStore();
+    const RDF::TermDictionary & dictionary = *dataset.getTermDictionary();
+
+    const RDF::Term & graph = store.getGraph(index);
+    const std::string *graphName = RDF::QuadStore::isDefaultGraph(graph) ? nullptr : &dictionary.get(graph.value);
+    writeNQuad(out,
+               termStrings(dictionary, store.getSubject(index)),
+               termStrings(dictionary, store.getPredicate(index)),
+               termStrings(dictionary, store.getObject(index)),
+               graphName, PlainLabels());
+}
+
+void RDFDatasetUtils::appendNQuad(const RDF::RDFDataset &dataset, size_t index, std::string &out,
+                                  const std::function<const std::string &(RDF::TermId)> &relabel) {
+    const RDF::QuadStore & store = dataset.getQuadStore();
+    const RDF::TermDictionary & dictionary = *dataset.getTermDictionary();
+
+    TermStrings t[3] = {termStrings(dictionary, store.getSubject(index)),
+                        termStrings(dictionary, store.getPredicate(index)),
+                        termStrings(dictionary, store.getObject(index))};
+    const RDF::Term * terms[3] = {&store.getSubject(index), &store.getPredicate(index), &store.getObject(index)};
+    for (int k = 0; k < 3; k++) {
+        if (terms[k]->isBlankNode())
+            t[k].value = &relabel(terms[k]->value);
     }
 
-    return ss.str();
+    const RDF::Term & graph = store.getGraph(index);
+    const std::string *graphName = nullptr;
+    if (graph.isBlankNode())
+        graphName = &relabel(graph.value);
+    else if (!RDF::QuadStore::isDefaultGraph(graph))
+        graphName = &dictionary.get(graph.value);
+    writeNQuad(out, t[0], t[1], t[2], graphName, PlainLabels());
+}
+
+void RDFDatasetUtils::appendNQuadWithGaps(const RDF::RDFDataset &dataset, size_t index, std::string &out,
+                                         const std::function<void(const RDF::Term &, bool)> &gap) {
+    const RDF::QuadStore & store = dataset.getQuadStore();
+    const RDF::TermDictionary & dictionary = *dataset.getTermDictionary();
+
+    const RDF::Term & graph = store.getGraph(index);
+    const std::string *graphName = RDF::QuadStore::isDefaultGraph(graph) ? nullptr : &dictionary.get(graph.value);
+    writeNQuad<Gaps, RDFDatasetUtils::escapeCanonical>(out,
+                                                       termStrings(dictionary, store.getSubject(index)),
+                                                       termStrings(dictionary, store.getPredicate(index)),
+                                                       termStrings(dictionary, store.getObject(index)),
+                                                       graphName, Gaps{graph, gap});
 }
 
 std::string RDFDatasetUtils::toNQuad(const RDF::Quad& triple, std::string *graphName) {
@@ -33,144 +185,204 @@ std::string RDFDatasetUtils::toNQuad(const RDF::Quad& triple, std::string *graph
 }
 
 std::string RDFDatasetUtils::toNQuad(const RDF::Quad& triple, std::string *graphName, std::string *bnode) {
-    std::stringstream ss;
+    std::string out;
+    appendNQuad(triple, graphName, bnode, out);
+    return out;
+}
 
-    std::shared_ptr<RDF::Node> s = triple.getSubject();
-    std::shared_ptr<RDF::Node> p = triple.getPredicate();
-    std::shared_ptr<RDF::Node> o = triple.getObject();
+void RDFDatasetUtils::appendNQuad(const RDF::Quad& triple, const std::string *graphName, const std::string *bnode,
+                                  std::string& out) {
+    TermStrings s = termStrings(*triple.getSubject());
+    TermStrings p = termStrings(*triple.getPredicate());
+    TermStrings o = termStrings(*triple.getObject());
+    // normalization mode
+    if (bnode != nullptr)
+        writeNQuad(out, s, p, o, graphName, NormalizationLabels{*bnode});
+    // normal mode
+    else
+        writeNQuad(out, s, p, o, graphName, PlainLabels());
+}
 
-    // subject is an IRI or bnode
-    if (s->isIRI()) {
-        ss << "<";
-        escape(s->getValue(), ss);
-        ss << ">";
-    }
-        // normalization mode
-    else if (bnode != nullptr) {
-        ss << ((s->getValue() == *bnode)  ? "_:a" : "_:z");
-    }
-        // normal mode
-    else {
-        ss << s->getValue();
-    }
+namespace {
 
-    if (p->isIRI()) {
-        ss << " <";
-        escape(p->getValue(), ss);
-        ss << "> ";
+    // Bytes that escape() has to look at: the C0 controls, '"', '\\', DEL, and 0xC2,
+    // the lead byte of the two-byte UTF-8 sequences for U+0080 to U+00BF, which
+    // include the C1 controls and U+00A0. All other bytes, including the rest of
+    // multibyte UTF-8 sequences, are copied as is.
+    inline bool isSpecial(unsigned char c) {
+        return c < 0x20 || c == '"' || c == '\\' || c == 0x7F || c == 0xC2;
     }
-        // otherwise it must be a bnode (TODO: can we only allow this if the flag is set in options?)
-    else {
-        ss << " ";
-        escape(p->getValue(), ss);
-        ss << " ";
+
+    const char * findSpecialScalar(const char * p, const char * end) {
+        while (p != end && !isSpecial(static_cast<unsigned char>(*p)))
+            ++p;
+        return p;
     }
 
-    // object is IRI, bnode or literal
-    if (o->isIRI()) {
-        ss << "<";
-        escape(o->getValue(), ss);
-        ss << ">";
-    } else if (o->isBlankNode()) {
-        // normalization mode
-        if (bnode != nullptr) {
-            ss << ((o->getValue() == *bnode)  ? "_:a" : "_:z");
-        }
-        // normal mode
-        else {
-            ss << o->getValue();
-        }
-    } else {
-        ss << "\"";
-        escape(o->getValue(), ss);
-        ss << "\"";
-        if (o->getDatatype() == JsonLdConsts::RDF_LANGSTRING) {
-            ss << "@";
-            ss << o->getLanguage();
-        } else if (o->getDatatype() != JsonLdConsts::XSD_STRING) {
-            ss << "^^<";
-            escape(o->getDatatype(), ss);
-            ss << ">";
+#if defined(__AVX2__)
+    const char * findSpecialSimd(const char * p, const char * end) {
+        const __m256i controlMax = _mm256_set1_epi8(0x1F);
+        const __m256i quote = _mm256_set1_epi8('"');
+        const __m256i backslash = _mm256_set1_epi8('\\');
+        const __m256i del = _mm256_set1_epi8(0x7F);
+        const __m256i c2 = _mm256_set1_epi8(static_cast<char>(0xC2));
+        while (end - p >= 32) {
+            __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            // unsigned chunk <= 0x1F
+            __m256i special = _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, controlMax), chunk);
+            special = _mm256_or_si256(special, _mm256_cmpeq_epi8(chunk, quote));
+            special = _mm256_or_si256(special, _mm256_cmpeq_epi8(chunk, backslash));
+            special = _mm256_or_si256(special, _mm256_cmpeq_epi8(chunk, del));
+            special = _mm256_or_si256(special, _mm256_cmpeq_epi8(chunk, c2));
+            auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(special));
+            if (mask != 0)
+                return p + __builtin_ctz(mask);
+            p += 32;
         }
+        return findSpecialScalar(p, end);
     }
-
-    // graph
-    if (graphName != nullptr) {
-        if (graphName->find_first_of("_:") != 0) {
-            ss << " <";
-            escape(*graphName, ss);
-            ss << ">";
-        } else if (bnode != nullptr) {
-            ss << " _:g";
-        } else {
-            ss << " ";
-            ss << *graphName;
+#elif defined(__SSE2__)
+    const char * findSpecialSimd(const char * p, const char * end) {
+        const __m128i controlMax = _mm_set1_epi8(0x1F);
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i del = _mm_set1_epi8(0x7F);
+        const __m128i c2 = _mm_set1_epi8(static_cast<char>(0xC2));
+        while (end - p >= 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            // unsigned chunk <= 0x1F
+            __m128i special = _mm_cmpeq_epi8(_mm_min_epu8(chunk, controlMax), chunk);
+            special = _mm_or_si128(special, _mm_cmpeq_epi8(chunk, quote));
+            special = _mm_or_si128(special, _mm_cmpeq_epi8(chunk, backslash));
+            special = _mm_or_si128(special, _mm_cmpeq_epi8(chunk, del));
+            special = _mm_or_si128(special, _mm_cmpeq_epi8(chunk, c2));
+            auto mask = static_cast<uint32_t>(_mm_movemask_epi8(special));
+            if (mask != 0)
+                return p + __builtin_ctz(mask);
+            p += 16;
         }
+        return findSpecialScalar(p, end);
     }
+#else
+    const char * findSpecialSimd(const char * p, const char * end) {
+        return findSpecialScalar(p, end);
+    }
+#endif
 
-    ss << " .\n";
-
-    return ss.str();
-}
+    void appendUnicodeEscape(unsigned int codePoint, std::string & out) {
+        static const char hex[] = "0123456789ABCDEF";
+        char escaped[6] = { '\\', 'u',
+                            hex[(codePoint >> 12) & 0xF], hex[(codePoint >> 8) & 0xF],
+                            hex[(codePoint >> 4) & 0xF], hex[codePoint & 0xF] };
+        out.append(escaped, sizeof(escaped));
+    }
 
-bool RDFDatasetUtils::isHighSurrogate(char c) {
-    return false;
-}
+    // canonical selects the escapes of canonical N-Quads, which write U+0080 to U+00A0
+    // as they are
+    template<const char * (*findSpecial)(const char *, const char *), bool canonical>
+    void escapeWith(const std::string & str, std::string & out) {
+        const char * p = str.data();
+        const char * end = p + str.size();
+        while (p != end) {
+            // copy the run of bytes that need no escaping in one go
+            const char * special = findSpecial(p, end);
+            out.append(p, static_cast<size_t>(special - p));
+            if (special == end)
+                break;
+            p = special;
 
-/**
- * Escapes the given string according to the N-Quads escape rules
- *
- * @param str
- *            The string to escape
- * @param ss
- *            The stringstream to append to.
- */
-void RDFDatasetUtils::escape(const std::string& str, std::stringstream & ss) {
-    for (char hi : str) {
-        if (hi <= 0x8 || hi == 0xB || hi == 0xC ||
-            (hi >= 0xE && hi <= 0x1F) ||
-            (hi >= 0x7F && hi <= 0xA0) // 0xA0 is end of non-printable latin-1 supplement characters
-//            ||
-//            (hi >= 0x24F // 0x24F is the end of latin extensions
-//            && !isHighSurrogate(hi))
-            ) {
-            ss << "\\u";
-            ss << std::setfill('0') << std::setw(4) << hi; //%04x", (int) hi));
-        }
-//        else if (Character.isHighSurrogate(hi)) {
-//            final char lo = str.charAt(++i);
-//            final int c = (hi << 10) + lo + (0x10000 - (0xD800 << 10) - 0xDC00);
-//            rval.append(String.format("\\U%08x", c));
-//        }
-        else {
-            switch (hi) {
-                case '\b':
-                    ss << "\\b";
-                    break;
+            auto c = static_cast<unsigned char>(*p);
+            switch (c) {
                 case '\n':
-                    ss << "\\n";
+                    out += "\\n";
                     break;
                 case '\t':
-                    ss << "\\t";
+                    out += "\\t";
                     break;
-//                case '\f':
-//                    ss << "\\f";
-//                    break;
                 case '\r':
-                    ss << "\\r";
+                    out += "\\r";
+                    break;
+                case '\b':
+                    out += "\\b";
                     break;
-                case '\"':
-                    ss << "\\\"";
+                case '\f':
+                    out += "\\f";
+                    break;
+                case '"':
+                    out += "\\\"";
                     break;
                 case '\\':
-                    ss << "\\\\";
+                    out += "\\\\";
+                    break;
+                case 0xC2: {
+                    auto next = p + 1 != end ? static_cast<unsigned char>(p[1]) : 0;
+                    // U+0080 to U+00A0: the C1 controls and the no-break space
+                    if (!canonical && next >= 0x80 && next <= 0xA0) {
+                        appendUnicodeEscape(next, out);
+                        p++;
+                    } else {
+                        out += *p;
+                    }
                     break;
+                }
                 default:
-                    // just put the char as is
-                    ss << hi;
+                    // the other C0 controls, and DEL
+                    appendUnicodeEscape(c, out);
                     break;
             }
+            p++;
         }
     }
+
+}
+
+/**
+ * Escapes the given string according to the N-Quads escape rules
+ *
+ * @param str
+ *            The string to escape
+ * @param ss
+ *            The stringstream to append to.
+ */
+void RDFDatasetUtils::escape(const std::string& str, std::stringstream & ss) {
+    std::string out;
+    escape(str, out);
+    ss << out;
 }
 
+/**
+ * Escapes the given string according to the N-Quads escape rules.
+ *
+ * The string is UTF-8. Quotes, backslashes, tab, backspace, newline, carriage return
+ * and form feed use their short escapes, the other C0 and C1 controls, DEL and U+00A0 are written as
+ * \uXXXX, and all other characters are copied as they are.
+ *
+ * @param str
+ *            The string to escape
+ * @param out
+ *            The string to append to.
+ */
+void RDFDatasetUtils::escape(const std::string& str, std::string & out) {
+    escapeWith<findSpecialSimd, false>(str, out);
+}
+
+void RDFDatasetUtils::escapeScalar(const std::string& str, std::string & out) {
+    escapeWith<findSpecialScalar, false>(str, out);
+}
+
+/**
+ * Escapes the given string the way canonical N-Quads do, as URDNA2015 hashes and
+ * outputs them.
+ *
+ * Quotes, backslashes, tab, backspace, newline, carriage return and form feed use
+ * their short escapes, the other C0 controls and DEL are written as \uXXXX, and all
+ * other characters, U+0080 to U+00A0 included, are copied as they are.
+ *
+ * @param str
+ *            The string to escape
+ * @param out
+ *            The string to append to.
+ */
+void RDFDatasetUtils::escapeCanonical(const std::string& str, std::string & out) {
+    escapeWith<findSpecialSimd, true>(str, out);
+}
@@ -2,17 +2,63 @@
 #define LIBJSONLD_CPP_RDFDATASETUTILS_H
 
 #include "RDFDataset.h"
+#include <functional>
 
 namespace RDFDatasetUtils {
+    /**
+     * @return the quads of the dataset in N-Quads format, sorted
+     */
     std::string toNQuads(const RDF::RDFDataset& dataset);
 
+    /**
+     * Appends the quad at the given index of the dataset's QuadStore to out, in
+     * N-Quads format.
+     */
+    void appendNQuad(const RDF::RDFDataset& dataset, size_t index, std::string& out);
+
+    /**
+     * Same as appendNQuad(dataset, index, out), writing each blank node as the label
+     * relabel returns for the id of its own label.
+     */
+    void appendNQuad(const RDF::RDFDataset& dataset, size_t index, std::string& out,
+                     const std::function<const std::string &(RDF::TermId)>& relabel);
+
+    /**
+     * Same as appendNQuad(dataset, index, out), leaving out blank nodes and blank node
+     * graph names. Where one would go, calls gap(term, isGraphName) instead, with out
+     * written up to that point. Strings are escaped with escapeCanonical(), as the
+     * quads are for canonicalization.
+     */
+    void appendNQuadWithGaps(const RDF::RDFDataset& dataset, size_t index, std::string& out,
+                             const std::function<void(const RDF::Term &, bool)>& gap);
+
     std::string toNQuad(const RDF::Quad& triple, std::string *graphName);
 
+    /**
+     * Appends the quad to out in N-Quads format. If bnode is not null, blank nodes are
+     * written as _:a if they are bnode and as _:z otherwise, and blank node graph names
+     * as _:g.
+     */
+    void appendNQuad(const RDF::Quad& triple, const std::string *graphName, const std::string *bnode,
+                     std::string& out);
+
     std::string toNQuad(const RDF::Quad& triple, std::string *graphName, std::string *bnode);
 
     void escape(const std::string& str, std::stringstream & ss);
 
-    bool isHighSurrogate(char c);
+    void escape(const std::string& str, std::string & out);
+
+    /**
+     * Same as escape(), scanning the string one byte at a time instead of with SIMD
+     * instructions. This is what escape() falls back to on targets without SSE2.
+     */
+    void escapeScalar(const std::string& str, std::string & out);
+
+    /**
+     * Same as escape(), with the escapes of canonical N-Quads: U+0080 to U+00A0 are
+     * copied as they are instead of written as \uXXXX.
+     */
+    void escapeCanonical(const std::string& str, std::string & out);
 }
 
 #endif //LIBJSONLD_CPP_RDFDATASETUTILS_H
@@ -3,6 +3,10 @@
 #include <utility>
 
 RemoteDocument::RemoteDocument(std::string iurl, nlohmann::json idocument)
+: url(std::move(iurl)), document(std::make_shared<const nlohmann::json>(std::move(idocument)))
+{}
+
+RemoteDocument::RemoteDocument(std::string iurl, std::shared_ptr<const nlohmann::json> idocument)
 : url(std::move(iurl)), document(std::move(idocument))
 {}
 
@@ -11,6 +15,10 @@ const std::string &RemoteDocument::getUrl() const {
 }
 
 const nlohmann::json &RemoteDocument::getDocument() const {
+    return *document;
+}
+
+const std::shared_ptr<const nlohmann::json> &RemoteDocument::getDocumentPtr() const {
     return document;
 }
 
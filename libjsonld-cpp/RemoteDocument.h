@@ -2,18 +2,21 @@
 #define JSONLD_CPP_REMOTEDOCUMENT_H
 
 #include "jsoninc.h"
+#include <memory>
 #include <string>
 
 class RemoteDocument {
 private:
     std::string url;
-    nlohmann::json document;
+    std::shared_ptr<const nlohmann::json> document;
 
 public:
     RemoteDocument(std::string url, nlohmann::json document);
+    RemoteDocument(std::string url, std::shared_ptr<const nlohmann::json> document);
 
     const std::string &getUrl() const;
     const nlohmann::json &getDocument() const;
+    const std::shared_ptr<const nlohmann::json> &getDocumentPtr() const;
 };
 
 #endif //JSONLD_CPP_REMOTEDOCUMENT_H
@@ -0,0 +1,73 @@
+#include "Term.h"
+#include "JsonLdConsts.h"
+
+namespace RDF {
+
+    namespace {
+
+        // ids from the same dictionary only need their strings compared when they differ
+        int compareIds(const TermDictionary & ld, TermId lid, const TermDictionary & rd, TermId rid) {
+            if (&ld == &rd && lid == rid)
+                return 0;
+            return ld.get(lid).compare(rd.get(rid));
+        }
+
+    }
+
+    Term Term::defaultGraph() {
+        Term t;
+        t.kind = Kind::DefaultGraph;
+        return t;
+    }
+
+    Term Term::iri(TermDictionary &dictionary, const std::string &iri) {
+        Term t;
+        t.kind = Kind::IRI;
+        t.value = dictionary.intern(iri);
+        return t;
+    }
+
+    Term Term::blankNode(TermDictionary &dictionary, const std::string &label) {
+        Term t;
+        t.kind = Kind::BlankNode;
+        t.value = dictionary.intern(label);
+        return t;
+    }
+
+    Term Term::literal(TermDictionary &dictionary, const std::string &value,
+                       const std::string *datatype, const std::string *language) {
+        Term t;
+        t.kind = Kind::Literal;
+        t.value = dictionary.intern(value);
+        t.datatype = datatype != nullptr ?
+                dictionary.intern(*datatype) : dictionary.intern(JsonLdConsts::XSD_STRING);
+        if (language != nullptr)
+            t.language = dictionary.intern(*language);
+        return t;
+    }
+
+    bool operator==(const Term &lhs, const Term &rhs) {
+        return lhs.kind == rhs.kind && lhs.value == rhs.value &&
+               lhs.datatype == rhs.datatype && lhs.language == rhs.language;
+    }
+
+    bool operator!=(const Term &lhs, const Term &rhs) {
+        return !(lhs == rhs);
+    }
+
+    int compare(const TermDictionary &lhsDictionary, const Term &lhs,
+                const TermDictionary &rhsDictionary, const Term &rhs) {
+        if (lhs.kind != rhs.kind)
+            return lhs.kind < rhs.kind ? -1 : 1;
+
+        int c = compareIds(lhsDictionary, lhs.value, rhsDictionary, rhs.value);
+        if (c != 0 || !lhs.isLiteral())
+            return c;
+
+        // lhs and rhs are literals with the same value
+        if (lhs.language != TermDictionary::EMPTY || rhs.language != TermDictionary::EMPTY)
+            return compareIds(lhsDictionary, lhs.language, rhsDictionary, rhs.language);
+        return compareIds(lhsDictionary, lhs.datatype, rhsDictionary, rhs.datatype);
+    }
+
+}
@@ -0,0 +1,71 @@
+#ifndef LIBJSONLD_CPP_TERM_H
+#define LIBJSONLD_CPP_TERM_H
+
+#include "TermDictionary.h"
+#include <cstdint>
+#include <string>
+
+namespace RDF {
+
+    /**
+     * A compact, value-type RDF term: a kind tag plus the ids of the term's value and,
+     * for literals, its datatype and language tag. The ids refer to a TermDictionary,
+     * so a Term only has a meaning together with the dictionary it was interned in.
+     *
+     * Terms from the same dictionary are equal if and only if all their fields are equal.
+     */
+    struct Term {
+        // the numeric order of the kinds is also the sort order of terms:
+        // Literals < BlankNodes < IRIs. DefaultGraph is only ever the graph name of a quad
+        enum class Kind : std::uint8_t {
+            Literal = 0, BlankNode = 1, IRI = 2, DefaultGraph = 3
+        };
+
+        Kind kind = Kind::IRI;
+        TermId value = TermDictionary::EMPTY;
+        TermId datatype = TermDictionary::EMPTY;
+        TermId language = TermDictionary::EMPTY;
+
+        bool isLiteral() const { return kind == Kind::Literal; }
+        bool isIRI() const { return kind == Kind::IRI; }
+        bool isBlankNode() const { return kind == Kind::BlankNode; }
+        bool isDefaultGraph() const { return kind == Kind::DefaultGraph; }
+
+        static Term defaultGraph();
+        static Term iri(TermDictionary & dictionary, const std::string & iri);
+        static Term blankNode(TermDictionary & dictionary, const std::string & label);
+        // datatype defaults to xsd:string if null, language to none if null
+        static Term literal(TermDictionary & dictionary, const std::string & value,
+                            const std::string * datatype, const std::string * language);
+    };
+
+    bool operator==(const Term & lhs, const Term & rhs);
+    bool operator!=(const Term & lhs, const Term & rhs);
+
+    /**
+     * Three-way comparison of two terms in RDF sort order, which may come from different
+     * dictionaries. Literals with the same value are ordered by language if either of
+     * them has one, otherwise by datatype.
+     *
+     * @return a negative value, zero or a positive value if lhs is less than, equal to
+     *         or greater than rhs
+     */
+    int compare(const TermDictionary & lhsDictionary, const Term & lhs,
+                const TermDictionary & rhsDictionary, const Term & rhs);
+
+    /**
+     * Orders terms interned in a single dictionary.
+     */
+    struct TermLess {
+        const TermDictionary * dictionary;
+
+        explicit TermLess(const TermDictionary & idictionary) : dictionary(&idictionary) {}
+
+        bool operator()(const Term & lhs, const Term & rhs) const {
+            return compare(*dictionary, lhs, *dictionary, rhs) < 0;
+        }
+    };
+
+}
+
+#endif //LIBJSONLD_CPP_TERM_H
@@ -0,0 +1,40 @@
+#ifndef LIBJSONLD_CPP_TERMDEFINITION_H
+#define LIBJSONLD_CPP_TERMDEFINITION_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * The definition of a term in an active context, as created by the Create Term
+ * Definition algorithm:
+ *
+ * http://json-ld.org/spec/latest/json-ld-api/#create-term-definition
+ *
+ * A term explicitly mapped to null has a definition whose null flag is set, and whose
+ * other members are left empty.
+ */
+struct TermDefinition {
+    enum class TypeMapping : std::uint8_t {
+        None, Id, Vocab, Iri
+    };
+
+    enum class Container : std::uint8_t {
+        None, List, Set, Index, Language
+    };
+
+    bool null = false;
+    bool reverse = false;
+    // a term may have no IRI mapping, such as @type when it only sets a container
+    bool hasId = false;
+    std::string id;
+    TypeMapping typeMapping = TypeMapping::None;
+    // the IRI of the type mapping if it is TypeMapping::Iri
+    std::string type;
+    Container container = Container::None;
+    // a language mapping of null is stored as hasLanguage and nullLanguage
+    bool hasLanguage = false;
+    bool nullLanguage = false;
+    std::string language;
+};
+
+#endif //LIBJSONLD_CPP_TERMDEFINITION_H
@@ -0,0 +1,84 @@
+#include "TermDictionary.h"
+#include <cstring>
+
+namespace RDF {
+
+    const TermId TermDictionary::EMPTY;
+    const TermId TermDictionary::NOT_FOUND;
+
+    TermDictionary::TermDictionary() {
+        intern("");
+    }
+
+    size_t TermDictionary::KeyHash::operator()(const Key &key) const {
+        // 8 bytes at a time: terms are mostly IRIs, which are long
+        const uint64_t m = 0xc6a4a7935bd1e995ULL;
+        uint64_t h = 0x9e3779b97f4a7c15ULL ^ (key.size * m);
+        const char * p = key.data;
+        size_t n = key.size;
+        for (; n >= 8; p += 8, n -= 8) {
+            uint64_t k;
+            std::memcpy(&k, p, 8);
+            k *= m;
+            k ^= k >> 47;
+            h = (h ^ (k * m)) * m;
+        }
+        if (n > 0) {
+            uint64_t k = 0;
+            std::memcpy(&k, p, n);
+            h = (h ^ k) * m;
+        }
+        h ^= h >> 47;
+        h *= m;
+        h ^= h >> 47;
+        return static_cast<size_t>(h);
+    }
+
+    bool TermDictionary::KeyEqual::operator()(const Key &lhs, const Key &rhs) const {
+        return lhs.size == rhs.size && (lhs.size == 0 || std::memcmp(lhs.data, rhs.data, lhs.size) == 0);
+    }
+
+    /**
+     * Returns the id of the given string, adding it to the dictionary if it has not
+     * been seen before.
+     */
+    TermId TermDictionary::intern(const std::string &s) {
+        return intern(s.data(), s.size());
+    }
+
+    /**
+     * Returns the id of the string of size bytes at data, adding it to the dictionary
+     * if it has not been seen before. Only copies the string if it is new.
+     */
+    TermId TermDictionary::intern(const char *data, size_t size) {
+        auto it = ids.find(Key{data, size});
+        if (it != ids.end())
+            return it->second;
+        auto id = static_cast<TermId>(strings.size());
+        storage.emplace_back(data, size);
+        const std::string & stored = storage.back();
+        ids.insert(std::make_pair(Key{stored.data(), stored.size()}, id));
+        strings.push_back(&stored);
+        return id;
+    }
+
+    TermId TermDictionary::find(const std::string &s) const {
+        return find(s.data(), s.size());
+    }
+
+    TermId TermDictionary::find(const char *data, size_t size) const {
+        auto it = ids.find(Key{data, size});
+        if (it != ids.end())
+            return it->second;
+        return NOT_FOUND;
+    }
+
+    const std::string &TermDictionary::get(TermId id) const {
+        return *strings.at(id);
+    }
+
+    size_t TermDictionary::size() const {
+        return strings.size();
+    }
+
+}
@@ -0,0 +1,68 @@
+#ifndef LIBJSONLD_CPP_TERMDICTIONARY_H
+#define LIBJSONLD_CPP_TERMDICTIONARY_H
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace RDF {
+
+    typedef std::uint32_t TermId;
+
+    /**
+     * A TermDictionary interns the strings that make up RDF terms (IRIs, blank node
+     * labels, literal values, datatypes and language tags) and assigns each distinct
+     * string a dense integer id. Two strings interned in the same dictionary are equal
+     * if and only if their ids are equal.
+     *
+     * Interned strings are never removed, and references returned by get() stay valid
+     * for the lifetime of the dictionary.
+     *
+     * A TermDictionary is not synchronized. It may be shared by several datasets that
+     * are built one after the other, but must not be interned into from more than one
+     * thread at a time.
+     */
+    class TermDictionary {
+    private:
+        // a string that is not necessarily owned, so that lookups need not copy
+        struct Key {
+            const char * data;
+            size_t size;
+        };
+        struct KeyHash {
+            size_t operator()(const Key & key) const;
+        };
+        struct KeyEqual {
+            bool operator()(const Key & lhs, const Key & rhs) const;
+        };
+
+        // keys point into storage, which never moves its strings
+        std::unordered_map<Key, TermId, KeyHash, KeyEqual> ids;
+        std::deque<std::string> storage;
+        std::vector<const std::string *> strings;
+
+    public:
+        // id of the empty string, which is used for absent datatypes and languages
+        static const TermId EMPTY = 0;
+        // returned by find() if the string has not been interned
+        static const TermId NOT_FOUND = UINT32_MAX;
+
+        TermDictionary();
+
+        TermDictionary(const TermDictionary &) = delete;
+        TermDictionary & operator=(const TermDictionary &) = delete;
+
+        TermId intern(const std::string & s);
+        TermId intern(const char * data, size_t size);
+        TermId find(const std::string & s) const;
+        TermId find(const char * data, size_t size) const;
+        const std::string & get(TermId id) const;
+        size_t size() const;
+    };
+
+}
+
+#endif //LIBJSONLD_CPP_TERMDICTIONARY_H
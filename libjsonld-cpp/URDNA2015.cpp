@@ -0,0 +1,265 @@
+#include "URDNA2015.h"
+#include "ParallelUtils.h"
+#include "JsonLdError.h"
+#include <algorithm>
+
+namespace {
+
+    const std::string REFERENCE_LABEL = "_:a";
+    const std::string OTHER_LABEL = "_:z";
+
+    // whether a path that starts with path compares greater than chosenPath whatever
+    // follows, so can no longer be chosen over it. An empty chosenPath is none
+    bool cannotBeChosen(const std::string & path, const std::string & chosenPath) {
+        return !chosenPath.empty() && path.compare(0, path.size(), chosenPath, 0, path.size()) > 0;
+    }
+
+}
+
+namespace {
+
+    JsonLdOptions optionsFor(unsigned int threads, const std::string & hashAlgorithm) {
+        JsonLdOptions options;
+        options.setNormalizationThreads(threads);
+        options.setHashAlgorithm(hashAlgorithm);
+        return options;
+    }
+
+}
+
+URDNA2015::URDNA2015(const RDF::RDFDataset & idataset, unsigned int ithreads, std::string ihashAlgorithm)
+        : URDNA2015(idataset, optionsFor(ithreads, ihashAlgorithm)) {
+}
+
+URDNA2015::URDNA2015(const RDF::RDFDataset & idataset, const JsonLdOptions & options)
+        : dataset(idataset), quads(idataset.getQuadStore()), dictionary(*idataset.getTermDictionary()),
+          threads(ParallelUtils::threadCount(options.getNormalizationThreads())),
+          hashAlgorithm(options.getHashAlgorithm().empty() ? MessageDigest::SHA_256 : options.getHashAlgorithm()),
+          index(idataset), serializer(idataset), firstDegreeHashes(index.size()), canonicalIssuer("_:c14n"),
+          budget(options), firstDegreeDigest(MessageDigest::getInstance(hashAlgorithm)) {
+    if (firstDegreeDigest == nullptr)
+        throw JsonLdError(JsonLdError::UnknownFormat, hashAlgorithm);
+}
+
+const std::string & URDNA2015::label(NodeId id) const {
+    return dictionary.get(index.getLabel(id));
+}
+
+std::string URDNA2015::canonicalize() {
+    // 2) the index maps each blank node to the quads it appears in
+    // 3) and 4) the first degree hashes do not depend on any issued identifier, so
+    // one pass assigns all of them, and they can be computed at the same time
+    if (threads > 1) {
+        std::vector<RDF::CanonicalSerializer::Lines> scratch(threads);
+        std::vector<std::unique_ptr<MessageDigest>> digests(threads);
+        for (auto & md : digests)
+            md = MessageDigest::getInstance(hashAlgorithm);
+        ParallelUtils::parallelFor(index.size(), threads, [&](size_t i, unsigned int worker) {
+            firstDegreeHashes[i] = computeFirstDegreeHash(static_cast<NodeId>(i), scratch[worker], *digests[worker]);
+        });
+    }
+    std::map<std::string, std::vector<NodeId>> hashToBlankNodes;
+    for (size_t i = 0; i < index.size(); i++)
+        hashToBlankNodes[hashFirstDegreeQuads(static_cast<NodeId>(i))].push_back(static_cast<NodeId>(i));
+
+    // 5) issue canonical identifiers for the blank nodes with a unique hash
+    for (auto it = hashToBlankNodes.begin(); it != hashToBlankNodes.end();) {
+        if (it->second.size() == 1) {
+            canonicalIssuer.get(label(it->second.front()));
+            it = hashToBlankNodes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // 6) tell the others apart by the paths to their neighbours
+    for (const auto & entry : hashToBlankNodes) {
+        // 6.1) and 6.2.1)
+        std::vector<NodeId> members;
+        for (NodeId id : entry.second) {
+            if (!canonicalIssuer.exists(label(id)))
+                members.push_back(id);
+        }
+        // 6.2.2) to 6.2.4) nothing is issued until every member is hashed, so they can
+        // be hashed at the same time
+        std::vector<HashResult> hashPathList(members.size());
+        ParallelUtils::parallelFor(members.size(), threads, [&](size_t i, unsigned int) {
+            UniqueNamer issuer("_:b");
+            issuer.get(label(members[i]));
+            hashPathList[i] = hashNDegreeQuads(members[i], issuer, 0);
+        });
+        // 6.3)
+        std::stable_sort(hashPathList.begin(), hashPathList.end(),
+                         [](const HashResult & lhs, const HashResult & rhs) { return lhs.hash < rhs.hash; });
+        for (auto & result : hashPathList) {
+            for (const auto & existing : result.issuer.getKeys())
+                canonicalIssuer.get(existing);
+        }
+    }
+
+    // 7) relabel and serialize every quad
+    std::vector<std::string> canonicalLabels(index.size());
+    for (size_t i = 0; i < index.size(); i++)
+        canonicalLabels[i] = canonicalIssuer.get(label(static_cast<NodeId>(i)));
+    auto canonicalLabel = [this, &canonicalLabels](RDF::TermId id, bool) -> const std::string & {
+        return canonicalLabels[index.find(id)];
+    };
+    RDF::CanonicalSerializer::Lines nquads;
+    for (size_t i = 0; i < quads.size(); i++)
+        serializer.add(i, canonicalLabel, nquads);
+
+    // 8)
+    nquads.sort();
+    std::string result;
+    nquads.appendTo(result);
+    return result;
+}
+
+const std::string & URDNA2015::hashFirstDegreeQuads(NodeId id) {
+    std::string & hash = firstDegreeHashes[id];
+    if (hash.empty())
+        hash = computeFirstDegreeHash(id, firstDegreeLines, *firstDegreeDigest);
+    return hash;
+}
+
+std::string URDNA2015::computeFirstDegreeHash(NodeId id, RDF::CanonicalSerializer::Lines & lines,
+                                              MessageDigest & md) const {
+    // 1) to 3) serialize the quads of the blank node, labelling it _:a and any other
+    // blank node _:z
+    RDF::TermId idLabel = index.getLabel(id);
+    auto referenceLabel = [idLabel](RDF::TermId other, bool) -> const std::string & {
+        return other == idLabel ? REFERENCE_LABEL : OTHER_LABEL;
+    };
+    lines.clear();
+    for (size_t quad : index.getQuads(id))
+        serializer.add(quad, referenceLabel, lines);
+
+    // 4) and 5)
+    lines.sort();
+    lines.digest(md);
+    return md.digest();
+}
+
+std::string URDNA2015::relatedBlankNodeInput(NodeId related, size_t quad, UniqueNamer & issuer, char position) {
+    // 4)
+    std::string input(1, position);
+    // 5)
+    if (position != 'g') {
+        input += '<';
+        input += dictionary.get(quads.getPredicate(quad).value);
+        input += '>';
+    }
+    // 1) to 3) and 6)
+    const std::string & relatedLabel = label(related);
+    if (canonicalIssuer.exists(relatedLabel))
+        input += canonicalIssuer.get(relatedLabel);
+    else if (issuer.exists(relatedLabel))
+        input += issuer.get(relatedLabel);
+    else
+        input += hashFirstDegreeQuads(related);
+    return input;
+}
+
+URDNA2015::HashResult URDNA2015::hashNDegreeQuads(NodeId id, UniqueNamer issuer, size_t depth) {
+    budget.countHash(depth);
+
+    // 1) to 3) group the blank nodes next to this one by the hash of how they are related
+    RDF::TermId idLabel = index.getLabel(id);
+    std::vector<NodeId> relatedNodes;
+    std::vector<std::string> inputs;
+    for (size_t i : index.getQuads(id)) {
+        const RDF::Term * components[3] = {&quads.getSubject(i), &quads.getObject(i), &quads.getGraph(i)};
+        const char positions[3] = {'s', 'o', 'g'};
+        for (int k = 0; k < 3; k++) {
+            const RDF::Term & term = *components[k];
+            if (term.isBlankNode() && term.value != idLabel) {
+                NodeId related = index.find(term.value);
+                relatedNodes.push_back(related);
+                inputs.push_back(relatedBlankNodeInput(related, i, issuer, positions[k]));
+            }
+        }
+    }
+    // step 7 of Hash Related Blank Node, for all of them at once
+    std::unique_ptr<MessageDigest> md = MessageDigest::getInstance(hashAlgorithm);
+    std::vector<std::string> hashes(inputs.size());
+    md->digestEach(inputs.data(), inputs.size(), hashes.data());
+    std::map<std::string, std::vector<NodeId>> hashToRelated;
+    for (size_t i = 0; i < relatedNodes.size(); i++)
+        hashToRelated[hashes[i]].push_back(relatedNodes[i]);
+
+    // 4) and 5)
+    for (auto & entry : hashToRelated) {
+        // 5.1)
+        md->update(entry.first);
+        // 5.2) and 5.3)
+        std::string chosenPath;
+        UniqueNamer chosenIssuer;
+        // 5.4) the permutations of the related blank nodes, from the sorted one on
+        std::vector<NodeId> & permutation = entry.second;
+        std::sort(permutation.begin(), permutation.end());
+        do {
+            budget.countPermutation();
+            // 5.4.1) to 5.4.3)
+            UniqueNamer issuerCopy = issuer;
+            std::string path;
+            std::vector<NodeId> recursionList;
+            bool skip = false;
+
+            // 5.4.4)
+            for (NodeId related : permutation) {
+                const std::string & relatedLabel = label(related);
+                if (canonicalIssuer.exists(relatedLabel)) {
+                    path += canonicalIssuer.get(relatedLabel);
+                } else {
+                    if (!issuerCopy.exists(relatedLabel))
+                        recursionList.push_back(related);
+                    path += issuerCopy.get(relatedLabel);
+                }
+                // 5.4.4.3) stronger than the specification, which only skips a path as
+                // long as the chosen one: a path that is already greater than the start
+                // of the chosen one can not be chosen
+                if (cannotBeChosen(path, chosenPath)) {
+                    skip = true;
+                    break;
+                }
+            }
+
+            // 5.4.5)
+            if (!skip) {
+                for (NodeId related : recursionList) {
+                    // the identifier comes before the hash, so check it before recursing
+                    path += issuerCopy.get(label(related));
+                    path += '<';
+                    if (cannotBeChosen(path, chosenPath)) {
+                        skip = true;
+                        break;
+                    }
+                    HashResult result = hashNDegreeQuads(related, issuerCopy, depth + 1);
+                    path += result.hash;
+                    path += '>';
+                    issuerCopy = std::move(result.issuer);
+                    if (cannotBeChosen(path, chosenPath)) {
+                        skip = true;
+                        break;
+                    }
+                }
+            }
+
+            // 5.4.6)
+            if (!skip && (chosenPath.empty() || path < chosenPath)) {
+                chosenPath = std::move(path);
+                chosenIssuer = std::move(issuerCopy);
+            }
+        } while (std::next_permutation(permutation.begin(), permutation.end()));
+
+        // 5.5) and 5.6)
+        md->update(chosenPath);
+        issuer = std::move(chosenIssuer);
+    }
+
+    // 6)
+    HashResult result;
+    result.hash = md->digest();
+    result.issuer = std::move(issuer);
+    return result;
+}
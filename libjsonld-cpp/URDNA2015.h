@@ -0,0 +1,96 @@
+#ifndef LIBJSONLD_CPP_URDNA2015_H
+#define LIBJSONLD_CPP_URDNA2015_H
+
+#include "RDFDataset.h"
+#include "BlankNodeIndex.h"
+#include "CanonicalSerializer.h"
+#include "MessageDigest.h"
+#include "NormalizationBudget.h"
+#include "UniqueNamer.h"
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * The URDNA2015 RDF Dataset Canonicalization algorithm:
+ *
+ * https://json-ld.github.io/normalization/spec/#canonicalization-algorithm
+ *
+ * Unlike the URGNA2012 algorithm in NormalizeUtils, it hashes with SHA-256, tells the
+ * blank nodes next to a blank node apart by their position in the quad, and stops
+ * building a path through a permutation of blank nodes as soon as the path can no
+ * longer be the one chosen.
+ *
+ * Blank nodes are identified by their number in a BlankNodeIndex of the dataset.
+ * The identifier issuers are UniqueNamers, which issue identifiers in order and remember
+ * the order they were issued in.
+ */
+class URDNA2015 {
+private:
+    typedef RDF::BlankNodeIndex::NodeId NodeId;
+
+    struct HashResult {
+        std::string hash;
+        UniqueNamer issuer;
+    };
+
+    const RDF::RDFDataset & dataset;
+    const RDF::QuadStore & quads;
+    const RDF::TermDictionary & dictionary;
+    unsigned int threads;
+    std::string hashAlgorithm;
+
+    // the blank nodes and the quads each of them appears in
+    RDF::BlankNodeIndex index;
+    RDF::CanonicalSerializer serializer;
+    // the first degree hash of each blank node, empty until it is computed
+    std::vector<std::string> firstDegreeHashes;
+    UniqueNamer canonicalIssuer;
+    NormalizationBudget budget;
+    // scratch space for hashFirstDegreeQuads(), which only computes one hash at a time
+    RDF::CanonicalSerializer::Lines firstDegreeLines;
+    std::unique_ptr<MessageDigest> firstDegreeDigest;
+
+    const std::string & label(NodeId id) const;
+
+    const std::string & hashFirstDegreeQuads(NodeId id);
+
+    // lines is only scratch space, so may be reused from call to call
+    std::string computeFirstDegreeHash(NodeId id, RDF::CanonicalSerializer::Lines & lines,
+                                       MessageDigest & md) const;
+
+    // what Hash Related Blank Node hashes, so that the hashes of all related blank nodes
+    // can be computed at once
+    std::string relatedBlankNodeInput(NodeId related, size_t quad, UniqueNamer & issuer, char position);
+
+    // depth counts the hashNDegreeQuads calls this one is nested in
+    HashResult hashNDegreeQuads(NodeId id, UniqueNamer issuer, size_t depth);
+
+public:
+    /**
+     * @param threads the number of threads to compute first degree hashes, and the N-degree
+     * hashes of blank nodes sharing one, on, or 0 for one per hardware thread. The result
+     * does not depend on it.
+     * @param hashAlgorithm the name of a MessageDigest algorithm. The specification uses
+     * SHA-256
+     */
+    explicit URDNA2015(const RDF::RDFDataset & dataset, unsigned int threads = 1,
+                       std::string hashAlgorithm = MessageDigest::SHA_256);
+
+    /**
+     * Takes the threads, hash algorithm and limits on the work done from options. An
+     * empty hash algorithm means SHA-256.
+     */
+    URDNA2015(const RDF::RDFDataset & dataset, const JsonLdOptions & options);
+
+    URDNA2015(const URDNA2015 &) = delete;
+    URDNA2015 & operator=(const URDNA2015 &) = delete;
+
+    /**
+     * @return the quads of the dataset in N-Quads format, with canonical blank node
+     * labels, sorted
+     */
+    std::string canonicalize();
+};
+
+#endif //LIBJSONLD_CPP_URDNA2015_H
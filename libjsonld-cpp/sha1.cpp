@@ -20,13 +20,15 @@
 */
 
 #include "sha1.h"
-#include <cassert>
-#include <sstream>
-#include <iomanip>
-#include <vector>
+#include "CpuFeatures.h"
+#include <cstring>
+
+#ifdef LIBJSONLD_CPP_X86_DISPATCH
+#include <immintrin.h>
+#endif
 
 /* Help macros */
-#define SHA1_ROL(value, bits) (((value) << (bits)) | (((value) & 0xffffffffu) >> (32u - (bits))))
+#define SHA1_ROL(value, bits) (((value) << (bits)) | ((value) >> (32u - (bits))))
 #define SHA1_BLK(i) (block[i&15u] = SHA1_ROL(block[(i+13u)&15u] ^ block[(i+8u)&15u] ^ block[(i+2u)&15u] ^ block[i&15u],1u))
 
 /* (R0+R1), R2, R3, R4 are the different operations used in SHA1 */
@@ -36,230 +38,288 @@
 #define SHA1_R3(v,w,x,y,z,i) z += (((w|x)&y)|(w&x)) + SHA1_BLK(i) + 0x8f1bbcdc + SHA1_ROL(v,5u); w=SHA1_ROL(w,30u);
 #define SHA1_R4(v,w,x,y,z,i) z += (w^x^y)           + SHA1_BLK(i) + 0xca62c1d6 + SHA1_ROL(v,5u); w=SHA1_ROL(w,30u);
 
-SHA1::SHA1()
+namespace {
+
+    /*
+     * Hash count 512-bit blocks. This is the core of the algorithm.
+     */
+    void compressPortable(uint32_t *state, const unsigned char *blocks, size_t count)
+    {
+        for (; count > 0; count--, blocks += 64)
+        {
+            /* Convert the block to a uint32 array (MSB) */
+            uint32_t block[16];
+            for (unsigned int i = 0; i < 16; i++)
+            {
+                block[i] = static_cast<uint32_t>(blocks[4*i+3])
+                           | static_cast<uint32_t>(blocks[4*i+2])<<8u
+                           | static_cast<uint32_t>(blocks[4*i+1])<<16u
+                           | static_cast<uint32_t>(blocks[4*i+0])<<24u;
+            }
+
+            /* Copy digest[] to working vars */
+            uint32_t a = state[0];
+            uint32_t b = state[1];
+            uint32_t c = state[2];
+            uint32_t d = state[3];
+            uint32_t e = state[4];
+
+        /* 4 rounds of 20 operations each. Loop unrolled. */
+        SHA1_R0(a,b,c,d,e, 0u)
+        SHA1_R0(e,a,b,c,d, 1u)
+        SHA1_R0(d,e,a,b,c, 2u)
+        SHA1_R0(c,d,e,a,b, 3u)
+        SHA1_R0(b,c,d,e,a, 4u)
+        SHA1_R0(a,b,c,d,e, 5u)
+        SHA1_R0(e,a,b,c,d, 6u)
+        SHA1_R0(d,e,a,b,c, 7u)
+        SHA1_R0(c,d,e,a,b, 8u)
+        SHA1_R0(b,c,d,e,a, 9u)
+        SHA1_R0(a,b,c,d,e,10u)
+        SHA1_R0(e,a,b,c,d,11u)
+        SHA1_R0(d,e,a,b,c,12u)
+        SHA1_R0(c,d,e,a,b,13u)
+        SHA1_R0(b,c,d,e,a,14u)
+        SHA1_R0(a,b,c,d,e,15u)
+        SHA1_R1(e,a,b,c,d,16u)
+        SHA1_R1(d,e,a,b,c,17u)
+        SHA1_R1(c,d,e,a,b,18u)
+        SHA1_R1(b,c,d,e,a,19u)
+        SHA1_R2(a,b,c,d,e,20u)
+        SHA1_R2(e,a,b,c,d,21u)
+        SHA1_R2(d,e,a,b,c,22u)
+        SHA1_R2(c,d,e,a,b,23u)
+        SHA1_R2(b,c,d,e,a,24u)
+        SHA1_R2(a,b,c,d,e,25u)
+        SHA1_R2(e,a,b,c,d,26u)
+        SHA1_R2(d,e,a,b,c,27u)
+        SHA1_R2(c,d,e,a,b,28u)
+        SHA1_R2(b,c,d,e,a,29u)
+        SHA1_R2(a,b,c,d,e,30u)
+        SHA1_R2(e,a,b,c,d,31u)
+        SHA1_R2(d,e,a,b,c,32u)
+        SHA1_R2(c,d,e,a,b,33u)
+        SHA1_R2(b,c,d,e,a,34u)
+        SHA1_R2(a,b,c,d,e,35u)
+        SHA1_R2(e,a,b,c,d,36u)
+        SHA1_R2(d,e,a,b,c,37u)
+        SHA1_R2(c,d,e,a,b,38u)
+        SHA1_R2(b,c,d,e,a,39u)
+        SHA1_R3(a,b,c,d,e,40u)
+        SHA1_R3(e,a,b,c,d,41u)
+        SHA1_R3(d,e,a,b,c,42u)
+        SHA1_R3(c,d,e,a,b,43u)
+        SHA1_R3(b,c,d,e,a,44u)
+        SHA1_R3(a,b,c,d,e,45u)
+        SHA1_R3(e,a,b,c,d,46u)
+        SHA1_R3(d,e,a,b,c,47u)
+        SHA1_R3(c,d,e,a,b,48u)
+        SHA1_R3(b,c,d,e,a,49u)
+        SHA1_R3(a,b,c,d,e,50u)
+        SHA1_R3(e,a,b,c,d,51u)
+        SHA1_R3(d,e,a,b,c,52u)
+        SHA1_R3(c,d,e,a,b,53u)
+        SHA1_R3(b,c,d,e,a,54u)
+        SHA1_R3(a,b,c,d,e,55u)
+        SHA1_R3(e,a,b,c,d,56u)
+        SHA1_R3(d,e,a,b,c,57u)
+        SHA1_R3(c,d,e,a,b,58u)
+        SHA1_R3(b,c,d,e,a,59u)
+        SHA1_R4(a,b,c,d,e,60u)
+        SHA1_R4(e,a,b,c,d,61u)
+        SHA1_R4(d,e,a,b,c,62u)
+        SHA1_R4(c,d,e,a,b,63u)
+        SHA1_R4(b,c,d,e,a,64u)
+        SHA1_R4(a,b,c,d,e,65u)
+        SHA1_R4(e,a,b,c,d,66u)
+        SHA1_R4(d,e,a,b,c,67u)
+        SHA1_R4(c,d,e,a,b,68u)
+        SHA1_R4(b,c,d,e,a,69u)
+        SHA1_R4(a,b,c,d,e,70u)
+        SHA1_R4(e,a,b,c,d,71u)
+        SHA1_R4(d,e,a,b,c,72u)
+        SHA1_R4(c,d,e,a,b,73u)
+        SHA1_R4(b,c,d,e,a,74u)
+        SHA1_R4(a,b,c,d,e,75u)
+        SHA1_R4(e,a,b,c,d,76u)
+        SHA1_R4(d,e,a,b,c,77u)
+        SHA1_R4(c,d,e,a,b,78u)
+        SHA1_R4(b,c,d,e,a,79u)
+
+            /* Add the working vars back into digest[] */
+            state[0] += a;
+            state[1] += b;
+            state[2] += c;
+            state[3] += d;
+            state[4] += e;
+        }
+    }
+
+#ifdef LIBJSONLD_CPP_X86_DISPATCH
+    /*
+     * 4 rounds with the SHA extensions. Works out the message words 4 groups ahead, and
+     * leaves the next value of e in the other of e[0] and e[1]. g is a literal, so the
+     * conditions fold away.
+     */
+#define SHA1_NI_GROUP(g) \
+    if ((g) < 4) \
+        msg[(g) & 3] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(blocks + 16 * (g))), byteSwap); \
+    if ((g) == 0) \
+        e[0] = _mm_add_epi32(e[0], msg[0]); \
+    else \
+        e[(g) & 1] = _mm_sha1nexte_epu32(e[(g) & 1], msg[(g) & 3]); \
+    e[((g) + 1) & 1] = abcd; \
+    if ((g) >= 3 && (g) <= 18) \
+        msg[((g) + 1) & 3] = _mm_sha1msg2_epu32(msg[((g) + 1) & 3], msg[(g) & 3]); \
+    abcd = _mm_sha1rnds4_epu32(abcd, e[(g) & 1], (g) / 5); \
+    if ((g) >= 1 && (g) <= 16) \
+        msg[((g) + 3) & 3] = _mm_sha1msg1_epu32(msg[((g) + 3) & 3], msg[(g) & 3]); \
+    if ((g) >= 2 && (g) <= 17) \
+        msg[((g) + 2) & 3] = _mm_xor_si128(msg[((g) + 2) & 3], msg[(g) & 3]);
+
+    /*
+     * The same as compressPortable(), with the SHA extensions.
+     */
+    __attribute__((target("sha,ssse3,sse4.1")))
+    void compressShaExtensions(uint32_t *state, const unsigned char *blocks, size_t count)
+    {
+        const __m128i byteSwap = _mm_set_epi64x(0x0001020304050607LL, 0x08090a0b0c0d0e0fLL);
+        __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(state)), 0x1b);
+        __m128i e0 = _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0);
+
+        for (; count > 0; count--, blocks += 64)
+        {
+            __m128i abcdSave = abcd;
+            __m128i msg[4];
+            __m128i e[2] = {e0, _mm_setzero_si128()};
+
+            SHA1_NI_GROUP(0)  SHA1_NI_GROUP(1)  SHA1_NI_GROUP(2)  SHA1_NI_GROUP(3)
+            SHA1_NI_GROUP(4)  SHA1_NI_GROUP(5)  SHA1_NI_GROUP(6)  SHA1_NI_GROUP(7)
+            SHA1_NI_GROUP(8)  SHA1_NI_GROUP(9)  SHA1_NI_GROUP(10) SHA1_NI_GROUP(11)
+            SHA1_NI_GROUP(12) SHA1_NI_GROUP(13) SHA1_NI_GROUP(14) SHA1_NI_GROUP(15)
+            SHA1_NI_GROUP(16) SHA1_NI_GROUP(17) SHA1_NI_GROUP(18) SHA1_NI_GROUP(19)
+
+            /* the last group left the next value of e in e[0] */
+            e0 = _mm_sha1nexte_epu32(e[0], e0);
+            abcd = _mm_add_epi32(abcd, abcdSave);
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(state), _mm_shuffle_epi32(abcd, 0x1b));
+        state[4] = static_cast<uint32_t>(_mm_extract_epi32(e0, 3));
+    }
+
+#undef SHA1_NI_GROUP
+#endif
+
+}
+
+SHA1::SHA1(Implementation implementation)
+        : compress(compressPortable)
 {
+    if (implementation == Implementation::Fastest)
+        implementation = Implementation::ShaExtensions;
+#ifdef LIBJSONLD_CPP_X86_DISPATCH
+    if (implementation == Implementation::ShaExtensions && isAvailable(implementation))
+        compress = compressShaExtensions;
+#endif
     reset();
 }
 
+bool SHA1::isAvailable(Implementation implementation)
+{
+    if (implementation == Implementation::ShaExtensions)
+        return CpuFeatures::hasShaExtensions();
+    return true;
+}
+
 
-void SHA1::update(const std::string &s)
+void SHA1::update(const char *data, size_t size)
 {
-    std::istringstream is(s);
-    update(is);
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(data);
+    totalBytes += size;
+    if (bufferSize > 0) {
+        size_t n = BLOCK_BYTES - bufferSize < size ? BLOCK_BYTES - bufferSize : size;
+        std::memcpy(buffer + bufferSize, p, n);
+        bufferSize += n;
+        p += n;
+        size -= n;
+        if (bufferSize < BLOCK_BYTES)
+            return;
+        compress(state, buffer, 1);
+        bufferSize = 0;
+    }
+    if (size >= BLOCK_BYTES) {
+        compress(state, p, size / BLOCK_BYTES);
+        p += size - size % BLOCK_BYTES;
+        size %= BLOCK_BYTES;
+    }
+    if (size > 0)
+        std::memcpy(buffer, p, size);
+    bufferSize = size;
 }
 
 
 void SHA1::update(std::istream &is)
 {
-    std::string rest_of_buffer;
-    assert(buffer.size() <= BLOCK_BYTES);
-    size_t bytesToRead = BLOCK_BYTES - buffer.size();
-    read(is, rest_of_buffer, bytesToRead);// run some tests and step through this
-    buffer += rest_of_buffer;
-
+    char chunk[4096];
     while (is)
     {
-        uint32 block[BLOCK_INTS];
-        buffer_to_block(buffer, block);
-        transform(block);
-        read(is, buffer, BLOCK_BYTES);
+        is.read(chunk, sizeof(chunk));
+        update(chunk, static_cast<size_t>(is.gcount()));
     }
 }
 
 
 /*
- * Add padding and return the message digest.
+ * Add padding and write the message digest.
  */
 
-std::string SHA1::final()
+void SHA1::digestTo(unsigned char *out)
 {
     /* Total number of hashed bits */
-    uint64 total_bits = (transforms*BLOCK_BYTES + buffer.size()) * 8;
-
-    /* Padding */
-    buffer += static_cast<char>(0x80);
-    size_t orig_size = buffer.size();
-    while (buffer.size() < BLOCK_BYTES)
-    {
-        buffer += static_cast<char>(0x00);
-    }
+    uint64_t total_bits = totalBytes * 8;
 
-    uint32 block[BLOCK_INTS];
-    buffer_to_block(buffer, block);
+    /* Padding: a 1 bit, zeros, then the message length in bits as a big endian uint64 */
+    unsigned char padding[BLOCK_BYTES * 2] = {0x80};
+    size_t padSize = (bufferSize < 56 ? 56 : 120) - bufferSize;
+    for (unsigned int i = 0; i < 8; i++)
+        padding[padSize + i] = static_cast<unsigned char>(total_bits >> (56u - 8u * i));
+    update(reinterpret_cast<const char *>(padding), padSize + 8);
 
-    if (orig_size > BLOCK_BYTES - 8)
+    for (unsigned int i = 0; i < DIGEST_INTS; i++)
     {
-        transform(block);
-        for (unsigned int i = 0; i < BLOCK_INTS - 2; i++)
-        {
-            block[i] = 0;
-        }
-    }
-
-    /* Append total_bits, split this uint64 into two uint32 */
-    block[BLOCK_INTS - 1] = total_bits;
-    block[BLOCK_INTS - 2] = (total_bits >> 32u);
-    transform(block);
-
-    /* Hex std::string */
-    std::ostringstream result;
-    for (unsigned long i : digestbuf)
-    {
-        result << std::hex << std::setfill('0') << std::setw(8);
-        result << (i & 0xffffffff);
+        for (unsigned int j = 0; j < 4; j++)
+            out[4 * i + j] = static_cast<unsigned char>(state[i] >> (24u - 8u * j));
     }
 
     /* Reset for next run */
     reset();
-
-    return result.str();
 }
 
-void SHA1::reset()
+SHA1::Digest SHA1::binaryDigest()
 {
-    /* SHA1 initialization constants */
-    digestbuf[0] = 0x67452301;
-    digestbuf[1] = 0xefcdab89;
-    digestbuf[2] = 0x98badcfe;
-    digestbuf[3] = 0x10325476;
-    digestbuf[4] = 0xc3d2e1f0;
-
-    /* Reset counters */
-    transforms = 0;
-    buffer = "";
+    Digest result;
+    digestTo(result.data());
+    return result;
 }
 
-
-/*
- * Hash a single 512-bit block. This is the core of the algorithm.
- */
-
-void SHA1::transform(uint32 block[BLOCK_BYTES])
+std::string SHA1::final()
 {
-    /* Copy digest[] to working vars */
-    uint32 a = digestbuf[0];
-    uint32 b = digestbuf[1];
-    uint32 c = digestbuf[2];
-    uint32 d = digestbuf[3];
-    uint32 e = digestbuf[4];
-
-
-    /* 4 rounds of 20 operations each. Loop unrolled. */
-    SHA1_R0(a,b,c,d,e, 0u)
-    SHA1_R0(e,a,b,c,d, 1u)
-    SHA1_R0(d,e,a,b,c, 2u)
-    SHA1_R0(c,d,e,a,b, 3u)
-    SHA1_R0(b,c,d,e,a, 4u)
-    SHA1_R0(a,b,c,d,e, 5u)
-    SHA1_R0(e,a,b,c,d, 6u)
-    SHA1_R0(d,e,a,b,c, 7u)
-    SHA1_R0(c,d,e,a,b, 8u)
-    SHA1_R0(b,c,d,e,a, 9u)
-    SHA1_R0(a,b,c,d,e,10u)
-    SHA1_R0(e,a,b,c,d,11u)
-    SHA1_R0(d,e,a,b,c,12u)
-    SHA1_R0(c,d,e,a,b,13u)
-    SHA1_R0(b,c,d,e,a,14u)
-    SHA1_R0(a,b,c,d,e,15u)
-    SHA1_R1(e,a,b,c,d,16u)
-    SHA1_R1(d,e,a,b,c,17u)
-    SHA1_R1(c,d,e,a,b,18u)
-    SHA1_R1(b,c,d,e,a,19u)
-    SHA1_R2(a,b,c,d,e,20u)
-    SHA1_R2(e,a,b,c,d,21u)
-    SHA1_R2(d,e,a,b,c,22u)
-    SHA1_R2(c,d,e,a,b,23u)
-    SHA1_R2(b,c,d,e,a,24u)
-    SHA1_R2(a,b,c,d,e,25u)
-    SHA1_R2(e,a,b,c,d,26u)
-    SHA1_R2(d,e,a,b,c,27u)
-    SHA1_R2(c,d,e,a,b,28u)
-    SHA1_R2(b,c,d,e,a,29u)
-    SHA1_R2(a,b,c,d,e,30u)
-    SHA1_R2(e,a,b,c,d,31u)
-    SHA1_R2(d,e,a,b,c,32u)
-    SHA1_R2(c,d,e,a,b,33u)
-    SHA1_R2(b,c,d,e,a,34u)
-    SHA1_R2(a,b,c,d,e,35u)
-    SHA1_R2(e,a,b,c,d,36u)
-    SHA1_R2(d,e,a,b,c,37u)
-    SHA1_R2(c,d,e,a,b,38u)
-    SHA1_R2(b,c,d,e,a,39u)
-    SHA1_R3(a,b,c,d,e,40u)
-    SHA1_R3(e,a,b,c,d,41u)
-    SHA1_R3(d,e,a,b,c,42u)
-    SHA1_R3(c,d,e,a,b,43u)
-    SHA1_R3(b,c,d,e,a,44u)
-    SHA1_R3(a,b,c,d,e,45u)
-    SHA1_R3(e,a,b,c,d,46u)
-    SHA1_R3(d,e,a,b,c,47u)
-    SHA1_R3(c,d,e,a,b,48u)
-    SHA1_R3(b,c,d,e,a,49u)
-    SHA1_R3(a,b,c,d,e,50u)
-    SHA1_R3(e,a,b,c,d,51u)
-    SHA1_R3(d,e,a,b,c,52u)
-    SHA1_R3(c,d,e,a,b,53u)
-    SHA1_R3(b,c,d,e,a,54u)
-    SHA1_R3(a,b,c,d,e,55u)
-    SHA1_R3(e,a,b,c,d,56u)
-    SHA1_R3(d,e,a,b,c,57u)
-    SHA1_R3(c,d,e,a,b,58u)
-    SHA1_R3(b,c,d,e,a,59u)
-    SHA1_R4(a,b,c,d,e,60u)
-    SHA1_R4(e,a,b,c,d,61u)
-    SHA1_R4(d,e,a,b,c,62u)
-    SHA1_R4(c,d,e,a,b,63u)
-    SHA1_R4(b,c,d,e,a,64u)
-    SHA1_R4(a,b,c,d,e,65u)
-    SHA1_R4(e,a,b,c,d,66u)
-    SHA1_R4(d,e,a,b,c,67u)
-    SHA1_R4(c,d,e,a,b,68u)
-    SHA1_R4(b,c,d,e,a,69u)
-    SHA1_R4(a,b,c,d,e,70u)
-    SHA1_R4(e,a,b,c,d,71u)
-    SHA1_R4(d,e,a,b,c,72u)
-    SHA1_R4(c,d,e,a,b,73u)
-    SHA1_R4(b,c,d,e,a,74u)
-    SHA1_R4(a,b,c,d,e,75u)
-    SHA1_R4(e,a,b,c,d,76u)
-    SHA1_R4(d,e,a,b,c,77u)
-    SHA1_R4(c,d,e,a,b,78u)
-    SHA1_R4(b,c,d,e,a,79u)
-
-    /* Add the working vars back into digest[] */
-    digestbuf[0] += a;
-    digestbuf[1] += b;
-    digestbuf[2] += c;
-    digestbuf[3] += d;
-    digestbuf[4] += e;
-
-    /* Count the number of transformations */
-    transforms++;
+    return digest();
 }
 
-
-void SHA1::buffer_to_block(const std::string &buffer, uint32 block[BLOCK_BYTES])
-{
-    /* Convert the std::string (byte buffer) to a uint32 array (MSB) */
-    for (unsigned int i = 0; i < BLOCK_INTS; i++)
-    {
-        block[i] = (static_cast<unsigned int>(buffer[4*i+3]) & 0xffu)
-                   | (static_cast<unsigned int>(buffer[4*i+2]) & 0xffu)<<8u
-                   | (static_cast<unsigned int>(buffer[4*i+1]) & 0xffu)<<16u
-                   | (static_cast<unsigned int>(buffer[4*i+0]) & 0xffu)<<24u;
-    }
-}
-
-
-void SHA1::read(std::istream &is, std::string &s, size_t max)
+void SHA1::reset()
 {
-    std::vector<char> sbuf(max);
-    is.read(sbuf.data(), static_cast<std::streamsize>(max));
-    s.assign(sbuf.data(), static_cast<size_t>(is.gcount()));
-}
+    /* SHA1 initialization constants */
+    state[0] = 0x67452301;
+    state[1] = 0xefcdab89;
+    state[2] = 0x98badcfe;
+    state[3] = 0x10325476;
+    state[4] = 0xc3d2e1f0;
 
-std::string SHA1::digest() {
-    return final();
+    /* Reset counters */
+    bufferSize = 0;
+    totalBytes = 0;
 }
 
 
@@ -20,37 +20,60 @@
 #ifndef LIBJSONLD_CPP_SHA1_H
 #define LIBJSONLD_CPP_SHA1_H
 
+#include "MessageDigest.h"
+#include <array>
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <vector>
 
-class SHA1
+class SHA1 final : public MessageDigest
 {
 public:
-    SHA1();
-    void update(const std::string &s);
+    static const size_t DIGEST_BYTES = 20;
+    typedef std::array<unsigned char, DIGEST_BYTES> Digest;
+
+    enum class Implementation {
+        // plain C++, for any processor
+        Portable,
+        // the x86 SHA extensions
+        ShaExtensions,
+        // the fastest one available
+        Fastest
+    };
+
+    /**
+     * The digest is the same whatever the implementation. One that is not available on
+     * this processor falls back to Portable.
+     */
+    explicit SHA1(Implementation implementation = Implementation::Fastest);
+
+    static bool isAvailable(Implementation implementation);
+
+    using MessageDigest::update;
+    void update(const char *data, size_t size) override;
     void update(std::istream &is);
+
+    size_t digestSize() const override { return DIGEST_BYTES; }
+    void digestTo(unsigned char *out) override;
+    // returns the binary digest, and resets the hash so it can be reused
+    Digest binaryDigest();
+    // returns hex encoded digest string, same as digest()
     std::string final();
-    // returns hex encoded digest string
-    std::string digest();
+
+    void reset() override;
 
 private:
-    typedef unsigned long int uint32;   /* just needs to be at least 32bit */
-    typedef unsigned long long uint64;  /* just needs to be at least 64bit */
+    typedef void (*Compress)(uint32_t *state, const unsigned char *blocks, size_t count);
 
     static const unsigned int DIGEST_INTS = 5;  /* number of 32bit integers per SHA1 digest */
-    static const unsigned int BLOCK_INTS = 16;  /* number of 32bit integers per SHA1 block */
-    static const unsigned int BLOCK_BYTES = BLOCK_INTS * 4;
-
-    uint32 digestbuf[DIGEST_INTS]{};
-    std::string buffer;
-    uint64 transforms{};
-
-    void reset();
-    void transform(uint32 block[BLOCK_BYTES]);
+    static const unsigned int BLOCK_BYTES = 64;
 
-    static void buffer_to_block(const std::string &buffer, uint32 block[BLOCK_BYTES]);
-    static void read(std::istream &is, std::string &s, size_t max);
+    Compress compress;
+    uint32_t state[DIGEST_INTS]{};
+    unsigned char buffer[BLOCK_BYTES]{};
+    size_t bufferSize{};
+    uint64_t totalBytes{};
 };
 
 /**
@@ -0,0 +1,381 @@
+/*
+    sha256.cpp - SHA-256 (FIPS 180-4), with the same interface as SHA1 in sha1.cpp
+*/
+
+#include "sha256.h"
+#include "CpuFeatures.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef LIBJSONLD_CPP_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace {
+
+    const uint32_t K[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+    const uint32_t IV[8] = {
+            0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+
+    inline uint32_t rotr(uint32_t x, unsigned int n) {
+        return (x >> n) | (x << (32u - n));
+    }
+
+    inline uint32_t loadBigEndian(const unsigned char *p) {
+        return static_cast<uint32_t>(p[0]) << 24u | static_cast<uint32_t>(p[1]) << 16u |
+               static_cast<uint32_t>(p[2]) << 8u | static_cast<uint32_t>(p[3]);
+    }
+
+    void compressPortable(uint32_t *state, const unsigned char *blocks, size_t count)
+    {
+        for (; count > 0; count--, blocks += 64) {
+            uint32_t w[64];
+            for (unsigned int i = 0; i < 16; i++) {
+                w[i] = static_cast<uint32_t>(blocks[4 * i]) << 24u | static_cast<uint32_t>(blocks[4 * i + 1]) << 16u |
+                       static_cast<uint32_t>(blocks[4 * i + 2]) << 8u | static_cast<uint32_t>(blocks[4 * i + 3]);
+            }
+            for (unsigned int i = 16; i < 64; i++) {
+                uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3u);
+                uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10u);
+                w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+            }
+
+            uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+            uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+            for (unsigned int i = 0; i < 64; i++) {
+                uint32_t s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+                uint32_t ch = (e & f) ^ (~e & g);
+                uint32_t t1 = h + s1 + ch + K[i] + w[i];
+                uint32_t s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+                uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+                uint32_t t2 = s0 + maj;
+                h = g;
+                g = f;
+                f = e;
+                e = d + t1;
+                d = c;
+                c = b;
+                b = a;
+                a = t1 + t2;
+            }
+
+            state[0] += a;
+            state[1] += b;
+            state[2] += c;
+            state[3] += d;
+            state[4] += e;
+            state[5] += f;
+            state[6] += g;
+            state[7] += h;
+        }
+    }
+
+    /*
+     * The last one or two blocks of a message: what is left of it after its whole blocks,
+     * then a 1 bit, zeros, and the message length in bits as a big endian uint64.
+     * Returns the number of blocks.
+     */
+    size_t padTail(const unsigned char *rest, size_t restSize, uint64_t totalBytes, unsigned char *tail)
+    {
+        size_t blocks = restSize < 56 ? 1 : 2;
+        std::memset(tail, 0, blocks * 64);
+        std::memcpy(tail, rest, restSize);
+        tail[restSize] = 0x80;
+        uint64_t totalBits = totalBytes * 8;
+        for (unsigned int i = 0; i < 8; i++)
+            tail[blocks * 64 - 8 + i] = static_cast<unsigned char>(totalBits >> (56u - 8u * i));
+        return blocks;
+    }
+
+    void storeDigest(const uint32_t *state, unsigned char *out)
+    {
+        for (unsigned int i = 0; i < 8; i++) {
+            for (unsigned int j = 0; j < 4; j++)
+                out[4 * i + j] = static_cast<unsigned char>(state[i] >> (24u - 8u * j));
+        }
+    }
+
+#ifdef LIBJSONLD_CPP_X86_DISPATCH
+    /*
+     * 4 rounds with the SHA extensions. Works out the message words 4 groups ahead. g is
+     * a literal, so the conditions fold away.
+     */
+#define SHA256_NI_GROUP(g) \
+    { \
+        if ((g) < 4) \
+            msg[(g) & 3] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(blocks + 16 * (g))), byteSwap); \
+        __m128i wk = _mm_add_epi32(msg[(g) & 3], _mm_loadu_si128(reinterpret_cast<const __m128i *>(K + 4 * (g)))); \
+        cdgh = _mm_sha256rnds2_epu32(cdgh, abef, wk); \
+        if ((g) >= 3 && (g) <= 14) { \
+            msg[((g) + 1) & 3] = _mm_add_epi32(msg[((g) + 1) & 3], _mm_alignr_epi8(msg[(g) & 3], msg[((g) + 3) & 3], 4)); \
+            msg[((g) + 1) & 3] = _mm_sha256msg2_epu32(msg[((g) + 1) & 3], msg[(g) & 3]); \
+        } \
+        abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(wk, 0x0e)); \
+        if ((g) >= 1 && (g) <= 12) \
+            msg[((g) + 3) & 3] = _mm_sha256msg1_epu32(msg[((g) + 3) & 3], msg[(g) & 3]); \
+    }
+
+    /*
+     * The same as compressPortable(), with the SHA extensions. The state is kept as ABEF
+     * and CDGH, the order sha256rnds2 wants.
+     */
+    __attribute__((target("sha,ssse3,sse4.1")))
+    void compressShaExtensions(uint32_t *state, const unsigned char *blocks, size_t count)
+    {
+        const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+        __m128i dcba = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(state)), 0xb1);
+        __m128i hgfe = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(state + 4)), 0x1b);
+        __m128i abef = _mm_alignr_epi8(dcba, hgfe, 8);
+        __m128i cdgh = _mm_blend_epi16(hgfe, dcba, 0xf0);
+
+        for (; count > 0; count--, blocks += 64) {
+            __m128i abefSave = abef;
+            __m128i cdghSave = cdgh;
+            __m128i msg[4];
+
+            SHA256_NI_GROUP(0)  SHA256_NI_GROUP(1)  SHA256_NI_GROUP(2)  SHA256_NI_GROUP(3)
+            SHA256_NI_GROUP(4)  SHA256_NI_GROUP(5)  SHA256_NI_GROUP(6)  SHA256_NI_GROUP(7)
+            SHA256_NI_GROUP(8)  SHA256_NI_GROUP(9)  SHA256_NI_GROUP(10) SHA256_NI_GROUP(11)
+            SHA256_NI_GROUP(12) SHA256_NI_GROUP(13) SHA256_NI_GROUP(14) SHA256_NI_GROUP(15)
+
+            abef = _mm_add_epi32(abef, abefSave);
+            cdgh = _mm_add_epi32(cdgh, cdghSave);
+        }
+
+        __m128i feba = _mm_shuffle_epi32(abef, 0x1b);
+        __m128i dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(state), _mm_blend_epi16(feba, dchg, 0xf0));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(state + 4), _mm_alignr_epi8(dchg, feba, 8));
+    }
+
+#undef SHA256_NI_GROUP
+
+#define SHA256_ROTR8(x, n) _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+
+    /*
+     * Hashes up to eight messages at once, one in each 32 bit lane of the AVX2 registers.
+     * A lane whose message is done keeps hashing its last block, and its digest is taken
+     * from the state as soon as its message is done.
+     */
+    __attribute__((target("avx2")))
+    void digestEightAvx2(const std::string * const *messages, size_t count, unsigned char (*digests)[32])
+    {
+        const unsigned char *data[8];
+        size_t wholeBlocks[8];
+        size_t blocks[8];
+        unsigned char tails[8][128];
+        size_t maxBlocks = 0;
+        for (size_t lane = 0; lane < 8; lane++) {
+            // unused lanes hash the first message again
+            const std::string & message = *messages[lane < count ? lane : 0];
+            data[lane] = reinterpret_cast<const unsigned char *>(message.data());
+            wholeBlocks[lane] = message.size() / 64;
+            blocks[lane] = wholeBlocks[lane] + padTail(data[lane] + wholeBlocks[lane] * 64, message.size() % 64,
+                                                       message.size(), tails[lane]);
+            maxBlocks = std::max(maxBlocks, blocks[lane]);
+        }
+
+        __m256i state[8];
+        for (unsigned int i = 0; i < 8; i++)
+            state[i] = _mm256_set1_epi32(static_cast<int>(IV[i]));
+
+        for (size_t b = 0; b < maxBlocks; b++) {
+            const unsigned char *block[8];
+            for (size_t lane = 0; lane < 8; lane++) {
+                size_t last = std::min(b, blocks[lane] - 1);
+                block[lane] = last < wholeBlocks[lane] ? data[lane] + last * 64
+                                                       : tails[lane] + (last - wholeBlocks[lane]) * 64;
+            }
+
+            __m256i w[64];
+            for (unsigned int i = 0; i < 16; i++) {
+                w[i] = _mm256_set_epi32(
+                        static_cast<int>(loadBigEndian(block[7] + 4 * i)), static_cast<int>(loadBigEndian(block[6] + 4 * i)),
+                        static_cast<int>(loadBigEndian(block[5] + 4 * i)), static_cast<int>(loadBigEndian(block[4] + 4 * i)),
+                        static_cast<int>(loadBigEndian(block[3] + 4 * i)), static_cast<int>(loadBigEndian(block[2] + 4 * i)),
+                        static_cast<int>(loadBigEndian(block[1] + 4 * i)), static_cast<int>(loadBigEndian(block[0] + 4 * i)));
+            }
+            for (unsigned int i = 16; i < 64; i++) {
+                __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(SHA256_ROTR8(w[i - 15], 7), SHA256_ROTR8(w[i - 15], 18)),
+                                              _mm256_srli_epi32(w[i - 15], 3));
+                __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(SHA256_ROTR8(w[i - 2], 17), SHA256_ROTR8(w[i - 2], 19)),
+                                              _mm256_srli_epi32(w[i - 2], 10));
+                w[i] = _mm256_add_epi32(_mm256_add_epi32(w[i - 16], s0), _mm256_add_epi32(w[i - 7], s1));
+            }
+
+            __m256i a = state[0], b2 = state[1], c = state[2], d = state[3];
+            __m256i e = state[4], f = state[5], g = state[6], h = state[7];
+            for (unsigned int i = 0; i < 64; i++) {
+                __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(SHA256_ROTR8(e, 6), SHA256_ROTR8(e, 11)),
+                                              SHA256_ROTR8(e, 25));
+                __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+                __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(h, s1), _mm256_add_epi32(ch, w[i]));
+                t1 = _mm256_add_epi32(t1, _mm256_set1_epi32(static_cast<int>(K[i])));
+                __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(SHA256_ROTR8(a, 2), SHA256_ROTR8(a, 13)),
+                                              SHA256_ROTR8(a, 22));
+                __m256i maj = _mm256_xor_si256(_mm256_and_si256(a, _mm256_xor_si256(b2, c)), _mm256_and_si256(b2, c));
+                __m256i t2 = _mm256_add_epi32(s0, maj);
+                h = g;
+                g = f;
+                f = e;
+                e = _mm256_add_epi32(d, t1);
+                d = c;
+                c = b2;
+                b2 = a;
+                a = _mm256_add_epi32(t1, t2);
+            }
+            state[0] = _mm256_add_epi32(state[0], a);
+            state[1] = _mm256_add_epi32(state[1], b2);
+            state[2] = _mm256_add_epi32(state[2], c);
+            state[3] = _mm256_add_epi32(state[3], d);
+            state[4] = _mm256_add_epi32(state[4], e);
+            state[5] = _mm256_add_epi32(state[5], f);
+            state[6] = _mm256_add_epi32(state[6], g);
+            state[7] = _mm256_add_epi32(state[7], h);
+
+            uint32_t lanes[8][8];
+            bool stored = false;
+            for (size_t lane = 0; lane < count; lane++) {
+                if (blocks[lane] != b + 1)
+                    continue;
+                if (!stored) {
+                    for (unsigned int i = 0; i < 8; i++)
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes[i]), state[i]);
+                    stored = true;
+                }
+                uint32_t laneState[8];
+                for (unsigned int i = 0; i < 8; i++)
+                    laneState[i] = lanes[i][lane];
+                storeDigest(laneState, digests[lane]);
+            }
+        }
+    }
+
+#undef SHA256_ROTR8
+#endif
+
+}
+
+SHA256::SHA256(Implementation implementation)
+        : compress(compressPortable), multiBuffer(false)
+{
+    if (implementation == Implementation::Fastest) {
+        implementation = isAvailable(Implementation::ShaExtensions) ? Implementation::ShaExtensions
+                                                                    : Implementation::Avx2MultiBuffer;
+    }
+#ifdef LIBJSONLD_CPP_X86_DISPATCH
+    if (implementation == Implementation::ShaExtensions && isAvailable(implementation))
+        compress = compressShaExtensions;
+    else if (implementation == Implementation::Avx2MultiBuffer && isAvailable(implementation))
+        multiBuffer = true;
+#endif
+    reset();
+}
+
+bool SHA256::isAvailable(Implementation implementation)
+{
+    if (implementation == Implementation::ShaExtensions)
+        return CpuFeatures::hasShaExtensions();
+    if (implementation == Implementation::Avx2MultiBuffer)
+        return CpuFeatures::hasAvx2();
+    return true;
+}
+
+void SHA256::reset()
+{
+    std::memcpy(state, IV, sizeof(state));
+    bufferSize = 0;
+    totalBytes = 0;
+}
+
+void SHA256::update(const char *data, size_t size)
+{
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(data);
+    totalBytes += size;
+    if (bufferSize > 0) {
+        size_t n = BLOCK_BYTES - bufferSize < size ? BLOCK_BYTES - bufferSize : size;
+        std::memcpy(buffer + bufferSize, p, n);
+        bufferSize += n;
+        p += n;
+        size -= n;
+        if (bufferSize < BLOCK_BYTES)
+            return;
+        compress(state, buffer, 1);
+        bufferSize = 0;
+    }
+    if (size >= BLOCK_BYTES) {
+        compress(state, p, size / BLOCK_BYTES);
+        p += size - size % BLOCK_BYTES;
+        size %= BLOCK_BYTES;
+    }
+    if (size > 0)
+        std::memcpy(buffer, p, size);
+    bufferSize = size;
+}
+
+void SHA256::digestTo(unsigned char *out)
+{
+    unsigned char tail[BLOCK_BYTES * 2];
+    compress(state, tail, padTail(buffer, bufferSize, totalBytes, tail));
+    storeDigest(state, out);
+    reset();
+}
+
+SHA256::Digest SHA256::binaryDigest()
+{
+    Digest result;
+    digestTo(result.data());
+    return result;
+}
+
+void SHA256::digestEach(const std::string *messages, size_t count, std::string *hexDigests)
+{
+    if (!multiBuffer) {
+        MessageDigest::digestEach(messages, count, hexDigests);
+        return;
+    }
+#ifdef LIBJSONLD_CPP_X86_DISPATCH
+    // lanes run until their longest message is done, so hash messages of about the
+    // same length together
+    std::vector<const std::string *> order(count);
+    for (size_t i = 0; i < count; i++)
+        order[i] = &messages[i];
+    std::stable_sort(order.begin(), order.end(), [](const std::string *lhs, const std::string *rhs) {
+        return lhs->size() / 64 < rhs->size() / 64;
+    });
+    unsigned char digests[8][32];
+    for (size_t i = 0; i < count; i += 8) {
+        size_t lanes = std::min<size_t>(8, count - i);
+        digestEightAvx2(&order[i], lanes, digests);
+        for (size_t lane = 0; lane < lanes; lane++)
+            hexDigests[order[i + lane] - messages] = toHex(digests[lane], DIGEST_BYTES);
+    }
+    reset();
+#endif
+}
+
+
+std::string sha256(const std::string &input)
+{
+    SHA256 checksum;
+    checksum.update(input);
+    return checksum.digest();
+}
+
+std::string sha256(const std::vector<std::string> &input) {
+    SHA256 checksum;
+    for(const auto& s : input)
+        checksum.update(s);
+    return checksum.digest();
+}
@@ -0,0 +1,82 @@
+/*
+    sha256.h - SHA-256 (FIPS 180-4), with the same interface as SHA1 in sha1.h
+*/
+#ifndef LIBJSONLD_CPP_SHA256_H
+#define LIBJSONLD_CPP_SHA256_H
+
+#include "MessageDigest.h"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class SHA256 final : public MessageDigest
+{
+public:
+    static const size_t DIGEST_BYTES = 32;
+    typedef std::array<unsigned char, DIGEST_BYTES> Digest;
+
+    enum class Implementation {
+        // plain C++, for any processor
+        Portable,
+        // the x86 SHA extensions
+        ShaExtensions,
+        // plain C++, but AVX2 to hash eight messages at once in digestEach()
+        Avx2MultiBuffer,
+        // the fastest one available
+        Fastest
+    };
+
+    /**
+     * The digest is the same whatever the implementation. One that is not available on
+     * this processor falls back to Portable.
+     */
+    explicit SHA256(Implementation implementation = Implementation::Fastest);
+
+    static bool isAvailable(Implementation implementation);
+
+    using MessageDigest::update;
+    void update(const char *data, size_t size) override;
+
+    size_t digestSize() const override { return DIGEST_BYTES; }
+    void digestTo(unsigned char *out) override;
+    // returns the binary digest, and resets the hash so it can be reused
+    Digest binaryDigest();
+
+    /**
+     * Hashes eight messages at a time with the Avx2MultiBuffer implementation; otherwise
+     * one after the other.
+     */
+    void digestEach(const std::string *messages, size_t count, std::string *hexDigests) override;
+
+    void reset() override;
+
+private:
+    typedef void (*Compress)(uint32_t *state, const unsigned char *blocks, size_t count);
+
+    static const unsigned int DIGEST_INTS = 8;  /* number of 32bit integers per SHA256 digest */
+    static const unsigned int BLOCK_BYTES = 64;
+
+    Compress compress;
+    bool multiBuffer;
+    uint32_t state[DIGEST_INTS]{};
+    unsigned char buffer[BLOCK_BYTES]{};
+    size_t bufferSize{};
+    uint64_t totalBytes{};
+};
+
+/**
+ * computes hash of input string. returns hex encoded string of the hash.
+ * @param input the input string
+ * @return the hex encoded string of the hash
+ */
+std::string sha256(const std::string &input);
+
+/**
+ * computes hash of all input strings. returns hex encoded string of the hash.
+ * @param input vector of input strings
+ * @return the hex encoded string of the hash
+ */
+std::string sha256(const std::vector<std::string> & input);
+
+#endif //LIBJSONLD_CPP_SHA256_H
@@ -3,6 +3,8 @@
 #include <cstdint>
 #include <array>
 #include <limits>
+#include <functional>
+#include <iosfwd>
 
 namespace rc {
 
@@ -0,0 +1,82 @@
+#include "Arena.h"
+#include "JsonLdApi.h"
+#include "RDFDatasetUtils.h"
+
+#include <gtest/gtest.h>
+#pragma clang diagnostic push
+#pragma GCC diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#pragma GCC diagnostic ignored "-Wall"
+#pragma GCC diagnostic ignored "-Wextra"
+#include <rapidcheck/gtest.h>
+#pragma clang diagnostic pop
+#pragma GCC diagnostic pop
+
+TEST(ArenaTest, allocate_returnsAlignedMemory) {
+    Arena arena(256);
+    for (size_t n : {1, 3, 8, 17, 100, 1000}) {
+        auto p = reinterpret_cast<std::uintptr_t>(arena.allocate(n));
+        EXPECT_EQ(p % alignof(std::max_align_t), 0u);
+    }
+    EXPECT_GE(arena.getBytesAllocated(), 1 + 3 + 8 + 17 + 100 + 1000u);
+}
+
+TEST(ArenaTest, scope_installsAndRestoresCurrentArena) {
+    EXPECT_EQ(Arena::current(), nullptr);
+    Arena a;
+    {
+        ArenaScope scope(&a);
+        EXPECT_EQ(Arena::current(), &a);
+        {
+            ArenaScope suspended(nullptr);
+            EXPECT_EQ(Arena::current(), nullptr);
+        }
+        EXPECT_EQ(Arena::current(), &a);
+    }
+    EXPECT_EQ(Arena::current(), nullptr);
+}
+
+TEST(ArenaTest, arenaJson_allocatesFromCurrentArena) {
+    Arena arena;
+    nlohmann::json heapCopy;
+    {
+        ArenaScope scope(&arena);
+        arena_json j = arena_json::parse(R"({ "a": [1, 2, 3], "b": { "c": "d" } })");
+        EXPECT_GT(arena.getBytesAllocated(), 0u);
+        EXPECT_EQ(j["a"].size(), 3u);
+
+        // memory allocated while the arena is suspended outlives it
+        ArenaScope suspended(nullptr);
+        heapCopy = nlohmann::json(j);
+    }
+    EXPECT_EQ(heapCopy["b"]["c"], "d");
+}
+
+TEST(ArenaTest, arenaJson_withoutArena_usesHeap) {
+    arena_json j = arena_json::array();
+    for (int i = 0; i < 1000; i++)
+        j.push_back(i);
+    EXPECT_EQ(j.size(), 1000u);
+}
+
+TEST(ArenaTest, toRDF_withArena_producesSameDataset) {
+    nlohmann::json expanded = nlohmann::json::parse(R"([{
+        "@id": "http://example.com/s",
+        "@type": [ "http://example.com/T" ],
+        "http://example.com/p": [
+            { "@value": "v", "@language": "en" },
+            { "@list": [ { "@value": 1 }, { "@id": "_:b" } ] }
+        ],
+        "http://example.com/q": [ { "@id": "_:b", "http://example.com/p": [ { "@value": true } ] } ]
+    }])");
+
+    JsonLdOptions heapOptions;
+    JsonLdApi heapApi(heapOptions);
+    std::string expected = RDFDatasetUtils::toNQuads(heapApi.toRDF(expanded));
+
+    JsonLdOptions arenaOptions;
+    arenaOptions.setUseArena(true);
+    JsonLdApi arenaApi(arenaOptions);
+    EXPECT_EQ(RDFDatasetUtils::toNQuads(arenaApi.toRDF(expanded)), expected);
+    EXPECT_EQ(Arena::current(), nullptr);
+}
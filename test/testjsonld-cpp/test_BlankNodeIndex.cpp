@@ -0,0 +1,82 @@
+#include "BlankNodeIndex.h"
+#include "NQuadsParser.h"
+
+#include <gtest/gtest.h>
+#pragma clang diagnostic push
+#pragma GCC diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#pragma GCC diagnostic ignored "-Wall"
+#pragma GCC diagnostic ignored "-Wextra"
+#include <rapidcheck/gtest.h>
+#pragma clang diagnostic pop
+#pragma GCC diagnostic pop
+
+using namespace RDF;
+
+namespace {
+
+    std::vector<std::uint32_t> quadsOf(const BlankNodeIndex & index, const RDFDataset & dataset,
+                                       const std::string & label) {
+        BlankNodeIndex::NodeId node = index.find(dataset.getTermDictionary()->find(label));
+        EXPECT_NE(node, BlankNodeIndex::NOT_FOUND) << label;
+        if (node == BlankNodeIndex::NOT_FOUND)
+            return {};
+        BlankNodeIndex::QuadPositions positions = index.getQuads(node);
+        return std::vector<std::uint32_t>(positions.begin(), positions.end());
+    }
+
+}
+
+TEST(BlankNodeIndexTest, numbersBlankNodesInOrderOfAppearance) {
+    RDFDataset dataset(JsonLdOptions(), nullptr);
+    NQuadsParser(dataset).parse(
+            "_:b <http://example.com/p> _:a .\n"
+            "<http://example.com/s> <http://example.com/p> \"x\" .\n"
+            "_:a <http://example.com/p> _:c .\n");
+    BlankNodeIndex index(dataset);
+    const TermDictionary & dictionary = *dataset.getTermDictionary();
+
+    ASSERT_EQ(index.size(), 3u);
+    EXPECT_EQ(dictionary.get(index.getLabel(0)), "_:b");
+    EXPECT_EQ(dictionary.get(index.getLabel(1)), "_:a");
+    EXPECT_EQ(dictionary.get(index.getLabel(2)), "_:c");
+    EXPECT_EQ(index.find(dictionary.find("http://example.com/s")), BlankNodeIndex::NOT_FOUND);
+}
+
+TEST(BlankNodeIndexTest, getQuads_positionsInQuadStore) {
+    RDFDataset dataset(JsonLdOptions(), nullptr);
+    NQuadsParser(dataset).parse(
+            "_:a <http://example.com/p> _:b .\n"
+            "<http://example.com/s> <http://example.com/p> \"x\" .\n"
+            "_:b <http://example.com/p> _:c _:g .\n"
+            "_:c <http://example.com/p> _:a .\n");
+    BlankNodeIndex index(dataset);
+
+    // the graph named _:g is stored after the default graph
+    EXPECT_EQ(quadsOf(index, dataset, "_:a"), (std::vector<std::uint32_t>{0, 2}));
+    EXPECT_EQ(quadsOf(index, dataset, "_:b"), (std::vector<std::uint32_t>{0, 3}));
+    EXPECT_EQ(quadsOf(index, dataset, "_:c"), (std::vector<std::uint32_t>{2, 3}));
+    EXPECT_EQ(quadsOf(index, dataset, "_:g"), (std::vector<std::uint32_t>{3}));
+    EXPECT_EQ(dataset.getQuadStore().getSubject(3).value, dataset.getTermDictionary()->find("_:b"));
+}
+
+TEST(BlankNodeIndexTest, occurrences) {
+    RDFDataset dataset(JsonLdOptions(), nullptr);
+    NQuadsParser(dataset).parse(
+            "_:a <http://example.com/p> _:a _:a .\n"
+            "_:a <http://example.com/p> _:b .\n");
+
+    BlankNodeIndex oncePerQuad(dataset);
+    EXPECT_EQ(quadsOf(oncePerQuad, dataset, "_:a"), (std::vector<std::uint32_t>{1, 0}));
+    EXPECT_EQ(quadsOf(oncePerQuad, dataset, "_:b"), (std::vector<std::uint32_t>{1}));
+
+    BlankNodeIndex everyOccurrence(dataset, BlankNodeIndex::Occurrences::EveryOccurrence);
+    EXPECT_EQ(quadsOf(everyOccurrence, dataset, "_:a"), (std::vector<std::uint32_t>{1, 0, 0, 0}));
+    EXPECT_EQ(quadsOf(everyOccurrence, dataset, "_:b"), (std::vector<std::uint32_t>{1}));
+}
+
+TEST(BlankNodeIndexTest, emptyDataset) {
+    RDFDataset dataset(JsonLdOptions(), nullptr);
+    BlankNodeIndex index(dataset);
+    EXPECT_EQ(index.size(), 0u);
+}
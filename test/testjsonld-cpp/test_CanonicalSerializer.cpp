@@ -0,0 +1,89 @@
+#include "CanonicalSerializer.h"
+#include "NQuadsParser.h"
+#include "RDFDatasetUtils.h"
+#include "sha256.h"
+
+#include <algorithm>
+
+#include <gtest/gtest.h>
+#pragma clang diagnostic push
+#pragma GCC diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#pragma GCC diagnostic ignored "-Wall"
+#pragma GCC diagnostic ignored "-Wextra"
+#include <rapidcheck/gtest.h>
+#pragma clang diagnostic pop
+#pragma GCC diagnostic pop
+
+using namespace RDF;
+
+namespace {
+
+    const std::string NQUADS =
+            "_:b <http://example.com/p> \"tab\\there\"@en _:g .\n"
+            "<http://example.com/s> <http://example.com/p> _:b .\n"
+            "_:a <http://example.com/p> \"1\"^^<http://www.w3.org/2001/XMLSchema#integer> <http://example.com/g> .\n"
+            "_:a <http://example.com/p> _:a .\n";
+
+    std::string all(const CanonicalSerializer::Lines & lines) {
+        std::string out;
+        lines.appendTo(out);
+        return out;
+    }
+
+}
+
+TEST(CanonicalSerializerTest, add_fillsGapsWithLabels) {
+    RDFDataset dataset(JsonLdOptions(), nullptr);
+    NQuadsParser(dataset).parse(NQUADS);
+    CanonicalSerializer serializer(dataset);
+    const TermDictionary & dictionary = *dataset.getTermDictionary();
+
+    // the same as relabelling while serializing
+    auto rename = [&dictionary](TermId id) -> const std::string & {
+        static const std::string x = "_:x", y = "_:y";
+        return dictionary.get(id) == "_:a" ? x : y;
+    };
+    CanonicalSerializer::Lines lines;
+    std::string expected;
+    for (size_t i = 0; i < dataset.getQuadStore().size(); i++) {
+        serializer.add(i, [&rename](TermId id, bool) -> const std::string & { return rename(id); }, lines);
+        RDFDatasetUtils::appendNQuad(dataset, i, expected, rename);
+    }
+    EXPECT_EQ(lines.size(), dataset.getQuadStore().size());
+    EXPECT_EQ(all(lines), expected);
+
+    // and graph names can be told apart
+    lines.clear();
+    EXPECT_EQ(lines.size(), 0u);
+    for (size_t i = 0; i < dataset.getQuadStore().size(); i++) {
+        serializer.add(i, [](TermId, bool graphName) -> std::string { return graphName ? "_:g" : "_:n"; }, lines);
+    }
+    lines.sort();
+    EXPECT_EQ(all(lines),
+              "<http://example.com/s> <http://example.com/p> _:n .\n"
+              "_:n <http://example.com/p> \"1\"^^<http://www.w3.org/2001/XMLSchema#integer> <http://example.com/g> .\n"
+              "_:n <http://example.com/p> \"tab\\there\"@en _:g .\n"
+              "_:n <http://example.com/p> _:n .\n");
+}
+
+TEST(CanonicalSerializerTest, digest_sameAsHashingSortedLines) {
+    RDFDataset dataset(JsonLdOptions(), nullptr);
+    NQuadsParser(dataset).parse(NQUADS);
+    CanonicalSerializer serializer(dataset);
+    auto keep = [&dataset](TermId id, bool) -> const std::string & { return dataset.getTermDictionary()->get(id); };
+
+    CanonicalSerializer::Lines lines;
+    std::vector<std::string> expected;
+    for (size_t i = dataset.getQuadStore().size(); i-- > 0;) {
+        serializer.add(i, keep, lines);
+        expected.emplace_back();
+        RDFDatasetUtils::appendNQuad(dataset, i, expected.back());
+    }
+    lines.sort();
+    std::sort(expected.begin(), expected.end());
+
+    SHA256 md;
+    lines.digest(md);
+    EXPECT_EQ(md.digest(), sha256(expected));
+}
@@ -0,0 +1,225 @@
+#include "Context.h"
+#include "JsonLdProcessor.h"
+
+#include <atomic>
+#include <thread>
+
+#include <gtest/gtest.h>
+#pragma clang diagnostic push
+#pragma GCC diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#pragma GCC diagnostic ignored "-Wall"
+#pragma GCC diagnostic ignored "-Wextra"
+#include <rapidcheck/gtest.h>
+#pragma clang diagnostic pop
+#pragma GCC diagnostic pop
+
+using nlohmann::json;
+
+namespace {
+
+    JsonLdOptions optionsWithContexts() {
+        DocumentLoader dl;
+        dl.addDocumentToCache("http://example.com/ctx/name.jsonld",
+                              R"({ "@context": { "name": "http://xmlns.com/foaf/0.1/name" } })");
+        dl.addDocumentToCache("http://example.com/ctx/knows.jsonld",
+                              R"({ "@context": { "knows": { "@id": "http://xmlns.com/foaf/0.1/knows", "@type": "@id" } } })");
+        dl.addDocumentToCache("http://example.com/ctx/both.jsonld",
+                              R"({ "@context": [ "name.jsonld", "knows.jsonld" ] })");
+        dl.addDocumentToCache("http://example.com/ctx/self.jsonld",
+                              R"({ "@context": "http://example.com/ctx/self.jsonld" })");
+        dl.addDocumentToCache("http://example.com/ctx/nocontext.jsonld",
+                              R"({ "name": "http://xmlns.com/foaf/0.1/name" })");
+        JsonLdOptions options("http://example.com/ctx/doc.jsonld");
+        options.setDocumentLoader(dl);
+        return options;
+    }
+
+    std::string errorOf(const json & document) {
+        try {
+            JsonLdProcessor::expand(document, optionsWithContexts());
+        } catch (const JsonLdError & e) {
+            return e.what();
+        }
+        return "";
+    }
+
+}
+
+TEST(ContextTest, parse_remoteContext) {
+    Context context(optionsWithContexts());
+    Context parsed = context.parse(json("http://example.com/ctx/name.jsonld"));
+    EXPECT_EQ(parsed.expandIri("name", false, true), "http://xmlns.com/foaf/0.1/name");
+}
+
+TEST(ContextTest, parse_relativeRemoteContext_resolvedAgainstBase) {
+    Context context(optionsWithContexts());
+    Context parsed = context.parse(json("name.jsonld"));
+    EXPECT_EQ(parsed.expandIri("name", false, true), "http://xmlns.com/foaf/0.1/name");
+}
+
+TEST(ContextTest, parse_remoteContextsAfterBase_resolvedAgainstThatBase) {
+    JsonLdOptions options = optionsWithContexts();
+    options.setBase("http://example.com/elsewhere/doc.jsonld");
+    Context context(options);
+    Context parsed = context.parse(json::parse(R"([
+        { "@base": "http://example.com/ctx/" }, "name.jsonld", "knows.jsonld"
+    ])"));
+    EXPECT_EQ(parsed.expandIri("name", false, true), "http://xmlns.com/foaf/0.1/name");
+    EXPECT_EQ(parsed.expandIri("knows", false, true), "http://xmlns.com/foaf/0.1/knows");
+}
+
+TEST(ContextTest, expand_arrayOfRemoteAndLocalContexts) {
+    json document = json::parse(R"({
+        "@context": [
+            "http://example.com/ctx/name.jsonld",
+            "http://example.com/ctx/knows.jsonld",
+            { "nick": "http://xmlns.com/foaf/0.1/nick" }
+        ],
+        "name": "Alice",
+        "nick": "al",
+        "knows": "http://example.com/bob"
+    })");
+    json expected = json::parse(R"([{
+        "http://xmlns.com/foaf/0.1/name": [ { "@value": "Alice" } ],
+        "http://xmlns.com/foaf/0.1/nick": [ { "@value": "al" } ],
+        "http://xmlns.com/foaf/0.1/knows": [ { "@id": "http://example.com/bob" } ]
+    }])");
+    EXPECT_TRUE(JsonLdUtils::deepCompare(JsonLdProcessor::expand(document, optionsWithContexts()), expected));
+}
+
+TEST(ContextTest, expand_nestedRemoteContexts) {
+    json document = json::parse(R"({
+        "@context": "http://example.com/ctx/both.jsonld",
+        "name": "Alice",
+        "knows": { "@context": "http://example.com/ctx/name.jsonld", "name": "Bob" }
+    })");
+    json expected = json::parse(R"([{
+        "http://xmlns.com/foaf/0.1/name": [ { "@value": "Alice" } ],
+        "http://xmlns.com/foaf/0.1/knows": [ { "http://xmlns.com/foaf/0.1/name": [ { "@value": "Bob" } ] } ]
+    }])");
+    EXPECT_TRUE(JsonLdUtils::deepCompare(JsonLdProcessor::expand(document, optionsWithContexts()), expected));
+}
+
+TEST(ContextTest, expand_recursiveRemoteContext_throws) {
+    EXPECT_EQ(errorOf(json::parse(R"({ "@context": "http://example.com/ctx/self.jsonld" })")).find(
+            JsonLdError::RecursiveContextInclusion), 0u);
+}
+
+TEST(ContextTest, expand_missingRemoteContext_throws) {
+    EXPECT_EQ(errorOf(json::parse(R"({ "@context": [ "http://example.com/ctx/name.jsonld", "http://example.com/ctx/missing.jsonld" ] })")).find(
+            JsonLdError::LoadingRemoteContextFailed), 0u);
+}
+
+TEST(ContextTest, expand_remoteDocumentWithoutContext_throws) {
+    EXPECT_EQ(errorOf(json::parse(R"({ "@context": "http://example.com/ctx/nocontext.jsonld" })")).find(
+            JsonLdError::InvalidRemoteContext), 0u);
+}
+
+TEST(ContextTest, expandIri_derivedContext_doesNotReuseResults) {
+    Context active(JsonLdOptions("http://example.com/"));
+    Context vocab = active.parse(json::parse(R"({ "@vocab": "http://example.com/vocab#" })"));
+    Context term = vocab.parse(json::parse(R"({ "name": "http://xmlns.com/foaf/0.1/name" })"));
+
+    for (int i = 0; i < 2; i++) {
+        EXPECT_EQ(active.expandIri("name", false, true), "name");
+        EXPECT_EQ(vocab.expandIri("name", false, true), "http://example.com/vocab#name");
+        EXPECT_EQ(term.expandIri("name", false, true), "http://xmlns.com/foaf/0.1/name");
+        EXPECT_EQ(vocab.expandIri("name", true, false), "http://example.com/name");
+    }
+
+    // nor does a context changed after it expanded something
+    Context changed = vocab;
+    EXPECT_EQ(changed.expandIri("name", false, true), "http://example.com/vocab#name");
+    changed.insert(std::make_pair(JsonLdConsts::VOCAB, std::string("http://example.org/")));
+    EXPECT_EQ(changed.expandIri("name", false, true), "http://example.org/name");
+    EXPECT_EQ(vocab.expandIri("name", false, true), "http://example.com/vocab#name");
+}
+
+TEST(ContextTest, expandIri_sharedAcrossThreads) {
+    Context context = Context(JsonLdOptions("http://example.com/doc")).parse(json::parse(
+            R"({ "@vocab": "http://example.com/vocab#", "foaf": "http://xmlns.com/foaf/0.1/" })"));
+    std::vector<std::thread> threads;
+    std::atomic<int> mismatches(0);
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&context, &mismatches]() {
+            Context copy = context;
+            for (int i = 0; i < 2000; i++) {
+                std::string key = "p" + std::to_string(i % 100);
+                if (copy.expandIri(key, false, true) != "http://example.com/vocab#" + key ||
+                    copy.expandIri("foaf:" + key, false, true) != "http://xmlns.com/foaf/0.1/" + key)
+                    mismatches++;
+            }
+        });
+    }
+    for (auto & thread : threads)
+        thread.join();
+    EXPECT_EQ(mismatches, 0);
+}
+
+TEST(ContextTest, parse_remoteContextsAcrossThreads) {
+    Context context(optionsWithContexts());
+    std::vector<std::thread> threads;
+    std::atomic<int> mismatches(0);
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&context, &mismatches, t]() {
+            for (int i = 0; i < 50; i++) {
+                // every thread dereferences into the map the parsed contexts share
+                json local = (t + i) % 2 == 0 ? json("name.jsonld") : json::parse(R"(["knows.jsonld", "name.jsonld"])");
+                Context parsed = context.parse(local);
+                if (parsed.expandIri("name", false, true) != "http://xmlns.com/foaf/0.1/name")
+                    mismatches++;
+            }
+        });
+    }
+    for (auto & thread : threads)
+        thread.join();
+    EXPECT_EQ(mismatches, 0);
+}
+
+TEST(ContextTest, getTermDefinition) {
+    Context context = Context(JsonLdOptions("http://example.com/")).parse(json::parse(R"({
+        "@vocab": "http://example.com/vocab#",
+        "foaf": "http://xmlns.com/foaf/0.1/",
+        "knows": { "@id": "foaf:knows", "@type": "@id", "@container": "@set" },
+        "age": { "@type": "http://www.w3.org/2001/XMLSchema#integer" },
+        "label": { "@container": "@language", "@language": null },
+        "children": { "@reverse": "http://example.com/parent", "@container": "@index" },
+        "removed": null
+    })"));
+
+    const TermDefinition * knows = context.getTermDefinition("knows");
+    ASSERT_NE(knows, nullptr);
+    EXPECT_EQ(knows->id, "http://xmlns.com/foaf/0.1/knows");
+    EXPECT_EQ(knows->typeMapping, TermDefinition::TypeMapping::Id);
+    EXPECT_EQ(knows->container, TermDefinition::Container::Set);
+    EXPECT_FALSE(knows->reverse);
+
+    const TermDefinition * age = context.getTermDefinition("age");
+    ASSERT_NE(age, nullptr);
+    EXPECT_EQ(age->id, "http://example.com/vocab#age");
+    EXPECT_EQ(age->typeMapping, TermDefinition::TypeMapping::Iri);
+    EXPECT_EQ(age->type, "http://www.w3.org/2001/XMLSchema#integer");
+
+    const TermDefinition * label = context.getTermDefinition("label");
+    ASSERT_NE(label, nullptr);
+    EXPECT_TRUE(label->hasLanguage);
+    EXPECT_TRUE(label->nullLanguage);
+    EXPECT_EQ(context.getContainer("label"), TermDefinition::Container::Language);
+
+    const TermDefinition * children = context.getTermDefinition("children");
+    ASSERT_NE(children, nullptr);
+    EXPECT_TRUE(children->reverse);
+    EXPECT_TRUE(context.isReverseProperty("children"));
+    EXPECT_EQ(context.getContainer("children"), TermDefinition::Container::Index);
+
+    const TermDefinition * removed = context.getTermDefinition("removed");
+    ASSERT_NE(removed, nullptr);
+    EXPECT_TRUE(removed->null);
+    EXPECT_EQ(context.expandIri("removed", false, true), "");
+
+    EXPECT_EQ(context.getTermDefinition("undefined"), nullptr);
+    EXPECT_EQ(context.getContainer("undefined"), TermDefinition::Container::None);
+    EXPECT_EQ(context.getContainer(JsonLdConsts::LIST), TermDefinition::Container::List);
+    EXPECT_EQ(context.getContainer(JsonLdConsts::GRAPH), TermDefinition::Container::Set);
+}
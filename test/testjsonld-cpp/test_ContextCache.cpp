@@ -0,0 +1,133 @@
+#include "ContextCache.h"
+#include "JsonLdProcessor.h"
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#pragma clang diagnostic push
+#pragma GCC diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#pragma GCC diagnostic ignored "-Wall"
+#pragma GCC diagnostic ignored "-Wextra"
+#include <rapidcheck/gtest.h>
+#pragma clang diagnostic pop
+#pragma GCC diagnostic pop
+
+using nlohmann::json;
+
+namespace {
+
+    json document() {
+        return json::parse(R"({
+            "@context": {
+                "name": "http://xmlns.com/foaf/0.1/name",
+                "knows": { "@id": "http://xmlns.com/foaf/0.1/knows", "@type": "@id" }
+            },
+            "@id": "http://example.com/alice",
+            "name": "Alice",
+            "knows": [
+                { "@context": { "nick": "http://xmlns.com/foaf/0.1/nick" }, "@id": "http://example.com/bob", "nick": "bob" },
+                { "@context": { "nick": "http://xmlns.com/foaf/0.1/nick" }, "@id": "http://example.com/carol", "nick": "carol" }
+            ]
+        })");
+    }
+
+}
+
+TEST(ContextCacheTest, expand_withCache_sameResultAsWithout) {
+    json expected = JsonLdProcessor::expand(document(), JsonLdOptions());
+
+    JsonLdOptions options;
+    auto cache = std::make_shared<ContextCache>();
+    options.setContextCache(cache);
+
+    EXPECT_TRUE(JsonLdProcessor::expand(document(), options) == expected);
+    // the outer context, then the nested one, then the nested one again
+    EXPECT_EQ(cache->getMisses(), 2u);
+    EXPECT_EQ(cache->getHits(), 1u);
+    EXPECT_EQ(cache->size(), 2u);
+
+    EXPECT_TRUE(JsonLdProcessor::expand(document(), options) == expected);
+    EXPECT_EQ(cache->getMisses(), 2u);
+    EXPECT_EQ(cache->getHits(), 4u);
+}
+
+TEST(ContextCacheTest, expand_differentBase_doesNotShareContexts) {
+    auto cache = std::make_shared<ContextCache>();
+    JsonLdOptions options1("http://example.com/1/");
+    options1.setContextCache(cache);
+    JsonLdOptions options2("http://example.com/2/");
+    options2.setContextCache(cache);
+
+    json doc = json::parse(R"({ "@context": { "p": "http://example.com/p" }, "p": { "@id": "x" } })");
+    json expanded1 = JsonLdProcessor::expand(doc, options1);
+    json expanded2 = JsonLdProcessor::expand(doc, options2);
+    EXPECT_EQ(cache->getHits(), 0u);
+    EXPECT_EQ(cache->size(), 2u);
+    EXPECT_EQ(expanded1[0]["http://example.com/p"][0]["@id"].get<std::string>(), "http://example.com/1/x");
+    EXPECT_EQ(expanded2[0]["http://example.com/p"][0]["@id"].get<std::string>(), "http://example.com/2/x");
+}
+
+TEST(ContextCacheTest, expand_cachedContext_usesCallersDocumentLoader) {
+    auto cache = std::make_shared<ContextCache>();
+    const std::string remote = "http://example.com/context.jsonld";
+    DocumentLoader loader1;
+    loader1.addDocumentToCache(remote, R"({ "@context": { "q": "http://example.com/1/q" } })");
+    DocumentLoader loader2;
+    loader2.addDocumentToCache(remote, R"({ "@context": { "q": "http://example.com/2/q" } })");
+
+    JsonLdOptions options1;
+    options1.setContextCache(cache);
+    options1.setDocumentLoader(loader1);
+    JsonLdOptions options2;
+    options2.setContextCache(cache);
+    options2.setDocumentLoader(loader2);
+
+    json doc1 = json::parse(R"({ "@context": { "p": "http://example.com/p" }, "p": "x" })");
+    JsonLdProcessor::expand(doc1, options1);
+
+    // the outer context comes from the cache, the remote one is loaded with options2
+    json doc2 = json::parse(R"({ "@context": { "p": "http://example.com/p" },
+        "p": { "@context": "http://example.com/context.jsonld", "q": "y" } })");
+    json expanded = JsonLdProcessor::expand(doc2, options2);
+    EXPECT_EQ(cache->getHits(), 1u);
+    EXPECT_TRUE(expanded[0]["http://example.com/p"][0].contains("http://example.com/2/q"));
+}
+
+TEST(ContextCacheTest, insert_stopsAtMaxEntries) {
+    JsonLdOptions options;
+    options.setContextCache(std::make_shared<ContextCache>(1));
+    Context context(options);
+    for (int i = 0; i < 3; i++)
+        context.parse(json::object({ { "p" + std::to_string(i), "http://example.com/p" } }));
+    EXPECT_EQ(options.getContextCache()->size(), 1u);
+}
+
+TEST(ContextCacheTest, expand_concurrently_sharesCache) {
+    json expected = JsonLdProcessor::expand(document(), JsonLdOptions());
+
+    JsonLdOptions options;
+    auto cache = std::make_shared<ContextCache>();
+    options.setContextCache(cache);
+
+    const int threadCount = 4;
+    const int iterations = 20;
+    std::vector<int> matches(threadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < iterations; i++) {
+                if (JsonLdProcessor::expand(document(), options) == expected)
+                    matches[t]++;
+            }
+        });
+    }
+    for (auto & thread : threads)
+        thread.join();
+
+    for (int t = 0; t < threadCount; t++)
+        EXPECT_EQ(matches[t], iterations);
+    EXPECT_EQ(cache->size(), 2u);
+    EXPECT_EQ(cache->getHits() + cache->getMisses(), 3u * threadCount * iterations);
+}
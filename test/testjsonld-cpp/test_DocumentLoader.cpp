@@ -1,6 +1,9 @@
 #include "DocumentLoader.cpp"
 #include "testHelpers.h"
 
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 #pragma clang diagnostic push
 #pragma GCC diagnostic push
@@ -38,5 +41,93 @@ TEST(DocumentLoaderTest, load_document_from_cache_miss) {
     EXPECT_THROW(dl.loadDocument("bar.json"), std::runtime_error);
 }
 
+TEST(DocumentLoaderTest, load_twice_sharesDocument) {
+    DocumentLoader dl;
+    std::string docPath = resolvePath("test/testjsonld-cpp/test_data/pi-is-four.json");
 
+    RemoteDocument d1 = dl.loadDocument(docPath);
+    RemoteDocument d2 = dl.loadDocument(docPath);
+    EXPECT_EQ(d1.getDocumentPtr(), d2.getDocumentPtr());
+    EXPECT_EQ(dl.getCache()->getMisses(), 1u);
+    EXPECT_EQ(dl.getCache()->getHits(), 1u);
+    EXPECT_GT(dl.getCache()->getBytes(), 0u);
+}
+
+TEST(DocumentLoaderTest, copies_shareCache) {
+    DocumentLoader dl;
+    DocumentLoader copy = dl;
+    dl.addDocumentToCache("foo.json", R"({ "pi": 3 })");
+
+    EXPECT_EQ(3, copy.loadDocument("foo.json").getDocument()["pi"]);
+    EXPECT_EQ(dl.getCache(), copy.getCache());
+}
+
+TEST(DocumentLoaderTest, load_evictsLeastRecentlyUsed) {
+    DocumentLoader dl(std::make_shared<DocumentCache>(2));
+    std::string path1 = resolvePath("test/testjsonld-cpp/test_data/expand-0001-in.jsonld");
+    std::string path2 = resolvePath("test/testjsonld-cpp/test_data/expand-0002-in.jsonld");
+    std::string path3 = resolvePath("test/testjsonld-cpp/test_data/expand-0003-in.jsonld");
+
+    auto doc1 = dl.loadDocument(path1).getDocumentPtr();
+    auto doc2 = dl.loadDocument(path2).getDocumentPtr();
+    dl.loadDocument(path1);
+    dl.loadDocument(path3);
+    EXPECT_EQ(dl.getCache()->size(), 2u);
+    EXPECT_EQ(dl.getCache()->getEvictions(), 1u);
+
+    // path2 was the least recently used
+    EXPECT_EQ(dl.loadDocument(path1).getDocumentPtr(), doc1);
+    EXPECT_NE(dl.loadDocument(path2).getDocumentPtr(), doc2);
+    // an evicted document is still valid for whoever holds it
+    EXPECT_TRUE(*dl.loadDocument(path2).getDocumentPtr() == *doc2);
+}
 
+TEST(DocumentLoaderTest, load_respectsMaxBytes) {
+    std::string path1 = resolvePath("test/testjsonld-cpp/test_data/expand-0001-in.jsonld");
+    std::string path2 = resolvePath("test/testjsonld-cpp/test_data/expand-0002-in.jsonld");
+    size_t size1 = getFileContents(path1).size();
+    size_t size2 = getFileContents(path2).size();
+
+    DocumentLoader dl(std::make_shared<DocumentCache>(DocumentCache::DEFAULT_MAX_ENTRIES, std::max(size1, size2)));
+    dl.loadDocument(path1);
+    dl.loadDocument(path2);
+    EXPECT_EQ(dl.getCache()->size(), 1u);
+    EXPECT_EQ(dl.getCache()->getBytes(), size2);
+    EXPECT_EQ(dl.getCache()->getEvictions(), 1u);
+}
+
+TEST(DocumentLoaderTest, addDocumentToCache_isNeverEvicted) {
+    DocumentLoader dl(std::make_shared<DocumentCache>(1));
+    dl.addDocumentToCache("foo.json", R"({ "pi": 3 })");
+    dl.loadDocument(resolvePath("test/testjsonld-cpp/test_data/expand-0001-in.jsonld"));
+    dl.loadDocument(resolvePath("test/testjsonld-cpp/test_data/expand-0002-in.jsonld"));
+
+    EXPECT_EQ(3, dl.loadDocument("foo.json").getDocument()["pi"]);
+    EXPECT_EQ(dl.getCache()->size(), 2u);
+}
+
+TEST(DocumentLoaderTest, load_concurrently_sharesCache) {
+    DocumentLoader dl;
+    std::string docPath = resolvePath("test/testjsonld-cpp/test_data/pi-is-four.json");
+
+    const int threadCount = 4;
+    const int iterations = 50;
+    std::vector<int> matches(threadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+        threads.emplace_back([&, t]() {
+            DocumentLoader loader = dl;
+            for (int i = 0; i < iterations; i++) {
+                if (loader.loadDocument(docPath).getDocument()["pi"] == 4)
+                    matches[t]++;
+            }
+        });
+    }
+    for (auto & thread : threads)
+        thread.join();
+
+    for (int t = 0; t < threadCount; t++)
+        EXPECT_EQ(matches[t], iterations);
+    EXPECT_EQ(dl.getCache()->size(), 1u);
+    EXPECT_EQ(dl.getCache()->getHits() + dl.getCache()->getMisses(), 1u * threadCount * iterations);
+}
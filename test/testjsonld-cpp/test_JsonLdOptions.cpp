@@ -0,0 +1,41 @@
+#include "JsonLdOptions.h"
+
+#include <gtest/gtest.h>
+#pragma clang diagnostic push
+#pragma GCC diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#pragma GCC diagnostic ignored "-Wall"
+#pragma GCC diagnostic ignored "-Wextra"
+#include <rapidcheck/gtest.h>
+#pragma clang diagnostic pop
+#pragma GCC diagnostic pop
+
+using nlohmann::json;
+
+TEST(JsonLdOptionsTest, copy_sharesHeavyMembers) {
+    JsonLdOptions options("http://example.com/");
+    options.setExpandContext(json::parse(R"({ "@context": { "name": "http://xmlns.com/foaf/0.1/name" } })"));
+
+    JsonLdOptions copy = options;
+    EXPECT_EQ(&copy.getBase(), &options.getBase());
+    EXPECT_EQ(&copy.getExpandContext(), &options.getExpandContext());
+    EXPECT_EQ(copy.getDocumentLoader().getCache(), options.getDocumentLoader().getCache());
+}
+
+TEST(JsonLdOptionsTest, set_onCopy_doesNotChangeOriginal) {
+    JsonLdOptions options("http://example.com/");
+    options.setExpandContext(json::parse(R"({ "name": "http://xmlns.com/foaf/0.1/name" })"));
+
+    JsonLdOptions copy = options;
+    copy.setBase("http://example.org/");
+    copy.setExpandContext(json());
+    EXPECT_EQ(options.getBase(), "http://example.com/");
+    EXPECT_EQ(options.getExpandContext().size(), 1u);
+    EXPECT_EQ(copy.getBase(), "http://example.org/");
+    EXPECT_TRUE(copy.getExpandContext().is_null());
+}
+
+TEST(JsonLdOptionsTest, getExpandContext_unset_isNull) {
+    JsonLdOptions options;
+    EXPECT_TRUE(options.getExpandContext().is_null());
+}
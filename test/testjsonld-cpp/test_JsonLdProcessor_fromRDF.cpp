@@ -0,0 +1,204 @@
+#include "JsonLdProcessor.h"
+#include "NQuadsParser.h"
+#include "testHelpers.h"
+
+#include <gtest/gtest.h>
+#pragma clang diagnostic push
+#pragma GCC diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#pragma GCC diagnostic ignored "-Wall"
+#pragma GCC diagnostic ignored "-Wextra"
+#include <rapidcheck/gtest.h>
+#pragma clang diagnostic pop
+#pragma GCC diagnostic pop
+
+using nlohmann::json;
+using RDF::RDFDataset;
+
+namespace {
+
+    json fromRDF(const std::string & nquads, const JsonLdOptions & options = JsonLdOptions()) {
+        return JsonLdProcessor::fromRDF(nquads, options);
+    }
+
+    std::vector<json> streamed(const std::string & nquads) {
+        std::vector<json> nodes;
+        JsonLdProcessor::fromRDF(nquads, JsonLdOptions(), [&nodes](json node) {
+            nodes.push_back(std::move(node));
+        });
+        return nodes;
+    }
+
+}
+
+TEST(JsonLdProcessorTest, fromRDF_literalsAndReferences) {
+    json expected = json::parse(R"([
+        { "@id": "_:b0", "http://example.com/p": [ { "@id": "http://example.com/o" } ] },
+        {
+            "@id": "http://example.com/s",
+            "@type": [ "http://example.com/T" ],
+            "http://example.com/p": [
+                { "@value": "plain" },
+                { "@value": "hallo", "@language": "de" },
+                { "@value": "1", "@type": "http://www.w3.org/2001/XMLSchema#integer" },
+                { "@id": "_:b0" }
+            ]
+        }
+    ])");
+    json actual = fromRDF(
+            "<http://example.com/s> <http://www.w3.org/1999/02/22-rdf-syntax-ns#type> <http://example.com/T> .\n"
+            "<http://example.com/s> <http://example.com/p> \"plain\" .\n"
+            "<http://example.com/s> <http://example.com/p> \"hallo\"@de .\n"
+            "<http://example.com/s> <http://example.com/p> \"1\"^^<http://www.w3.org/2001/XMLSchema#integer> .\n"
+            "<http://example.com/s> <http://example.com/p> _:b0 .\n"
+            "_:b0 <http://example.com/p> <http://example.com/o> .\n");
+    EXPECT_TRUE(actual == expected);
+}
+
+TEST(JsonLdProcessorTest, fromRDF_useRdfTypeAndNativeTypes) {
+    std::string nquads =
+            "<http://example.com/s> <http://www.w3.org/1999/02/22-rdf-syntax-ns#type> <http://example.com/T> .\n"
+            "<http://example.com/s> <http://example.com/p> \"true\"^^<http://www.w3.org/2001/XMLSchema#boolean> .\n"
+            "<http://example.com/s> <http://example.com/p> \"-12\"^^<http://www.w3.org/2001/XMLSchema#integer> .\n"
+            "<http://example.com/s> <http://example.com/p> \"1.5E0\"^^<http://www.w3.org/2001/XMLSchema#double> .\n"
+            "<http://example.com/s> <http://example.com/p> \"NaN\"^^<http://www.w3.org/2001/XMLSchema#double> .\n"
+            "<http://example.com/s> <http://example.com/p> \"x\"^^<http://www.w3.org/2001/XMLSchema#string> .\n";
+    JsonLdOptions options;
+    options.setUseRdfType(true);
+    options.setUseNativeTypes(true);
+    json expected = json::parse(R"([{
+        "@id": "http://example.com/s",
+        "http://www.w3.org/1999/02/22-rdf-syntax-ns#type": [ { "@id": "http://example.com/T" } ],
+        "http://example.com/p": [
+            { "@value": true },
+            { "@value": -12 },
+            { "@value": 1.5 },
+            { "@value": "NaN", "@type": "http://www.w3.org/2001/XMLSchema#double" },
+            { "@value": "x" }
+        ]
+    }])");
+    EXPECT_TRUE(fromRDF(nquads, options) == expected);
+}
+
+TEST(JsonLdProcessorTest, fromRDF_lists) {
+    std::string nquads =
+            "<http://example.com/s> <http://example.com/list> _:l0 .\n"
+            "<http://example.com/s> <http://example.com/empty> <http://www.w3.org/1999/02/22-rdf-syntax-ns#nil> .\n"
+            "<http://example.com/s> <http://example.com/partial> _:p0 .\n"
+            "_:l0 <http://www.w3.org/1999/02/22-rdf-syntax-ns#first> \"a\" .\n"
+            "_:l0 <http://www.w3.org/1999/02/22-rdf-syntax-ns#rest> _:l1 .\n"
+            "_:l1 <http://www.w3.org/1999/02/22-rdf-syntax-ns#type> <http://www.w3.org/1999/02/22-rdf-syntax-ns#List> .\n"
+            "_:l1 <http://www.w3.org/1999/02/22-rdf-syntax-ns#first> <http://example.com/b> .\n"
+            "_:l1 <http://www.w3.org/1999/02/22-rdf-syntax-ns#rest> <http://www.w3.org/1999/02/22-rdf-syntax-ns#nil> .\n"
+            "_:p0 <http://example.com/label> \"not a list node\" .\n"
+            "_:p0 <http://www.w3.org/1999/02/22-rdf-syntax-ns#first> \"c\" .\n"
+            "_:p0 <http://www.w3.org/1999/02/22-rdf-syntax-ns#rest> _:p1 .\n"
+            "_:p1 <http://www.w3.org/1999/02/22-rdf-syntax-ns#first> \"d\" .\n"
+            "_:p1 <http://www.w3.org/1999/02/22-rdf-syntax-ns#rest> <http://www.w3.org/1999/02/22-rdf-syntax-ns#nil> .\n";
+    json expected = json::parse(R"([
+        {
+            "@id": "_:p0",
+            "http://example.com/label": [ { "@value": "not a list node" } ],
+            "http://www.w3.org/1999/02/22-rdf-syntax-ns#first": [ { "@value": "c" } ],
+            "http://www.w3.org/1999/02/22-rdf-syntax-ns#rest": [ { "@list": [ { "@value": "d" } ] } ]
+        },
+        {
+            "@id": "http://example.com/s",
+            "http://example.com/list": [ { "@list": [ { "@value": "a" }, { "@id": "http://example.com/b" } ] } ],
+            "http://example.com/empty": [ { "@list": [] } ],
+            "http://example.com/partial": [ { "@id": "_:p0" } ]
+        }
+    ])");
+    EXPECT_TRUE(fromRDF(nquads) == expected);
+}
+
+TEST(JsonLdProcessorTest, fromRDF_sharedOrCyclicListNodes_areNotConverted) {
+    std::string nquads =
+            "<http://example.com/s> <http://example.com/p> _:l0 .\n"
+            "<http://example.com/t> <http://example.com/p> _:l0 .\n"
+            "_:l0 <http://www.w3.org/1999/02/22-rdf-syntax-ns#first> \"a\" .\n"
+            "_:l0 <http://www.w3.org/1999/02/22-rdf-syntax-ns#rest> <http://www.w3.org/1999/02/22-rdf-syntax-ns#nil> .\n"
+            "<http://example.com/u> <http://example.com/p> _:c0 .\n"
+            "_:c0 <http://www.w3.org/1999/02/22-rdf-syntax-ns#first> \"b\" .\n"
+            "_:c0 <http://www.w3.org/1999/02/22-rdf-syntax-ns#rest> _:c1 .\n"
+            "_:c1 <http://www.w3.org/1999/02/22-rdf-syntax-ns#first> \"c\" .\n"
+            "_:c1 <http://www.w3.org/1999/02/22-rdf-syntax-ns#rest> _:c0 .\n";
+    json result = fromRDF(nquads);
+    ASSERT_EQ(result.size(), 6u);
+    EXPECT_EQ(result[0]["@id"], "_:c0");
+    EXPECT_EQ(result[1]["@id"], "_:c1");
+    EXPECT_EQ(result[2]["@id"], "_:l0");
+    EXPECT_TRUE(result[3]["http://example.com/p"] == json::parse(R"([ { "@id": "_:l0" } ])"));
+    EXPECT_TRUE(result[5]["http://example.com/p"] == json::parse(R"([ { "@id": "_:c0" } ])"));
+}
+
+TEST(JsonLdProcessorTest, fromRDF_namedGraphs) {
+    std::string nquads =
+            "<http://example.com/g1> <http://example.com/p> \"in default\" .\n"
+            "<http://example.com/s> <http://example.com/p> \"in g1\" <http://example.com/g1> .\n"
+            "<http://example.com/s> <http://example.com/p> \"in g2\" _:g2 .\n";
+    json expected = json::parse(R"([
+        {
+            "@id": "_:g2",
+            "@graph": [ { "@id": "http://example.com/s", "http://example.com/p": [ { "@value": "in g2" } ] } ]
+        },
+        {
+            "@id": "http://example.com/g1",
+            "http://example.com/p": [ { "@value": "in default" } ],
+            "@graph": [ { "@id": "http://example.com/s", "http://example.com/p": [ { "@value": "in g1" } ] } ]
+        }
+    ])");
+    EXPECT_TRUE(fromRDF(nquads) == expected);
+}
+
+TEST(JsonLdProcessorTest, fromRDF_sink_emitsSortedSubjectsInInputOrder) {
+    std::string nquads =
+            "<http://example.com/b> <http://example.com/p> _:l0 .\n"
+            "<http://example.com/c> <http://example.com/p> \"c\" .\n"
+            "_:a <http://example.com/p> \"a\" .\n"
+            "_:l0 <http://www.w3.org/1999/02/22-rdf-syntax-ns#first> \"x\" .\n"
+            "_:l0 <http://www.w3.org/1999/02/22-rdf-syntax-ns#rest> <http://www.w3.org/1999/02/22-rdf-syntax-ns#nil> .\n";
+    std::vector<json> nodes = streamed(nquads);
+    ASSERT_EQ(nodes.size(), 3u);
+    EXPECT_EQ(nodes[0]["@id"], "http://example.com/b");
+    EXPECT_TRUE(nodes[0]["http://example.com/p"] == json::parse(R"([ { "@list": [ { "@value": "x" } ] } ])"));
+    EXPECT_EQ(nodes[1]["@id"], "http://example.com/c");
+    EXPECT_EQ(nodes[2]["@id"], "_:a");
+}
+
+TEST(JsonLdProcessorTest, fromRDF_sink_groupsUnsortedSubjects) {
+    std::string nquads =
+            "<http://example.com/b> <http://example.com/p> \"1\" .\n"
+            "<http://example.com/a> <http://example.com/p> \"2\" .\n"
+            "<http://example.com/b> <http://example.com/p> \"3\" .\n";
+    std::vector<json> nodes = streamed(nquads);
+    ASSERT_EQ(nodes.size(), 2u);
+    json all = json::array();
+    for (auto & node : nodes)
+        all.push_back(node);
+    EXPECT_TRUE(JsonLdUtils::deepCompare(all, fromRDF(nquads)));
+}
+
+TEST(JsonLdProcessorTest, fromRDF_sink_unsortedSubjectsInOrderOfFirstAppearance) {
+    std::string nquads =
+            "<http://example.com/b> <http://example.com/p> <http://example.com/a> .\n"
+            "<http://example.com/c> <http://example.com/p> \"1\" .\n"
+            "<http://example.com/a> <http://example.com/p> \"2\" .\n"
+            "<http://example.com/c> <http://example.com/p> \"3\" .\n";
+    std::vector<json> nodes = streamed(nquads);
+    ASSERT_EQ(nodes.size(), 3u);
+    EXPECT_EQ(nodes[0]["@id"], "http://example.com/b");
+    EXPECT_EQ(nodes[1]["@id"], "http://example.com/c");
+    EXPECT_EQ(nodes[1]["http://example.com/p"].size(), 2u);
+    EXPECT_EQ(nodes[2]["@id"], "http://example.com/a");
+}
+
+TEST(JsonLdProcessorTest, fromRDF_canonicalNQuads_roundTripsThroughToRDF) {
+    for (int i = 1; i <= 57; i++) {
+        std::string canonical = getExpectedRDF("normalize", getTestNumberStr(i));
+        json document = fromRDF(canonical);
+        JsonLdApi api{JsonLdOptions()};
+        RDFDataset dataset = api.toRDF(document);
+        EXPECT_EQ(api.normalize(dataset), canonical) << "normalize-" << getTestNumberStr(i);
+    }
+}
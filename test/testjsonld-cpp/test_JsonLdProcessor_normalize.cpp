@@ -259,3 +259,19 @@ TEST(JsonLdProcessorTest, normalize_0057) {
     performNormalizeTest(57);
 }
 
+
+TEST(JsonLdProcessorTest, normalize_inParallel_sameAsSequential) {
+    for (int i = 1; i <= 57; i++) {
+        std::string testNumberStr = getTestNumberStr(i);
+        std::string baseUri = getBaseUri("normalize", testNumberStr);
+
+        DocumentLoader dl;
+        dl.addDocumentToCache(baseUri, getInputStr("normalize", testNumberStr));
+        JsonLdOptions opts(baseUri);
+        opts.setDocumentLoader(dl);
+        opts.setNormalizationThreads(4);
+
+        EXPECT_EQ(getExpectedRDF("normalize", testNumberStr), JsonLdProcessor::normalize(baseUri, opts))
+                << "normalize-" << testNumberStr;
+    }
+}
@@ -47,10 +47,9 @@ TEST(JsonLdProcessorTest, toRDF_0004) {
     performToRDFTest(4);
 }
 
-// skip until I have better utf8 char handling
-//TEST(JsonLdProcessorTest, toRDF_0005) {
-//    performToRDFTest(5);
-//}
+TEST(JsonLdProcessorTest, toRDF_0005) {
+    performToRDFTest(5);
+}
 
 TEST(JsonLdProcessorTest, toRDF_0006) {
     performToRDFTest(6);
@@ -292,10 +291,9 @@ TEST(JsonLdProcessorTest, toRDF_0069) {
     performToRDFTest(69);
 }
 
-// skip until I have better utf8 char handling
-//TEST(JsonLdProcessorTest, toRDF_0070) {
-//    performToRDFTest(70);
-//}
+TEST(JsonLdProcessorTest, toRDF_0070) {
+    performToRDFTest(70);
+}
 
 TEST(JsonLdProcessorTest, toRDF_0071) {
     performToRDFTest(71);
@@ -313,10 +311,9 @@ TEST(JsonLdProcessorTest, toRDF_0074) {
     performToRDFTest(74);
 }
 
-// skip until I have better utf8 char handling
-//TEST(JsonLdProcessorTest, toRDF_0075) {
-//    performToRDFTest(75);
-//}
+TEST(JsonLdProcessorTest, toRDF_0075) {
+    performToRDFTest(75);
+}
 
 TEST(JsonLdProcessorTest, toRdf_0076) {
     performToRDFTest(76);
@@ -499,14 +496,11 @@ TEST(JsonLdProcessorTest, toRdf_0119) {
 //
 //    for(auto i = 1; i <= 119; ++i) {
 //        switch(i) {
-//            case 5:  // skip until I have better utf8 char handling
 //            case 21: // doesn't exist
 //            case 37: // doesn't exist
 //            case 38: // doesn't exist
 //            case 39: // doesn't exist
 //            case 40: // doesn't exist
-//            case 70: // skip until I have better utf8 char handling
-//            case 75: // skip until I have better utf8 char handling
 //            case 118:// skip until I have generalized RDF flag implemented
 //                continue;
 //            default:
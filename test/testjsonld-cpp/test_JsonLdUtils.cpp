@@ -349,3 +349,37 @@ TEST(JsonLdUtilsTest, test_iteration_order) {
     EXPECT_EQ("d", *it);
 
 }
+
+TEST(JsonLdUtilsTest, getKeyword) {
+    using JsonLdConsts::Keyword;
+    const std::vector<std::pair<std::string, Keyword>> keywords = {
+            {"@base", Keyword::Base}, {"@container", Keyword::Container}, {"@context", Keyword::Context},
+            {"@default", Keyword::Default}, {"@embed", Keyword::Embed}, {"@explicit", Keyword::Explicit},
+            {"@graph", Keyword::Graph}, {"@id", Keyword::Id}, {"@index", Keyword::Index},
+            {"@language", Keyword::Language}, {"@list", Keyword::List}, {"@omitDefault", Keyword::OmitDefault},
+            {"@preserve", Keyword::Preserve}, {"@requireAll", Keyword::RequireAll}, {"@reverse", Keyword::Reverse},
+            {"@set", Keyword::Set}, {"@type", Keyword::Type}, {"@value", Keyword::Value}, {"@vocab", Keyword::Vocab}
+    };
+    for (const auto & keyword : keywords) {
+        EXPECT_EQ(JsonLdUtils::getKeyword(keyword.first), keyword.second) << keyword.first;
+        EXPECT_TRUE(JsonLdUtils::isKeyword(keyword.first)) << keyword.first;
+    }
+
+    for (const std::string notAKeyword : {"", "@", "id", "@ID", "@idx", "@vocaB", "@valeu", "@none",
+                                          "@embedChildren", "@typ", "#type", "http://example.com/@type"}) {
+        EXPECT_EQ(JsonLdUtils::getKeyword(notAKeyword), Keyword::NotAKeyword) << notAKeyword;
+        EXPECT_FALSE(JsonLdUtils::isKeyword(notAKeyword)) << notAKeyword;
+    }
+}
+
+TEST(JsonLdUtilsTest, deepHash_orderedArrays) {
+    auto hash = [](const json & j) { return JsonLdUtils::deepHash(j, true); };
+    EXPECT_EQ(hash(json::parse(R"({"a": [1, "x", null], "b": true})")),
+              hash(json::parse(R"({"b": true, "a": [1, "x", null]})")));
+    EXPECT_EQ(hash(json(1)), hash(json(1u)));
+    EXPECT_EQ(hash(json(1)), hash(json(1.0)));
+    EXPECT_NE(hash(json("a")), hash(json("b")));
+    EXPECT_NE(hash(json::parse(R"(["a", "b"])")), hash(json::parse(R"(["b", "a"])")));
+    EXPECT_NE(hash(json::parse(R"({"a": "b"})")), hash(json::parse(R"({"b": "a"})")));
+    EXPECT_EQ(JsonLdUtils::deepHash(json::parse(R"(["a", "b"])")), JsonLdUtils::deepHash(json::parse(R"(["b", "a"])")));
+}
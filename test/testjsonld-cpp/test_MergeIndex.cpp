@@ -0,0 +1,100 @@
+#include "MergeIndex.h"
+#include "JsonLdConsts.h"
+#include "JsonLdUtils.h"
+
+#include <gtest/gtest.h>
+#pragma clang diagnostic push
+#pragma GCC diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#pragma GCC diagnostic ignored "-Wall"
+#pragma GCC diagnostic ignored "-Wextra"
+#include <rapidcheck/gtest.h>
+#pragma clang diagnostic pop
+#pragma GCC diagnostic pop
+
+namespace {
+
+    const char * VALUES[] = {
+            R"({ "@id": "http://example.com/a" })",
+            R"({ "@id": "http://example.com/b" })",
+            R"({ "@id": "http://example.com/a" })",
+            R"({ "@value": 1 })",
+            R"({ "@value": 1.0 })",
+            R"({ "@value": -0.0 })",
+            R"({ "@value": 0 })",
+            R"({ "@value": "1" })",
+            R"({ "@value": true })",
+            R"({ "@value": null })",
+            R"({ "@value": "x", "@type": ["http://example.com/t", "http://example.com/u"] })",
+            R"({ "@value": "x", "@type": ["http://example.com/u", "http://example.com/t"] })",
+            R"({ "@list": [{ "@value": 1 }] })",
+            R"({ "@list": [{ "@value": 1 }] })",
+            R"("http://example.com/t")",
+            R"("http://example.com/t")",
+            R"({ "@id": "http://example.com/b" })"
+    };
+
+}
+
+TEST(MergeIndexTest, mergeValue_sameAsJsonLdUtils) {
+    arena_json expected = arena_json::object();
+    arena_json actual = arena_json::object();
+    MergeIndex index;
+    for (const std::string & property : {std::string("http://example.com/p"), JsonLdConsts::LIST}) {
+        for (const char * value : VALUES) {
+            arena_json v = arena_json::parse(value);
+            JsonLdUtils::mergeValue(expected, property, v);
+            index.mergeValue(actual, property, v);
+        }
+    }
+    EXPECT_TRUE(actual == expected);
+    EXPECT_EQ(actual["http://example.com/p"].size(), 11u);
+    EXPECT_EQ(actual[JsonLdConsts::LIST].size(), 17u);
+}
+
+TEST(MergeIndexTest, mergeValue_indexesValuesAddedBehindItsBack) {
+    arena_json node = arena_json::object();
+    MergeIndex index;
+    index.mergeValue(node, "p", arena_json("a"));
+    node["p"].push_back("b");
+    index.mergeValue(node, "p", arena_json("b"));
+    EXPECT_EQ(node["p"].size(), 2u);
+
+    // or replaced
+    node["p"] = arena_json::array({"c"});
+    index.mergeValue(node, "p", arena_json("a"));
+    index.mergeValue(node, "p", arena_json("c"));
+    EXPECT_TRUE(node["p"] == arena_json::array({"c", "a"}));
+
+    // null objects are left alone, as with JsonLdUtils::mergeValue
+    arena_json none;
+    index.mergeValue(none, "p", arena_json("a"));
+    EXPECT_TRUE(none.is_null());
+}
+
+TEST(MergeIndexTest, mergeValue_manyValues) {
+    arena_json node = arena_json::object();
+    MergeIndex index;
+    for (int round = 0; round < 2; round++) {
+        for (int i = 0; i < 20000; i++) {
+            arena_json reference = arena_json::object();
+            reference[JsonLdConsts::ID] = "http://example.com/member/" + std::to_string(i);
+            index.mergeValue(node, "http://example.com/member", reference);
+        }
+    }
+    EXPECT_EQ(node["http://example.com/member"].size(), 20000u);
+}
+
+TEST(MergeIndexTest, deepHash_sameForDeepEqualValues) {
+    for (const char * value : VALUES) {
+        for (const char * other : VALUES) {
+            arena_json v = arena_json::parse(value);
+            arena_json o = arena_json::parse(other);
+            if (JsonLdUtils::deepCompare(v, o)) {
+                EXPECT_EQ(JsonLdUtils::deepHash(v), JsonLdUtils::deepHash(o)) << value << " " << other;
+            }
+        }
+    }
+    EXPECT_EQ(JsonLdUtils::deepHash(nlohmann::json::parse(VALUES[10])),
+              JsonLdUtils::deepHash(arena_json::parse(VALUES[10])));
+}
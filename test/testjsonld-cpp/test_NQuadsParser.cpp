@@ -0,0 +1,163 @@
+#include "NQuadsParser.h"
+#include "RDFDatasetUtils.h"
+#include "JsonLdApi.h"
+#include "testHelpers.h"
+
+#include <cstdio>
+
+#include <gtest/gtest.h>
+#pragma clang diagnostic push
+#pragma GCC diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#pragma GCC diagnostic ignored "-Wall"
+#pragma GCC diagnostic ignored "-Wextra"
+#include <rapidcheck/gtest.h>
+#pragma clang diagnostic pop
+#pragma GCC diagnostic pop
+
+using RDF::NQuadsParser;
+using RDF::RDFDataset;
+
+namespace {
+
+    RDFDataset parse(const std::string & nquads) {
+        RDFDataset dataset(JsonLdOptions(), nullptr);
+        NQuadsParser parser(dataset);
+        parser.parse(nquads);
+        return dataset;
+    }
+
+    std::string errorOf(const std::string & nquads) {
+        try {
+            parse(nquads);
+        } catch (const JsonLdError & e) {
+            return e.what();
+        }
+        return "";
+    }
+
+}
+
+TEST(NQuadsParserTest, parse_roundTripsToNQuads) {
+    std::string nquads =
+            "<http://example.com/s> <http://example.com/p> \"1\"^^<http://www.w3.org/2001/XMLSchema#integer> .\n"
+            "<http://example.com/s> <http://example.com/p> \"hallo\"@de .\n"
+            "<http://example.com/s> <http://example.com/p> \"plain\" .\n"
+            "<http://example.com/s> <http://example.com/p> _:b0 .\n"
+            "_:b0 <http://example.com/p> <http://example.com/o> <http://example.com/g> .\n"
+            "_:b0 <http://example.com/p> <http://example.com/o> _:g .\n";
+    RDFDataset dataset = parse(nquads);
+    EXPECT_EQ(dataset.getQuadStore().size(), 6u);
+    EXPECT_EQ(dataset.graphNames(), (std::set<std::string>{ "@default", "_:g", "http://example.com/g" }));
+    EXPECT_EQ(RDFDatasetUtils::toNQuads(dataset), nquads);
+}
+
+TEST(NQuadsParserTest, parse_escapes) {
+    RDFDataset dataset = parse(
+            "<http://example.com/\\u0073> <http://example.com/p> \"a\\\"b\\\\c\\nd\\u00E9\\U0001F600\" .\n");
+    const RDF::TermDictionary & dictionary = *dataset.getTermDictionary();
+    EXPECT_EQ(dictionary.get(dataset.getQuadStore().getSubject(0).value), "http://example.com/s");
+    EXPECT_EQ(dictionary.get(dataset.getQuadStore().getObject(0).value), "a\"b\\c\nd\xC3\xA9\xF0\x9F\x98\x80");
+}
+
+TEST(NQuadsParserTest, parse_commentsBlankLinesAndCrLf) {
+    RDFDataset dataset = parse(
+            "# a comment\r\n"
+            "\r\n"
+            "  <http://example.com/s>\t<http://example.com/p> _:b.x . # trailing comment\r\n"
+            "<http://example.com/s> <http://example.com/p> _:b1.");
+    ASSERT_EQ(dataset.getQuadStore().size(), 2u);
+    const RDF::TermDictionary & dictionary = *dataset.getTermDictionary();
+    EXPECT_EQ(dictionary.get(dataset.getQuadStore().getObject(0).value), "_:b.x");
+    EXPECT_EQ(dictionary.get(dataset.getQuadStore().getObject(1).value), "_:b1");
+}
+
+TEST(NQuadsParserTest, parse_groupsGraphsAndDropsDuplicates) {
+    RDFDataset dataset = parse(
+            "<http://example.com/a> <http://example.com/p> <http://example.com/o> <http://example.com/g> .\n"
+            "<http://example.com/b> <http://example.com/p> <http://example.com/o> .\n"
+            "<http://example.com/c> <http://example.com/p> <http://example.com/o> <http://example.com/g> .\n"
+            "<http://example.com/a> <http://example.com/p> <http://example.com/o> <http://example.com/g> .\n");
+    EXPECT_EQ(dataset.getQuadStore().size(), 3u);
+    auto graph = dataset.getGraphRange("http://example.com/g");
+    EXPECT_EQ(graph.second - graph.first, 2u);
+    auto defaultGraph = dataset.getGraphRange("@default");
+    EXPECT_EQ(defaultGraph.second - defaultGraph.first, 1u);
+}
+
+TEST(NQuadsParserTest, parse_inChunks_mergesIntoExistingGraphs) {
+    std::string chunk1 =
+            "<http://example.com/a> <http://example.com/p> <http://example.com/o> <http://example.com/g> .\n"
+            "<http://example.com/b> <http://example.com/p> <http://example.com/o> .\n"
+            "<http://example.com/c> <http://example.com/p> <http://example.com/o> <http://example.com/h> .\n";
+    std::string chunk2 =
+            "<http://example.com/d> <http://example.com/p> <http://example.com/o> <http://example.com/h> .\n"
+            "<http://example.com/a> <http://example.com/p> <http://example.com/o> <http://example.com/g> .\n"
+            "<http://example.com/e> <http://example.com/p> <http://example.com/o> <http://example.com/i> .\n"
+            "<http://example.com/f> <http://example.com/p> <http://example.com/o> <http://example.com/g> .\n";
+    RDFDataset dataset(JsonLdOptions(), nullptr);
+    NQuadsParser parser(dataset);
+    parser.parse(chunk1);
+    parser.parse(chunk2);
+
+    // the duplicate of a quad of the first chunk is dropped, the others join their graphs
+    EXPECT_EQ(dataset.getQuadStore().size(), 6u);
+    EXPECT_EQ(dataset.getGraphRange("http://example.com/g"), std::make_pair(size_t(0), size_t(2)));
+    EXPECT_EQ(dataset.getGraphRange("@default"), std::make_pair(size_t(2), size_t(3)));
+    EXPECT_EQ(dataset.getGraphRange("http://example.com/h"), std::make_pair(size_t(3), size_t(5)));
+    EXPECT_EQ(dataset.getGraphRange("http://example.com/i"), std::make_pair(size_t(5), size_t(6)));
+    const RDF::TermDictionary & dictionary = *dataset.getTermDictionary();
+    EXPECT_EQ(dictionary.get(dataset.getQuadStore().getSubject(1).value), "http://example.com/f");
+    EXPECT_EQ(dictionary.get(dataset.getQuadStore().getSubject(4).value), "http://example.com/d");
+    for (const auto & name : dataset.graphNames()) {
+        auto range = dataset.getGraphRange(name);
+        for (size_t i = range.first; i < range.second; i++)
+            EXPECT_EQ(dataset.getQuadStore().getGraph(i), dataset.getQuadStore().getGraph(range.first)) << name;
+    }
+
+    // toNQuads() sorts, so this is the same as parsing it all at once
+    EXPECT_EQ(RDFDatasetUtils::toNQuads(dataset), RDFDatasetUtils::toNQuads(parse(chunk1 + chunk2)));
+}
+
+TEST(NQuadsParserTest, parse_invalid_leavesDatasetUnchanged) {
+    RDFDataset dataset(JsonLdOptions(), nullptr);
+    NQuadsParser parser(dataset);
+    parser.parse("<http://example.com/s> <http://example.com/p> <http://example.com/o> .\n");
+    EXPECT_THROW(parser.parse("<http://example.com/s> <http://example.com/p> <http://example.com/o2> .\n"
+                              "<http://example.com/s> <http://example.com/p>\n"), JsonLdError);
+    EXPECT_EQ(dataset.getQuadStore().size(), 1u);
+    EXPECT_EQ(dataset.getGraphRange("@default"), std::make_pair(size_t(0), size_t(1)));
+}
+
+TEST(NQuadsParserTest, parse_invalid_throwsSyntaxError) {
+    std::string valid = "<http://example.com/s> <http://example.com/p> <http://example.com/o> .\n";
+    EXPECT_EQ(errorOf(valid + "<http://example.com/s> <http://example.com/p> <http://example.com/o>\n"),
+              std::string(JsonLdError::SyntaxError) + "line 2: expected '.'");
+    EXPECT_EQ(errorOf("<http://example.com/s <http://example.com/p> \"o\" ."),
+              std::string(JsonLdError::SyntaxError) + "line 1: expected a predicate IRI");
+    EXPECT_EQ(errorOf("<http://example.com/s> <http://example.com/p> \"o ."),
+              std::string(JsonLdError::SyntaxError) + "line 1: unterminated literal");
+    EXPECT_EQ(errorOf("<http://example.com/s> <http://example.com/p> \"\\x\" ."),
+              std::string(JsonLdError::SyntaxError) + "line 1: invalid escape sequence");
+    EXPECT_EQ(errorOf("\"s\" <http://example.com/p> <http://example.com/o> ."),
+              std::string(JsonLdError::SyntaxError) + "line 1: expected an IRI or a blank node");
+}
+
+TEST(NQuadsParserTest, parseFile_sameAsParse) {
+    std::string path = resolvePath("test/testjsonld-cpp/test_data/normalize-0001-out.nq");
+    RDFDataset dataset(JsonLdOptions(), nullptr);
+    NQuadsParser parser(dataset);
+    parser.parseFile(path);
+    EXPECT_EQ(RDFDatasetUtils::toNQuads(dataset), getExpectedRDF("normalize", "0001"));
+
+    EXPECT_THROW(parser.parseFile(path + ".missing"), JsonLdError);
+}
+
+TEST(NQuadsParserTest, normalize_canonicalNQuads_isUnchanged) {
+    for (int i = 1; i <= 57; i++) {
+        std::string canonical = getExpectedRDF("normalize", getTestNumberStr(i));
+        RDFDataset dataset = parse(canonical);
+        JsonLdApi api;
+        EXPECT_EQ(api.normalize(dataset), canonical) << "normalize-" << getTestNumberStr(i);
+    }
+}
@@ -0,0 +1,113 @@
+#include "NQuadsWriter.h"
+#include "RDFDatasetUtils.h"
+#include "JsonLdApi.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+#pragma clang diagnostic push
+#pragma GCC diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#pragma GCC diagnostic ignored "-Wall"
+#pragma GCC diagnostic ignored "-Wextra"
+#include <rapidcheck/gtest.h>
+#pragma clang diagnostic pop
+#pragma GCC diagnostic pop
+
+using RDF::NQuadsWriter;
+
+namespace {
+
+    RDF::RDFDataset dataset() {
+        nlohmann::json expanded = nlohmann::json::parse(R"([{
+            "@id": "http://example.com/s",
+            "@type": [ "http://example.com/T" ],
+            "http://example.com/z": [ { "@value": "last" } ],
+            "http://example.com/p": [
+                { "@value": "v", "@language": "en" },
+                { "@value": "line\nbreak" },
+                { "@list": [ { "@value": 1 }, { "@id": "_:b" } ] }
+            ],
+            "http://example.com/a": [ { "@id": "_:b", "http://example.com/p": [ { "@value": true } ] } ]
+        }, {
+            "@id": "http://example.com/g",
+            "@graph": [ { "@id": "http://example.com/x", "http://example.com/p": [ { "@id": "http://example.com/y" } ] } ]
+        }])");
+        JsonLdApi api;
+        return api.toRDF(expanded);
+    }
+
+    std::vector<std::string> lines(const std::string & nquads) {
+        std::vector<std::string> result;
+        std::istringstream in(nquads);
+        std::string line;
+        while (std::getline(in, line))
+            result.push_back(line);
+        return result;
+    }
+
+}
+
+TEST(NQuadsWriterTest, sorted_linesAreSorted) {
+    RDF::RDFDataset ds = dataset();
+    std::string nquads = RDFDatasetUtils::toNQuads(ds);
+    std::vector<std::string> written = lines(nquads);
+    EXPECT_EQ(written.size(), ds.getQuadStore().size());
+    EXPECT_TRUE(std::is_sorted(written.begin(), written.end()));
+    EXPECT_NE(nquads.find("\"line\\nbreak\""), std::string::npos);
+}
+
+TEST(NQuadsWriterTest, unsorted_writesSameLines) {
+    RDF::RDFDataset ds = dataset();
+    std::string unsorted;
+    NQuadsWriter writer([&unsorted](const char * data, size_t size) { unsorted.append(data, size); },
+                        NQuadsWriter::Order::Unsorted);
+    writer.write(ds);
+
+    std::vector<std::string> written = lines(unsorted);
+    std::sort(written.begin(), written.end());
+    EXPECT_EQ(written, lines(RDFDatasetUtils::toNQuads(ds)));
+}
+
+TEST(NQuadsWriterTest, smallBuffer_writesInChunks) {
+    RDF::RDFDataset ds = dataset();
+    for (auto order : { NQuadsWriter::Order::Sorted, NQuadsWriter::Order::Unsorted }) {
+        std::string out;
+        size_t chunks = 0;
+        NQuadsWriter writer([&](const char * data, size_t size) {
+            out.append(data, size);
+            chunks++;
+        }, order, 64);
+        writer.write(ds);
+        EXPECT_GT(chunks, 1u);
+        EXPECT_EQ(lines(out).size(), ds.getQuadStore().size());
+    }
+}
+
+TEST(NQuadsWriterTest, ostream_sameAsToNQuads) {
+    RDF::RDFDataset ds = dataset();
+    std::ostringstream out;
+    NQuadsWriter writer(out);
+    writer.write(ds);
+    EXPECT_EQ(out.str(), RDFDatasetUtils::toNQuads(ds));
+}
+
+TEST(NQuadsWriterTest, fileDescriptor_sameAsToNQuads) {
+    RDF::RDFDataset ds = dataset();
+    FILE * file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    NQuadsWriter writer(NQuadsWriter::fileDescriptorSink(fileno(file)));
+    writer.write(ds);
+
+    std::rewind(file);
+    std::string out;
+    char buf[256];
+    size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), file)) > 0)
+        out.append(buf, n);
+    std::fclose(file);
+    EXPECT_EQ(out, RDFDatasetUtils::toNQuads(ds));
+}
@@ -371,3 +371,43 @@ TEST(NodeComparisonsTest, quads_withDifferentObjects_sortCorrectly) {
 
 }
 
+
+TEST(NodeComparisonsTest, terms_areCompactValues) {
+    EXPECT_LE(sizeof(Term), 16u);
+    EXPECT_TRUE(std::is_trivially_copyable<Term>::value);
+}
+
+TEST(NodeComparisonsTest, terms_fromSameDictionary_compareByIds) {
+    TermDictionary d;
+    std::string lang_en = "en";
+    Term t1 = Term::literal(d, "Same", nullptr, &lang_en);
+    Term t2 = Term::literal(d, "Same", nullptr, &lang_en);
+    Term t3 = Term::literal(d, "Same", nullptr, nullptr);
+    EXPECT_EQ(t1, t2);
+    EXPECT_NE(t1, t3);
+    EXPECT_NE(Term::iri(d, "Same"), Term::blankNode(d, "Same"));
+}
+
+TEST(NodeComparisonsTest, sortingTerms_literalsBeforeBlankNodesBeforeIris) {
+    TermDictionary d;
+    std::vector<Term> terms;
+    terms.push_back(Term::iri(d, "a"));
+    terms.push_back(Term::blankNode(d, "b"));
+    terms.push_back(Term::literal(d, "c", nullptr, nullptr));
+    terms.push_back(Term::iri(d, "0"));
+    std::sort(terms.begin(), terms.end(), TermLess(d));
+    EXPECT_TRUE(terms[0].isLiteral());
+    EXPECT_TRUE(terms[1].isBlankNode());
+    EXPECT_EQ(d.get(terms[2].value), "0");
+    EXPECT_EQ(d.get(terms[3].value), "a");
+}
+
+TEST(NodeComparisonsTest, nodes_wrapTerms) {
+    auto d = std::make_shared<TermDictionary>();
+    Term t = Term::blankNode(*d, "_:b0");
+    Node n(d, t);
+    EXPECT_TRUE(n.isBlankNode());
+    EXPECT_EQ(n.getValue(), "_:b0");
+    EXPECT_EQ(n, BlankNode(d, "_:b0"));
+    EXPECT_EQ(n, BlankNode("_:b0"));
+}
@@ -0,0 +1,69 @@
+#include "NodeMap.h"
+#include "JsonLdApi.h"
+#include "RDFDataset.h"
+
+#include <gtest/gtest.h>
+#pragma clang diagnostic push
+#pragma GCC diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#pragma GCC diagnostic ignored "-Wall"
+#pragma GCC diagnostic ignored "-Wextra"
+#include <rapidcheck/gtest.h>
+#pragma clang diagnostic pop
+#pragma GCC diagnostic pop
+
+using namespace RDF;
+
+TEST(NodeMapTest, keepsNodesInOrderAddedAndPropertiesByName) {
+    TermDictionary dictionary;
+    NodeMap nodeMap(dictionary);
+    NodeMap::Graph & graph = nodeMap.getGraph("@default");
+    EXPECT_EQ(&nodeMap.getGraph("@default"), &graph);
+
+    NodeMap::Node & b = nodeMap.getNode(graph, "http://example.com/b");
+    NodeMap::Node & a = nodeMap.getNode(graph, "http://example.com/a");
+    EXPECT_EQ(&nodeMap.getNode(graph, "http://example.com/b"), &b);
+    EXPECT_EQ(nodeMap.findNode(graph, "http://example.com/a"), &a);
+    EXPECT_EQ(nodeMap.findNode(graph, "http://example.com/c"), nullptr);
+    ASSERT_EQ(graph.nodes.size(), 2u);
+    EXPECT_EQ(dictionary.get(graph.nodes[0]->id), "http://example.com/b");
+    EXPECT_EQ(dictionary.get(graph.nodes[1]->id), "http://example.com/a");
+
+    arena_json & q = nodeMap.getValues(a, "http://example.com/q");
+    q.push_back("x");
+    nodeMap.getValues(a, "http://example.com/p");
+    nodeMap.getValues(a, "http://example.com/r");
+    EXPECT_EQ(&nodeMap.getValues(a, "http://example.com/q"), &q);
+    ASSERT_EQ(a.properties.size(), 3u);
+    EXPECT_EQ(dictionary.get(a.properties[0]->name), "http://example.com/p");
+    EXPECT_TRUE(a.properties[0]->values.empty());
+    EXPECT_EQ(dictionary.get(a.properties[1]->name), "http://example.com/q");
+    EXPECT_EQ(dictionary.get(a.properties[2]->name), "http://example.com/r");
+    EXPECT_TRUE(b.properties.empty());
+
+    // nodes of other graphs are kept apart, and graphs come out by name
+    NodeMap::Graph & named = nodeMap.getGraph("http://example.com/g");
+    EXPECT_EQ(nodeMap.findNode(named, "http://example.com/a"), nullptr);
+    nodeMap.getGraph("_:b0");
+    std::vector<std::string> names;
+    for (const NodeMap::Graph * g : nodeMap.getGraphs())
+        names.push_back(dictionary.get(g->name));
+    EXPECT_EQ(names, (std::vector<std::string>{"@default", "_:b0", "http://example.com/g"}));
+}
+
+TEST(NodeMapTest, toRDF_subjectsInDocumentOrder) {
+    JsonLdApi api;
+    RDFDataset dataset = api.toRDF(nlohmann::json::parse(R"([
+        { "@id": "http://example.com/z", "http://example.com/p": [ { "@id": "http://example.com/a" } ] },
+        { "@id": "http://example.com/a", "@type": [ "http://example.com/T" ], "@index": "i",
+          "http://example.com/p": [ { "@value": "v" } ] }
+    ])"));
+
+    std::vector<Quad> quads = dataset.getQuads("@default");
+    ASSERT_EQ(quads.size(), 3u);
+    EXPECT_EQ(quads[0].getSubject()->getValue(), "http://example.com/z");
+    EXPECT_EQ(quads[1].getSubject()->getValue(), "http://example.com/a");
+    EXPECT_EQ(quads[1].getPredicate()->getValue(), JsonLdConsts::RDF_TYPE);
+    EXPECT_EQ(quads[2].getPredicate()->getValue(), "http://example.com/p");
+    EXPECT_EQ(quads[2].getObject()->getValue(), "v");
+}
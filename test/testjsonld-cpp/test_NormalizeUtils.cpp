@@ -1,5 +1,9 @@
 #include "NormalizeUtils.cpp"
 #include "RDFDataset.h"
+#include "NQuadsParser.h"
+#include "JsonLdApi.h"
+
+#include <algorithm>
 
 #include <gtest/gtest.h>
 #pragma clang diagnostic push
@@ -44,3 +48,135 @@ TEST(NormalizeUtilsTest, getAdjacentBlankNodeName_isBlankNodeWithValueNotEqualTo
     // can't normally make this happen since we don't allow the id passed to getAdjacentBlankNodeName() to be null
     EXPECT_EQ(true, true);
 }
+
+namespace {
+
+    // two blank nodes, each with four blank nodes that look the same, linked in a ring
+    // across the two: every blank node shares its first degree hash with another, and
+    // the hubs have to try every permutation of their neighbours
+    std::string symmetricNQuads() {
+        std::string nquads;
+        for (int i = 0; i < 4; i++) {
+            std::string a = "_:a" + std::to_string(i);
+            std::string b = "_:b" + std::to_string(i);
+            nquads += "_:x <http://example.com/p> " + a + " .\n";
+            nquads += "_:y <http://example.com/p> " + b + " .\n";
+            nquads += a + " <http://example.com/q> " + b + " .\n";
+            nquads += b + " <http://example.com/q> _:a" + std::to_string((i + 1) % 4) + " .\n";
+        }
+        return nquads;
+    }
+
+    std::string normalize(const std::string & nquads, const JsonLdOptions & options) {
+        RDF::RDFDataset dataset(JsonLdOptions(), nullptr);
+        RDF::NQuadsParser(dataset).parse(nquads);
+        JsonLdApi api(options);
+        return api.normalize(dataset);
+    }
+
+    std::string normalizeOn(const std::string & nquads, const std::string & algorithm, unsigned int threads) {
+        JsonLdOptions options;
+        options.setAlgorithm(algorithm);
+        options.setNormalizationThreads(threads);
+        return normalize(nquads, options);
+    }
+
+    // every blank node linked to every other one, which has to try every permutation
+    std::string clique(int size) {
+        std::string nquads;
+        for (int i = 0; i < size; i++) {
+            for (int j = 0; j < size; j++) {
+                if (i != j)
+                    nquads += "_:n" + std::to_string(i) + " <http://example.com/p> _:n" + std::to_string(j) + " .\n";
+            }
+        }
+        return nquads;
+    }
+
+    // a list of identical items, whose paths recurse down the whole list
+    std::string list(int size) {
+        std::string nquads;
+        for (int i = 0; i < size; i++) {
+            std::string node = "_:l" + std::to_string(i);
+            std::string rest = i + 1 < size ? "_:l" + std::to_string(i + 1)
+                                            : "<http://www.w3.org/1999/02/22-rdf-syntax-ns#nil>";
+            nquads += node + " <http://www.w3.org/1999/02/22-rdf-syntax-ns#first> \"x\" .\n";
+            nquads += node + " <http://www.w3.org/1999/02/22-rdf-syntax-ns#rest> " + rest + " .\n";
+        }
+        return nquads;
+    }
+
+    // the message of the JsonLdError normalize() throws, or "" if it does not
+    std::string normalizeError(const std::string & nquads, const JsonLdOptions & options) {
+        try {
+            normalize(nquads, options);
+        } catch (JsonLdError & e) {
+            return e.what();
+        }
+        return "";
+    }
+
+}
+
+TEST(NormalizeUtilsTest, hashBlankNodes_inParallel_sameAsSequential) {
+    std::string nquads = symmetricNQuads();
+    for (const char * algorithm : {JsonLdOptions::URGNA2012, JsonLdOptions::URDNA2015}) {
+        std::string sequential = normalizeOn(nquads, algorithm, 1);
+        for (unsigned int threads : {2u, 3u, 8u})
+            EXPECT_EQ(normalizeOn(nquads, algorithm, threads), sequential) << algorithm << " on " << threads;
+    }
+}
+
+TEST(NormalizeUtilsTest, hashBlankNodes_overBudget_throws) {
+    for (const char * algorithm : {JsonLdOptions::URGNA2012, JsonLdOptions::URDNA2015}) {
+        JsonLdOptions options;
+        options.setAlgorithm(algorithm);
+        EXPECT_EQ(normalizeError(clique(5), options), "") << algorithm;
+        EXPECT_EQ(normalizeError(list(30), options), "") << algorithm;
+
+        JsonLdOptions permutations = options;
+        permutations.setMaxNormalizationPermutations(100);
+        EXPECT_EQ(normalizeError(clique(5), permutations), "normalization budget exceededmore than 100 permutations")
+                << algorithm;
+
+        JsonLdOptions depth = options;
+        depth.setMaxNormalizationDepth(10);
+        EXPECT_EQ(normalizeError(list(30), depth), "normalization budget exceededrecursion deeper than 10")
+                << algorithm;
+
+        JsonLdOptions hashes = options;
+        hashes.setMaxNormalizationHashes(100);
+        EXPECT_EQ(normalizeError(list(30), hashes), "normalization budget exceededmore than 100 hashes")
+                << algorithm;
+
+        // and on more than one thread
+        permutations.setNormalizationThreads(4);
+        EXPECT_EQ(normalizeError(clique(5), permutations), "normalization budget exceededmore than 100 permutations")
+                << algorithm;
+    }
+}
+
+TEST(NormalizeUtilsTest, hashBlankNodes_noBudget_finishes) {
+    for (const char * algorithm : {JsonLdOptions::URGNA2012, JsonLdOptions::URDNA2015}) {
+        JsonLdOptions options;
+        options.setAlgorithm(algorithm);
+        options.setMaxNormalizationPermutations(0);
+        options.setMaxNormalizationDepth(0);
+        options.setMaxNormalizationHashes(0);
+        EXPECT_EQ(normalize(clique(5), options), normalizeOn(clique(5), algorithm, 1)) << algorithm;
+    }
+}
+
+TEST(NormalizeUtilsTest, hashBlankNodes_defaultOptions_largeDatasetFinishes) {
+    // pairs of blank nodes, which all share a first degree hash with half of the others
+    std::string nquads;
+    const int pairs = 50005;
+    for (int i = 0; i < pairs; i++)
+        nquads += "_:a" + std::to_string(i) + " <http://example.com/p> _:b" + std::to_string(i) + " .\n";
+    for (const char * algorithm : {JsonLdOptions::URGNA2012, JsonLdOptions::URDNA2015}) {
+        JsonLdOptions options;
+        options.setAlgorithm(algorithm);
+        std::string normalized = normalize(nquads, options);
+        EXPECT_EQ(std::count(normalized.begin(), normalized.end(), '\n'), pairs) << algorithm;
+    }
+}
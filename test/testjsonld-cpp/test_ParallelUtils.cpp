@@ -0,0 +1,87 @@
+#include "ParallelUtils.h"
+#include "JsonLdError.h"
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#pragma clang diagnostic push
+#pragma GCC diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#pragma GCC diagnostic ignored "-Wall"
+#pragma GCC diagnostic ignored "-Wextra"
+#include <rapidcheck/gtest.h>
+#pragma clang diagnostic pop
+#pragma GCC diagnostic pop
+
+TEST(ParallelUtilsTest, threadCount) {
+    EXPECT_EQ(ParallelUtils::threadCount(3), 3u);
+    EXPECT_GE(ParallelUtils::threadCount(0), 1u);
+}
+
+TEST(ParallelUtilsTest, parallelFor_visitsEveryIndexOnce) {
+    for (unsigned int threads : {1u, 2u, 4u, 0u}) {
+        std::vector<std::atomic<int>> visits(1000);
+        for (auto & v : visits)
+            v = 0;
+        std::atomic<bool> badWorker(false);
+        ParallelUtils::parallelFor(visits.size(), threads, [&](size_t i, unsigned int worker) {
+            if (worker >= ParallelUtils::threadCount(threads))
+                badWorker = true;
+            visits[i]++;
+        });
+        EXPECT_FALSE(badWorker);
+        for (auto & v : visits)
+            EXPECT_EQ(v, 1);
+    }
+}
+
+TEST(ParallelUtilsTest, parallelFor_noIndices) {
+    bool called = false;
+    ParallelUtils::parallelFor(0, 4, [&](size_t, unsigned int) { called = true; });
+    EXPECT_FALSE(called);
+}
+
+TEST(ParallelUtilsTest, parallelFor_rethrows) {
+    EXPECT_THROW(ParallelUtils::parallelFor(100, 4, [](size_t i, unsigned int) {
+        if (i == 42)
+            throw JsonLdError(JsonLdError::UnknownError, "42");
+    }), JsonLdError);
+}
+
+TEST(ParallelUtilsTest, parallelFor_reusesThreads) {
+    std::mutex mutex;
+    std::set<std::thread::id> ids;
+    for (int call = 0; call < 50; call++) {
+        ParallelUtils::parallelFor(64, 4, [&](size_t, unsigned int) {
+            std::lock_guard<std::mutex> lock(mutex);
+            ids.insert(std::this_thread::get_id());
+        });
+    }
+    // the calling thread and the pool's, not new ones per call
+    EXPECT_LE(ids.size(), 8u);
+}
+
+TEST(ParallelUtilsTest, parallelFor_nested) {
+    std::vector<std::atomic<int>> visits(20 * 30);
+    for (auto & v : visits)
+        v = 0;
+    ParallelUtils::parallelFor(20, 4, [&](size_t i, unsigned int) {
+        std::vector<std::atomic<bool>> busy(4);
+        for (auto & b : busy)
+            b = false;
+        std::atomic<bool> sharedWorker(false);
+        ParallelUtils::parallelFor(30, 4, [&](size_t j, unsigned int worker) {
+            // the worker numbers of the inner call are its own
+            if (busy[worker].exchange(true))
+                sharedWorker = true;
+            visits[i * 30 + j]++;
+            busy[worker] = false;
+        });
+        EXPECT_FALSE(sharedWorker);
+    });
+    for (auto & v : visits)
+        EXPECT_EQ(v, 1);
+}
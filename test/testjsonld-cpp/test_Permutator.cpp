@@ -124,3 +124,24 @@ TEST(PermutatorTest, threeStrings) {
     EXPECT_EQ(t[2], "moe");
 }
 
+
+TEST(PermutatorTest, count) {
+    EXPECT_EQ(Permutator::count(0), 1u);
+    EXPECT_EQ(Permutator::count(1), 1u);
+    EXPECT_EQ(Permutator::count(4), 24u);
+    EXPECT_EQ(Permutator::count(1000), 0u);
+}
+
+TEST(PermutatorTest, permutation_sameAsNext) {
+    std::vector<std::string> strings = {"e", "c", "a", "d", "b"};
+
+    Permutator p(strings);
+
+    size_t rank = 0;
+    while(p.hasNext()) {
+        std::vector<std::string> next = p.next();
+        EXPECT_EQ(Permutator::permutation(strings, rank), next) << "rank " << rank;
+        rank++;
+    }
+    EXPECT_EQ(rank, Permutator::count(strings.size()));
+}
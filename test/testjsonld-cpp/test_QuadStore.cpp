@@ -0,0 +1,106 @@
+#include "QuadStore.h"
+#include "RDFDataset.h"
+
+#include <gtest/gtest.h>
+#pragma clang diagnostic push
+#pragma GCC diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#pragma GCC diagnostic ignored "-Wall"
+#pragma GCC diagnostic ignored "-Wextra"
+#include <rapidcheck/gtest.h>
+#pragma clang diagnostic pop
+#pragma GCC diagnostic pop
+
+using namespace RDF;
+
+TEST(QuadStoreTest, add_storesTermsInParallelColumns) {
+    TermDictionary d;
+    QuadStore store;
+    Term s = Term::iri(d, "http://example.com/s");
+    Term p = Term::iri(d, "http://example.com/p");
+    Term o1 = Term::literal(d, "one", nullptr, nullptr);
+    Term o2 = Term::blankNode(d, "_:b0");
+    Term g = Term::iri(d, "http://example.com/g");
+    store.add(s, p, o1, Term::defaultGraph());
+    store.add(s, p, o2, g);
+
+    ASSERT_EQ(store.size(), 2u);
+    EXPECT_EQ(store.getSubjects().size(), 2u);
+    EXPECT_EQ(store.getObject(0), o1);
+    EXPECT_EQ(store.getObject(1), o2);
+    EXPECT_TRUE(QuadStore::isDefaultGraph(store.getGraph(0)));
+    EXPECT_FALSE(QuadStore::isDefaultGraph(store.getGraph(1)));
+    // not even the IRI with the id of the empty string, which a default Term is
+    EXPECT_FALSE(QuadStore::isDefaultGraph(Term::iri(d, "")));
+    EXPECT_FALSE(QuadStore::isDefaultGraph(Term()));
+    EXPECT_EQ(d.get(store.getGraph(1).value), "http://example.com/g");
+}
+
+TEST(QuadStoreTest, select_reordersAndDropsInPlace) {
+    TermDictionary d;
+    QuadStore store;
+    Term s = Term::iri(d, "http://example.com/s");
+    Term p = Term::iri(d, "http://example.com/p");
+    std::vector<Term> objects;
+    for (int i = 0; i < 6; i++) {
+        objects.push_back(Term::literal(d, std::to_string(i), nullptr, nullptr));
+        store.add(s, p, objects.back(), Term::defaultGraph());
+    }
+    // the cycles 0 -> 2 -> 4 -> 0 and 1 -> 5 -> 1, dropping 3
+    store.select({ 4, 5, 0, 2, 1 });
+    ASSERT_EQ(store.size(), 5u);
+    EXPECT_EQ(store.getObject(0), objects[4]);
+    EXPECT_EQ(store.getObject(1), objects[5]);
+    EXPECT_EQ(store.getObject(2), objects[0]);
+    EXPECT_EQ(store.getObject(3), objects[2]);
+    EXPECT_EQ(store.getObject(4), objects[1]);
+    EXPECT_EQ(store.getSubject(4), s);
+
+    store.truncate(2);
+    EXPECT_EQ(store.size(), 2u);
+    EXPECT_EQ(store.getGraphs().size(), 2u);
+}
+
+TEST(QuadStoreTest, quad_hasFixedSlots) {
+    std::string graph = "http://example.com/g";
+    Quad q("http://example.com/s", "http://example.com/p", "_:b1", &graph);
+    EXPECT_EQ(q.getSubject()->getValue(), "http://example.com/s");
+    EXPECT_EQ(q.getPredicate()->getValue(), "http://example.com/p");
+    EXPECT_TRUE(q.getObject()->isBlankNode());
+    EXPECT_EQ(q.getGraph()->getValue(), graph);
+
+    Quad q2("http://example.com/s", "http://example.com/p", "_:b1", nullptr);
+    EXPECT_EQ(q2.getGraph(), nullptr);
+}
+
+TEST(QuadStoreTest, dataset_storesEachGraphContiguously) {
+    UniqueNamer namer;
+    RDFDataset dataset(JsonLdOptions(), &namer);
+
+    std::string g1 = "http://example.com/g1";
+    std::vector<Quad> quads1;
+    quads1.emplace_back("http://example.com/s", "http://example.com/p", "http://example.com/o1", &g1);
+    quads1.emplace_back("http://example.com/s", "http://example.com/p", "http://example.com/o2", &g1);
+    EXPECT_TRUE(dataset.insert(std::make_pair(g1, quads1)));
+
+    std::string g2 = "@default";
+    std::vector<Quad> quads2;
+    quads2.emplace_back("http://example.com/s", "http://example.com/p", "http://example.com/o3", nullptr);
+    EXPECT_TRUE(dataset.insert(std::make_pair(g2, quads2)));
+    EXPECT_FALSE(dataset.insert(std::make_pair(g2, quads2)));
+
+    EXPECT_EQ(dataset.getQuadStore().size(), 3u);
+    EXPECT_EQ(dataset.getGraphRange(g1), std::make_pair(size_t(0), size_t(2)));
+    EXPECT_EQ(dataset.getGraphRange(g2), std::make_pair(size_t(2), size_t(3)));
+    EXPECT_EQ(dataset.getGraphRange("http://example.com/none"), std::make_pair(size_t(0), size_t(0)));
+
+    // the quads were re-interned in the dataset's own dictionary
+    const TermDictionary & d = *dataset.getTermDictionary();
+    EXPECT_EQ(d.get(dataset.getQuadStore().getObject(2).value), "http://example.com/o3");
+
+    std::vector<Quad> copies = dataset.getQuads(g1);
+    ASSERT_EQ(copies.size(), 2u);
+    EXPECT_EQ(copies[0], quads1[0]);
+    EXPECT_EQ(copies[1], quads1[1]);
+    EXPECT_EQ(dataset.getQuads(g2)[0].getGraph(), nullptr);
+}
@@ -0,0 +1,67 @@
+#include "RDFDatasetUtils.h"
+
+#include <gtest/gtest.h>
+#pragma clang diagnostic push
+#pragma GCC diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#pragma GCC diagnostic ignored "-Wall"
+#pragma GCC diagnostic ignored "-Wextra"
+#include <rapidcheck/gtest.h>
+#pragma clang diagnostic pop
+#pragma GCC diagnostic pop
+
+namespace {
+
+    std::string escaped(const std::string & str) {
+        std::string out;
+        RDFDatasetUtils::escape(str, out);
+        std::string scalar;
+        RDFDatasetUtils::escapeScalar(str, scalar);
+        EXPECT_EQ(out, scalar);
+        return out;
+    }
+
+}
+
+TEST(RDFDatasetUtilsTest, escape_plainAscii_unchanged) {
+    EXPECT_EQ(escaped(""), "");
+    EXPECT_EQ(escaped("http://example.com/a?b=c#d"), "http://example.com/a?b=c#d");
+}
+
+TEST(RDFDatasetUtilsTest, escape_shortEscapes) {
+    EXPECT_EQ(escaped("a\"b\\c\nd\re\tf"), "a\\\"b\\\\c\\nd\\re\\tf");
+    EXPECT_EQ(escaped("a\bb\fc"), "a\\bb\\fc");
+}
+
+TEST(RDFDatasetUtilsTest, escape_controls_asUnicodeEscapes) {
+    EXPECT_EQ(escaped(std::string("\x00\x01\x07\x0B\x0E\x1F\x7F", 7)),
+              "\\u0000\\u0001\\u0007\\u000B\\u000E\\u001F\\u007F");
+    // U+0080, U+009F and U+00A0
+    EXPECT_EQ(escaped("\xC2\x80\xC2\x9F\xC2\xA0"), "\\u0080\\u009F\\u00A0");
+}
+
+TEST(RDFDatasetUtilsTest, escape_multibyteUtf8_unchanged) {
+    // U+00A9, U+00E4, U+20AC and U+1F600
+    std::string text = "\xC2\xA9 K\xC3\xB6nigin \xE2\x82\xAC \xF0\x9F\x98\x80";
+    EXPECT_EQ(escaped(text), text);
+    // an 0xC2 at the end of a truncated sequence is copied as is
+    EXPECT_EQ(escaped("a\xC2"), "a\xC2");
+}
+
+TEST(RDFDatasetUtilsTest, escapeCanonical_latin1Controls_unchanged) {
+    std::string out;
+    RDFDatasetUtils::escapeCanonical(std::string("a\tb\bc\fd\x00\x0B\x7F\xC2\x80\xC2\x85\xC2\xA0", 16), out);
+    EXPECT_EQ(out, "a\\tb\\bc\\fd\\u0000\\u000B\\u007F\xC2\x80\xC2\x85\xC2\xA0");
+}
+
+TEST(RDFDatasetUtilsTest, escape_longStrings_sameAsScalar) {
+    // specials at every position around the 16 and 32 byte chunk boundaries
+    const std::string specials[] = { "\"", "\\", "\n", std::string(1, '\0'), "\x7F", "\xC2\x85", "\xC3\xA4" };
+    for (const auto & special : specials) {
+        for (size_t position = 0; position < 70; position++) {
+            std::string str(100, 'x');
+            str.insert(position, special);
+            escaped(str);
+        }
+    }
+}
@@ -64,3 +64,34 @@ TEST(Sha1Test, vector_of_strings_manually_updated) {
 
     EXPECT_EQ(result, "df34ee3d80c42dbacbdc0a22686d41c5769eeaee");
 }
+
+TEST(Sha1Test, implementations_agree) {
+    std::string input;
+    for (size_t i = 0; i < 300; i++) {
+        SHA1 portable(SHA1::Implementation::Portable);
+        SHA1 fastest;
+        portable.update(input);
+        fastest.update(input);
+        EXPECT_EQ(fastest.digest(), portable.digest()) << input.size();
+        input += static_cast<char>('a' + i % 26);
+    }
+}
+
+TEST(Sha1Test, binaryDigest_sameAsHex) {
+    SHA1 md;
+    md.update("abc");
+    SHA1::Digest digest = md.binaryDigest();
+    EXPECT_EQ(MessageDigest::toHex(digest.data(), digest.size()), "a9993e364706816aba3e25717850c26c9cd0d89d");
+}
+
+TEST(Sha1Test, digestEach_sameAsOneAtATime) {
+    std::vector<std::string> messages;
+    for (size_t i = 0; i < 21; i++)
+        messages.push_back(std::string(i * 7, 'x'));
+    std::vector<std::string> digests(messages.size());
+    SHA1 md;
+    md.update("not part of any message");
+    md.digestEach(messages.data(), messages.size(), digests.data());
+    for (size_t i = 0; i < messages.size(); i++)
+        EXPECT_EQ(digests[i], sha1(messages[i]));
+}
@@ -0,0 +1,96 @@
+#include "sha256.h"
+
+#include <gtest/gtest.h>
+#pragma clang diagnostic push
+#pragma GCC diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#pragma GCC diagnostic ignored "-Wall"
+#pragma GCC diagnostic ignored "-Wextra"
+#include <rapidcheck/gtest.h>
+#pragma clang diagnostic pop
+#pragma GCC diagnostic pop
+
+// expected results generated using 'sha256sum' from GNU coreutils
+
+TEST(Sha256Test, empty) {
+    EXPECT_EQ(sha256(""), "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+}
+
+TEST(Sha256Test, fewChars) {
+    EXPECT_EQ(sha256("abc"), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+}
+
+TEST(Sha256Test, long_string) {
+    std::string plain = "The sky above the port was the color of television, tuned to a dead channel.";
+    EXPECT_EQ(sha256(plain), "5041821981ec48d8db280ff293c35de17ef5dbfbac25adc81ff272d0fc22b2ae");
+}
+
+TEST(Sha256Test, million_chars) {
+    EXPECT_EQ(sha256(std::string(1000000, 'a')), "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+TEST(Sha256Test, vector_of_strings) {
+    std::vector<std::string> v = {"red", "green", "blue"};
+    EXPECT_EQ(sha256(v), "348ec859e74cd0935faa6922caefa9d4606c6f31c86d2f586821b266dac31259");
+    // should be the same as when manually concatenating
+    EXPECT_EQ(sha256("redgreenblue"), "348ec859e74cd0935faa6922caefa9d4606c6f31c86d2f586821b266dac31259");
+}
+
+TEST(Sha256Test, digest_resetsForReuse) {
+    SHA256 md;
+    md.update("a");
+    md.digest();
+    std::string input(130, 'x');
+    for (size_t i = 0; i < input.size(); i += 7)
+        md.update(input.substr(i, 7));
+    EXPECT_EQ(md.digest(), sha256(input));
+}
+
+TEST(Sha256Test, implementations_agree) {
+    for (auto implementation : {SHA256::Implementation::ShaExtensions, SHA256::Implementation::Avx2MultiBuffer,
+                                SHA256::Implementation::Fastest}) {
+        std::string input;
+        for (size_t i = 0; i < 300; i++) {
+            SHA256 portable(SHA256::Implementation::Portable);
+            SHA256 other(implementation);
+            portable.update(input);
+            other.update(input);
+            EXPECT_EQ(other.digest(), portable.digest()) << input.size();
+            input += static_cast<char>('a' + i % 26);
+        }
+    }
+}
+
+TEST(Sha256Test, binaryDigest_sameAsHex) {
+    SHA256 md;
+    md.update("abc");
+    SHA256::Digest digest = md.binaryDigest();
+    EXPECT_EQ(MessageDigest::toHex(digest.data(), digest.size()),
+              "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+}
+
+TEST(Sha256Test, digestEach_sameAsOneAtATime) {
+    // lengths around the block and padding boundaries, in no particular order, and a
+    // count that does not fill the last group of eight
+    std::vector<std::string> messages;
+    for (size_t i = 0; i < 45; i++)
+        messages.push_back(std::string((i * 37) % 200, static_cast<char>('a' + i % 26)));
+    for (auto implementation : {SHA256::Implementation::Portable, SHA256::Implementation::ShaExtensions,
+                                SHA256::Implementation::Avx2MultiBuffer}) {
+        std::vector<std::string> digests(messages.size());
+        SHA256 md(implementation);
+        md.update("not part of any message");
+        md.digestEach(messages.data(), messages.size(), digests.data());
+        for (size_t i = 0; i < messages.size(); i++)
+            EXPECT_EQ(digests[i], sha256(messages[i])) << messages[i].size();
+        // and the digest is reset afterwards
+        md.update("abc");
+        EXPECT_EQ(md.digest(), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    }
+}
+
+TEST(Sha256Test, getInstance) {
+    EXPECT_EQ(MessageDigest::getInstance(MessageDigest::SHA_256)->digestSize(), 32u);
+    EXPECT_EQ(MessageDigest::getInstance(MessageDigest::SHA_1)->digestSize(), 20u);
+    EXPECT_EQ(MessageDigest::getInstance("MD5"), nullptr);
+}
@@ -0,0 +1,134 @@
+#include "TermDictionary.h"
+#include "RDFDataset.h"
+
+#include <gtest/gtest.h>
+#pragma clang diagnostic push
+#pragma GCC diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#pragma GCC diagnostic ignored "-Wall"
+#pragma GCC diagnostic ignored "-Wextra"
+#include <rapidcheck/gtest.h>
+#pragma clang diagnostic pop
+#pragma GCC diagnostic pop
+
+using namespace RDF;
+
+TEST(TermDictionaryTest, emptyString_isPreInterned) {
+    TermDictionary d;
+    EXPECT_EQ(d.size(), 1u);
+    EXPECT_EQ(d.find(""), TermDictionary::EMPTY);
+    EXPECT_EQ(d.get(TermDictionary::EMPTY), "");
+}
+
+TEST(TermDictionaryTest, intern_sameString_returnsSameId) {
+    TermDictionary d;
+    TermId id1 = d.intern("http://example.com/p");
+    TermId id2 = d.intern(std::string("http://example.com/") + "p");
+    EXPECT_EQ(id1, id2);
+    EXPECT_EQ(d.size(), 2u);
+}
+
+TEST(TermDictionaryTest, intern_differentStrings_returnsDenseIds) {
+    TermDictionary d;
+    TermId id1 = d.intern("a");
+    TermId id2 = d.intern("b");
+    TermId id3 = d.intern("c");
+    EXPECT_EQ(id1, 1u);
+    EXPECT_EQ(id2, 2u);
+    EXPECT_EQ(id3, 3u);
+    EXPECT_EQ(d.get(id2), "b");
+}
+
+TEST(TermDictionaryTest, intern_bytes_sameIdAsString) {
+    TermDictionary d;
+    const char buffer[] = "<http://example.com/p> .";
+    TermId id = d.intern(buffer + 1, 20);
+    EXPECT_EQ(d.get(id), "http://example.com/p");
+    EXPECT_EQ(d.intern("http://example.com/p"), id);
+    EXPECT_EQ(d.find(buffer + 1, 20), id);
+    EXPECT_EQ(d.find(buffer + 1, 19), TermDictionary::NOT_FOUND);
+}
+
+TEST(TermDictionaryTest, find_unknownString_returnsNotFound) {
+    TermDictionary d;
+    d.intern("a");
+    EXPECT_EQ(d.find("b"), TermDictionary::NOT_FOUND);
+}
+
+TEST(TermDictionaryTest, get_referencesStayValidAfterGrowth) {
+    TermDictionary d;
+    const std::string & first = d.get(d.intern("first"));
+    for (int i = 0; i < 10000; i++)
+        d.intern(std::to_string(i));
+    EXPECT_EQ(first, "first");
+}
+
+TEST(TermDictionaryTest, nodes_fromSameDictionary_shareIds) {
+    auto d = std::make_shared<TermDictionary>();
+    IRI i1(d, "http://example.com/type");
+    IRI i2(d, "http://example.com/type");
+    EXPECT_EQ(i1.getValueId(), i2.getValueId());
+    EXPECT_EQ(i1, i2);
+}
+
+TEST(TermDictionaryTest, nodes_fromDifferentDictionaries_compareByValue) {
+    auto d1 = std::make_shared<TermDictionary>();
+    auto d2 = std::make_shared<TermDictionary>();
+    d2->intern("padding");
+    std::string lang = "en";
+    Literal l1(d1, "hello", nullptr, &lang);
+    Literal l2(d2, "hello", nullptr, &lang);
+    Literal l3(d2, "world", nullptr, &lang);
+    EXPECT_EQ(l1, l2);
+    EXPECT_NE(l1, l3);
+    NodeLess less;
+    EXPECT_TRUE(less(l1, l3));
+    EXPECT_FALSE(less(l3, l1));
+}
+
+TEST(TermDictionaryTest, dataset_internsTermsInItsDictionary) {
+    UniqueNamer namer;
+    auto d = std::make_shared<TermDictionary>();
+    RDFDataset dataset(JsonLdOptions(), &namer, d);
+    EXPECT_EQ(dataset.getTermDictionary(), d);
+
+    std::string graphName = "@default";
+    NodeMap nodeMap(*d);
+    NodeMap::Graph & graph = nodeMap.getGraph(graphName);
+    NodeMap::Node & node = nodeMap.getNode(graph, "http://example.com/s");
+    nodeMap.getValues(node, "http://example.com/p") = arena_json::parse(
+            R"([ { "@id": "http://example.com/o1" }, { "@id": "http://example.com/o2" } ])");
+    dataset.graphToRDF(graph);
+
+    auto quads = dataset.getQuads(graphName);
+    ASSERT_EQ(quads.size(), 2u);
+    EXPECT_EQ(quads[0].getPredicate()->getDictionary(), d);
+    EXPECT_EQ(quads[0].getPredicate()->getValueId(), quads[1].getPredicate()->getValueId());
+    EXPECT_EQ(quads[0].getPredicate()->getValueId(), d->find("http://example.com/p"));
+}
+
+TEST(TermDictionaryTest, nodes_fromStrings_areDetached) {
+    std::string lang = "en";
+    Literal l1("hello", nullptr, &lang);
+    Literal l2("hello", nullptr, &lang);
+    IRI i("http://example.com/type");
+    EXPECT_EQ(l1.getDictionary(), nullptr);
+    EXPECT_EQ(l1.getValue(), "hello");
+    EXPECT_EQ(l1.getLanguage(), "en");
+    EXPECT_EQ(l1.getDatatype(), JsonLdConsts::XSD_STRING);
+    EXPECT_EQ(l1, l2);
+    EXPECT_NE(Node(l1), Node(i));
+
+    auto d = std::make_shared<TermDictionary>();
+    Literal attached(d, "hello", nullptr, &lang);
+    EXPECT_EQ(l1, attached);
+    NodeLess less;
+    EXPECT_FALSE(less(l1, attached));
+    EXPECT_FALSE(less(attached, l1));
+    EXPECT_TRUE(less(l1, i));
+
+    std::string graph = "http://example.com/g";
+    Quad quad("_:s", "http://example.com/p", "http://example.com/o", &graph);
+    EXPECT_EQ(quad.getSubject()->getDictionary(), nullptr);
+    EXPECT_EQ(quad.getGraph()->getValue(), graph);
+}
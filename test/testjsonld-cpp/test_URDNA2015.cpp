@@ -0,0 +1,182 @@
+#include "URDNA2015.h"
+#include "NQuadsParser.h"
+#include "JsonLdApi.h"
+#include "JsonLdProcessor.h"
+#include "testHelpers.h"
+
+#include <algorithm>
+#include <map>
+#include <regex>
+#include <sstream>
+
+#include <gtest/gtest.h>
+#pragma clang diagnostic push
+#pragma GCC diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#pragma GCC diagnostic ignored "-Wall"
+#pragma GCC diagnostic ignored "-Wextra"
+#include <rapidcheck/gtest.h>
+#pragma clang diagnostic pop
+#pragma GCC diagnostic pop
+
+using RDF::NQuadsParser;
+using RDF::RDFDataset;
+
+namespace {
+
+    std::string canonicalize(const std::string & nquads) {
+        RDFDataset dataset(JsonLdOptions(), nullptr);
+        NQuadsParser(dataset).parse(nquads);
+        return URDNA2015(dataset).canonicalize();
+    }
+
+    std::string normalizeURGNA2012(const std::string & nquads) {
+        RDFDataset dataset(JsonLdOptions(), nullptr);
+        NQuadsParser(dataset).parse(nquads);
+        JsonLdApi api{JsonLdOptions()};
+        return api.normalize(dataset);
+    }
+
+    // renames every blank node and reverses the order of the lines
+    std::string relabel(const std::string & nquads) {
+        std::regex label("_:[A-Za-z0-9]+");
+        std::map<std::string, std::string> names;
+        std::vector<std::string> lines;
+        std::istringstream in(nquads);
+        std::string line;
+        while (std::getline(in, line)) {
+            std::string renamed;
+            auto last = line.cbegin();
+            for (std::sregex_iterator it(line.begin(), line.end(), label), end; it != end; ++it) {
+                renamed.append(last, line.cbegin() + it->position());
+                auto inserted = names.insert(std::make_pair(it->str(), ""));
+                if (inserted.second)
+                    inserted.first->second = "_:x" + std::to_string(1000 - names.size());
+                renamed += inserted.first->second;
+                last = line.cbegin() + it->position() + it->length();
+            }
+            renamed.append(last, line.cend());
+            lines.push_back(renamed + "\n");
+        }
+        std::reverse(lines.begin(), lines.end());
+        std::string result;
+        for (const auto & l : lines)
+            result += l;
+        return result;
+    }
+
+}
+
+TEST(URDNA2015Test, canonicalize_withoutBlankNodes_sortsQuads) {
+    std::string nquads =
+            "<http://example.com/s> <http://example.com/p> \"b\" .\n"
+            "<http://example.com/s> <http://example.com/p> \"a\" <http://example.com/g> .\n";
+    EXPECT_EQ(canonicalize(nquads),
+              "<http://example.com/s> <http://example.com/p> \"a\" <http://example.com/g> .\n"
+              "<http://example.com/s> <http://example.com/p> \"b\" .\n");
+}
+
+TEST(URDNA2015Test, canonicalize_literals_canonicalEscapes) {
+    // the hashes that order the blank nodes are of the canonical escapes too
+    std::string nquads =
+            "_:b <http://example.com/p> \"no\\u00A0break\" .\n"
+            "_:c <http://example.com/p> \"next\\u0085line\" .\n"
+            "_:a <http://example.com/p> \"tab\\there\" .\n";
+    EXPECT_EQ(canonicalize(nquads),
+              "_:c14n0 <http://example.com/p> \"tab\\there\" .\n"
+              "_:c14n1 <http://example.com/p> \"next\xC2\x85" "line\" .\n"
+              "_:c14n2 <http://example.com/p> \"no\xC2\xA0" "break\" .\n");
+}
+
+// the examples of the RDF Dataset Canonicalization specification
+
+TEST(URDNA2015Test, canonicalize_uniqueFirstDegreeHashes) {
+    std::string nquads =
+            "<http://example.com/#p> <http://example.com/#q> _:e0 .\n"
+            "<http://example.com/#p> <http://example.com/#r> _:e1 .\n"
+            "_:e0 <http://example.com/#s> <http://example.com/#u> .\n"
+            "_:e1 <http://example.com/#t> <http://example.com/#u> .\n";
+    EXPECT_EQ(canonicalize(nquads),
+              "<http://example.com/#p> <http://example.com/#q> _:c14n0 .\n"
+              "<http://example.com/#p> <http://example.com/#r> _:c14n1 .\n"
+              "_:c14n0 <http://example.com/#s> <http://example.com/#u> .\n"
+              "_:c14n1 <http://example.com/#t> <http://example.com/#u> .\n");
+}
+
+TEST(URDNA2015Test, canonicalize_sharedFirstDegreeHashes) {
+    std::string nquads =
+            "<http://example.com/#p> <http://example.com/#q> _:e0 .\n"
+            "<http://example.com/#p> <http://example.com/#q> _:e1 .\n"
+            "_:e0 <http://example.com/#p> _:e2 .\n"
+            "_:e1 <http://example.com/#p> _:e3 .\n"
+            "_:e2 <http://example.com/#r> _:e3 .\n";
+    EXPECT_EQ(canonicalize(nquads),
+              "<http://example.com/#p> <http://example.com/#q> _:c14n2 .\n"
+              "<http://example.com/#p> <http://example.com/#q> _:c14n3 .\n"
+              "_:c14n0 <http://example.com/#r> _:c14n1 .\n"
+              "_:c14n2 <http://example.com/#p> _:c14n1 .\n"
+              "_:c14n3 <http://example.com/#p> _:c14n0 .\n");
+}
+
+TEST(URDNA2015Test, canonicalize_symmetricBlankNodes) {
+    EXPECT_EQ(canonicalize("_:a <http://example.com/p> _:b .\n_:b <http://example.com/p> _:a .\n"),
+              "_:c14n0 <http://example.com/p> _:c14n1 .\n_:c14n1 <http://example.com/p> _:c14n0 .\n");
+}
+
+TEST(URDNA2015Test, canonicalize_isIndependentOfLabelsAndOrder) {
+    for (int i = 1; i <= 57; i++) {
+        std::string nquads = getExpectedRDF("normalize", getTestNumberStr(i));
+        std::string canonical = canonicalize(nquads);
+        EXPECT_EQ(canonicalize(relabel(nquads)), canonical) << "normalize-" << getTestNumberStr(i);
+        // the canonical form is isomorphic to the input. URGNA2012 leaves labels that
+        // look like its own canonical ones alone, so relabel them first
+        EXPECT_EQ(normalizeURGNA2012(relabel(canonical)), nquads) << "normalize-" << getTestNumberStr(i);
+        EXPECT_EQ(canonicalize(canonical), canonical) << "normalize-" << getTestNumberStr(i);
+    }
+}
+
+TEST(URDNA2015Test, canonicalize_inParallel_sameAsSequential) {
+    for (int i = 1; i <= 57; i++) {
+        std::string nquads = getExpectedRDF("normalize", getTestNumberStr(i));
+        RDFDataset dataset(JsonLdOptions(), nullptr);
+        NQuadsParser(dataset).parse(nquads);
+        EXPECT_EQ(URDNA2015(dataset, 4).canonicalize(), canonicalize(nquads)) << "normalize-" << getTestNumberStr(i);
+    }
+}
+
+TEST(URDNA2015Test, normalize_selectedByOption) {
+    std::string nquads = getExpectedRDF("normalize", "0020");
+    RDFDataset dataset(JsonLdOptions(), nullptr);
+    NQuadsParser(dataset).parse(nquads);
+
+    JsonLdOptions options;
+    options.setAlgorithm(JsonLdOptions::URDNA2015);
+    JsonLdApi api(options);
+    EXPECT_EQ(api.normalize(dataset), canonicalize(nquads));
+
+    options.setAlgorithm("URGNA2013");
+    JsonLdApi unknown(options);
+    EXPECT_THROW(unknown.normalize(dataset), JsonLdError);
+}
+
+TEST(URDNA2015Test, normalize_hashAlgorithmSelectedByOption) {
+    std::string nquads = getExpectedRDF("normalize", "0020");
+    RDFDataset dataset(JsonLdOptions(), nullptr);
+    NQuadsParser(dataset).parse(nquads);
+
+    JsonLdOptions options;
+    options.setAlgorithm(JsonLdOptions::URDNA2015);
+    options.setHashAlgorithm(MessageDigest::SHA_256);
+    EXPECT_EQ(JsonLdApi(options).normalize(dataset), canonicalize(nquads));
+
+    options.setHashAlgorithm(MessageDigest::SHA_1);
+    EXPECT_EQ(JsonLdApi(options).normalize(dataset), URDNA2015(dataset, 1, MessageDigest::SHA_1).canonicalize());
+
+    // URGNA2012 hashes with SHA-1 unless told otherwise
+    options.setAlgorithm(JsonLdOptions::URGNA2012);
+    EXPECT_EQ(JsonLdApi(options).normalize(dataset), normalizeURGNA2012(nquads));
+
+    options.setHashAlgorithm("MD5");
+    EXPECT_THROW(JsonLdApi(options).normalize(dataset), JsonLdError);
+    EXPECT_THROW(URDNA2015(dataset, 1, "MD5"), JsonLdError);
+}